@@ -30,21 +30,19 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 *******************************************************************************/
 
 #include "CN91C4S96.h"
+#include "CN91C4S96glyphs.h"
 #include "main.h"
 #include "i2c.h"
-#include <math.h>
-#include <stdio.h>
 #include <string.h>
 
 /**
  * @brief CALCULATION DEFINES BLOCK
  */
-#define MAX_NUM 999999999
-#define MIN_NUM -999999999
-#define MIN_MINUS_NUM -99999999
+#define MAX_NUM CN91C4S96_LAYOUT_MAX_NUM
+#define MIN_NUM (-CN91C4S96_LAYOUT_MAX_NUM)
 
-#define PRECISION_MAX_POSITIVE 5 // TODO: find better names
-#define PRECISION_MAX_NEGATIVE 5
+#define PRECISION_MAX_POSITIVE CN91C4S96_LAYOUT_DOTS // TODO: find better names
+#define PRECISION_MAX_NEGATIVE CN91C4S96_LAYOUT_DOTS
 #define PRECISION_MIN 1
 
 #define BITS_PER_BYTE 8
@@ -59,16 +57,28 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #endif //SET_BIT
 
 #ifndef CLEAR_BIT
-#define CLEAR_BIT(REG, BIT) ((REG) |= (BIT))
+#define CLEAR_BIT(REG, BIT) ((REG) &= ~(BIT))
 #endif //CLEAR_BIT
 
+#ifndef MODIFY_REG
+#define MODIFY_REG(REG, CLEARMASK, SETMASK) ((REG) = (((REG) & (~(CLEARMASK))) | (SETMASK)))
+#endif //MODIFY_REG
+
 uint8_t BufferSend[DISPLAY_BUFFER_SIZE] = {0}; // Buffer where display data will be stored
 uint8_t *Buffer = BufferSend + 2;              // Buffer where display data will be stored
 
 uint8_t BufferSendOld[DISPLAY_BUFFER_SIZE] = {0}; // Buffer where display data will be stored
+static bool BufferOldValid = false;               // BufferSendOld holds what display RAM has
+
+// composes layers over the base page before flush, set by CN91C4S96layer.c. NULL - base page is sent as is
+const uint8_t *(*CN91C4S96_compose)(const uint8_t *base) = NULL;
+#define COMMIT_HOOKS 3 // one per module which watches sent frames: history, mirror, trace
+
+// get every frame after it was sent, see commitAttach. NULL - free slot
+static void (*commitHooks[COMMIT_HOOKS])(const uint8_t *frame) = {NULL};
 
 #define LCD_SWITCH(EN, POS, SEG) ((EN) ? (SET_BIT(Buffer[POS], SEG)) : (CLEAR_BIT(Buffer[POS], SEG)))
-void LCD_TOGGLE(bool EN, uint8_t POS1, uint8_t SEG1, uint8_t POS2, uint8_t SEG2)
+static inline void LCD_TOGGLE(bool EN, uint8_t POS1, uint8_t SEG1, uint8_t POS2, uint8_t SEG2)
 {
     if (EN)
     {
@@ -83,260 +93,248 @@ void LCD_TOGGLE(bool EN, uint8_t POS1, uint8_t SEG1, uint8_t POS2, uint8_t SEG2)
 }
 
 /**
- * @brief DISPLAY HARDWARE DEFINES BLOCK
+ * @brief GLASS LAYOUT BLOCK
+ * Positions come from the profile selected in CN91C4S96layout.h. Indexes are constants,
+ * so every ICON_POS/ICON_SEG is folded into an immediate like a plain define.
+ * The table is also used by other modules of the driver, see CN91C4S96anim.c
  */
-#define ULP 0x50    //0b 0101 0000  ULP Set ‘1’ to enable the Ultra-Low-Power mode, which can decrease total power consumption further more along with ‘SR’ and ‘FR’ Power
-#define SYSEN 0x48  //0b 0100 1000  EN 0: disable all blocks on-chip, all com/seg pin will be pulled to GND. 1: enable
-#define LCDOFF 0x79 //0b 0111 1001  Turn off all LCD segments
-#define LCDON 0x7A  //0b 0111 1010  Turn on all LCD segments
-
-#define PIXONOFFDATA 0x78 //0b 0111 1000  All pixels are ON/OFF depending on the data in
-#define NOBLINK 0x70      //0b 0111 0000  No blink
-#define EV0 0x60          //0b 0110 0000 EV=0 Adjust resistor divider for LCD contrast setting.
-#define NORMALMODE 0x20   //0b 0010 0000 80Hz Normal Mode, Line inverse, *0.5, Power Save Mode 1
-
-#define SLAVE_OWN_ADDRESS 0x7C
-#define MODE_CMD 0x01
-#define MODE_DATA 0x00
-#define ADR04_CMD 0x80
-#define ADR56_CMD 0xe8
-
-#define ADR0_SHIFT 0
-#define ADR1_SHIFT 7
-
-#define BAT1_SEG (1 << 4)
-#define BAT2_SEG (1 << 0)
-#define BAT3_SEG (1 << 1)
-#define BAT4_SEG (1 << 5)
-
-#define BAT14_POS 3
-#define BAT23_POS 2
-
-#define P1_SEG (1 << 7)
-#define P1_POS 10
-#define P2_SEG (1 << 7)
-#define P2_POS 9
-#define P3_SEG (1 << 7)
-#define P3_POS 8
-#define P4_SEG (1 << 7)
-#define P4_POS 7
-#define P5_SEG (1 << 7)
-#define P5_POS 6
+const CN91C4S96_Layout_st CN91C4S96Layout = CN91C4S96_LAYOUT_INIT;
+
+#define ICON_POS(NAME) (CN91C4S96Layout.icons[ICON_##NAME].pos)
+#define ICON_SEG(NAME) (CN91C4S96Layout.icons[ICON_##NAME].seg)
 
 #define NUM1FGE_SEG 0x70 //0b01110000
-#define NUM1FGE_POS 14
 #define NUM1ABCD_SEG (0xf << 0) //0b00001111
-#define NUM1ABCD_POS 13
-
-#define MINUS_SEG (1 << 7)
-#define MINUS_POS 13
+#define DIGIT_FGE_POS(I) (CN91C4S96Layout.digitFGE[I])
+#define DIGIT_ABCD_POS(I) (CN91C4S96Layout.digitABCD[I])
+
+#define DOT_POS(DP) (CN91C4S96Layout.dot[DP].pos)
+#define DOT_SEG(DP) (CN91C4S96Layout.dot[DP].seg)
+
+#define MINUS_SEG (CN91C4S96Layout.minus.seg)
+#define MINUS_POS (CN91C4S96Layout.minus.pos)
+
+#define SN_SEG ICON_SEG(SN)
+#define SN_POS ICON_POS(SN)
+#define WARN_SEG ICON_SEG(WARN)
+#define WARN_POS ICON_POS(WARN)
+#define MAGNET_SEG ICON_SEG(MAGNET)
+#define MAGNET_POS ICON_POS(MAGNET)
+#define LEFT_SEG ICON_SEG(LEFT)
+#define LEFT_POS ICON_POS(LEFT)
+#define RIGHT_SEG ICON_SEG(RIGHT)
+#define RIGHT_POS ICON_POS(RIGHT)
+#define NOWATER_SEG ICON_SEG(NOWATER)
+#define NOWATER_POS ICON_POS(NOWATER)
+#define CRC_SEG ICON_SEG(CRC)
+#define CRC_POS ICON_POS(CRC)
+#define DELTA_SEG ICON_SEG(DELTA)
+#define DELTA_POS ICON_POS(DELTA)
+#define T_SEG ICON_SEG(T)
+#define T_POS ICON_POS(T)
+#define T1_SEG ICON_SEG(T1)
+#define T1_POS ICON_POS(T1)
+#define T2_SEG ICON_SEG(T2)
+#define T2_POS ICON_POS(T2)
+#define NBFI_SEG ICON_SEG(NBFI)
+#define NBFI_POS ICON_POS(NBFI)
+#define NBIOT_SEG ICON_SEG(NBIOT)
+#define NBIOT_POS ICON_POS(NBIOT)
+#define SIG1_SEG ICON_SEG(SIG1)
+#define SIG1_POS ICON_POS(SIG1)
+#define SIG2_SEG ICON_SEG(SIG2)
+#define SIG2_POS ICON_POS(SIG2)
+#define SIG3_SEG ICON_SEG(SIG3)
+#define SIG3_POS ICON_POS(SIG3)
+#define BAT1_SEG ICON_SEG(BAT1)
+#define BAT1_POS ICON_POS(BAT1)
+#define BAT2_SEG ICON_SEG(BAT2)
+#define BAT2_POS ICON_POS(BAT2)
+#define BAT3_SEG ICON_SEG(BAT3)
+#define BAT3_POS ICON_POS(BAT3)
+#define BAT4_SEG ICON_SEG(BAT4)
+#define BAT4_POS ICON_POS(BAT4)
+#define SP_RU_SEG ICON_SEG(SP_RU)
+#define SP_RU_POS ICON_POS(SP_RU)
+#define SP_EN_SEG ICON_SEG(SP_EN)
+#define SP_EN_POS ICON_POS(SP_EN)
+#define RP_RU_SEG ICON_SEG(RP_RU)
+#define RP_RU_POS ICON_POS(RP_RU)
+#define RP_EN_SEG ICON_SEG(RP_EN)
+#define RP_EN_POS ICON_POS(RP_EN)
+#define DEGREE_SEG ICON_SEG(DEGREE)
+#define DEGREE_POS ICON_POS(DEGREE)
+#define GCAL_SEG ICON_SEG(GCAL)
+#define GCAL_POS ICON_POS(GCAL)
+#define GCAL_H_SEG ICON_SEG(GCAL_H)
+#define GCAL_H_POS ICON_POS(GCAL_H)
+#define GJ_SEG ICON_SEG(GJ)
+#define GJ_POS ICON_POS(GJ)
+#define GJ_H_SEG ICON_SEG(GJ_H)
+#define GJ_H_POS ICON_POS(GJ_H)
+#define KW_SEG ICON_SEG(KW)
+#define KW_POS ICON_POS(KW)
+#define MW_SEG ICON_SEG(MW)
+#define MW_POS ICON_POS(MW)
+#define W_SEG ICON_SEG(W)
+#define W_POS ICON_POS(W)
+#define WH_SEG ICON_SEG(WH)
+#define WH_POS ICON_POS(WH)
+#define GAL_SEG ICON_SEG(GAL)
+#define GAL_POS ICON_POS(GAL)
+#define GAL_PM_SEG ICON_SEG(GAL_PM)
+#define GAL_PM_POS ICON_POS(GAL_PM)
+#define M3_SEG ICON_SEG(M3)
+#define M3_POS ICON_POS(M3)
+#define M3_H_SEG ICON_SEG(M3_H)
+#define M3_H_POS ICON_POS(M3_H)
+#define M3_H_EN_SEG ICON_SEG(M3_H_EN)
+#define M3_H_EN_POS ICON_POS(M3_H_EN)
+#define FT3_SEG ICON_SEG(FT3)
+#define FT3_POS ICON_POS(FT3)
+#define FT3_PM_SEG ICON_SEG(FT3_PM)
+#define FT3_PM_POS ICON_POS(FT3_PM)
+#define MMBTU_SEG ICON_SEG(MMBTU)
+#define MMBTU_POS ICON_POS(MMBTU)
+#define GALLONS_SEG ICON_SEG(GALLONS)
+#define GALLONS_POS ICON_POS(GALLONS)
+#define US_SEG ICON_SEG(US)
+#define US_POS ICON_POS(US)
+#define MIN_RU_SEG ICON_SEG(MIN_RU)
+#define MIN_RU_POS ICON_POS(MIN_RU)
+#define MAX_RU_SEG ICON_SEG(MAX_RU)
+#define MAX_RU_POS ICON_POS(MAX_RU)
+#define MIN_EN_SEG ICON_SEG(MIN_EN)
+#define MIN_EN_POS ICON_POS(MIN_EN)
+#define MAX_EN_SEG ICON_SEG(MAX_EN)
+#define MAX_EN_POS ICON_POS(MAX_EN)
+#define BURST_RU_SEG ICON_SEG(BURST_RU)
+#define BURST_RU_POS ICON_POS(BURST_RU)
+#define BURST_EN_SEG ICON_SEG(BURST_EN)
+#define BURST_EN_POS ICON_POS(BURST_EN)
+#define LEAK_RU_SEG ICON_SEG(LEAK_RU)
+#define LEAK_RU_POS ICON_POS(LEAK_RU)
+#define LEAK_EN_SEG ICON_SEG(LEAK_EN)
+#define LEAK_EN_POS ICON_POS(LEAK_EN)
+#define REV_RU_SEG ICON_SEG(REV_RU)
+#define REV_RU_POS ICON_POS(REV_RU)
+#define REV_EN_SEG ICON_SEG(REV_EN)
+#define REV_EN_POS ICON_POS(REV_EN)
+#define FROST_SEG ICON_SEG(FROST)
+#define FROST_POS ICON_POS(FROST)
+#define Q_SEG ICON_SEG(Q)
+#define Q_POS ICON_POS(Q)
+#define VER_RU_SEG ICON_SEG(VER_RU)
+#define VER_RU_POS ICON_POS(VER_RU)
+#define VER_EN_SEG ICON_SEG(VER_EN)
+#define VER_EN_POS ICON_POS(VER_EN)
+#define POV_SEG ICON_SEG(POV)
+#define POV_POS ICON_POS(POV)
+
+
+// icon language selected by `mode` argument, constant when only one language is enabled
+#define ICON_LANG_RU(MODE) ((CN91C4S96_ICONS_RU && CN91C4S96_ICONS_EN) ? (MODE) : CN91C4S96_ICONS_RU)
+
+#if CN91C4S96_USE_TEXT
+// glyphs in the format of README.md: a 0x10, b 0x20, c 0x40, d 0x08, e 0x04, f 0x01, g 0x02
+static const uint8_t glyphAscii[] = {
+    CN91C4S96_GLYPHS_ASCII,
+#if CN91C4S96_USE_LETTERS
+    CN91C4S96_GLYPHS_ASCII_LETTERS,
+#endif //CN91C4S96_USE_LETTERS
+};
 
-#define MIN_RU_SEG (1 << 7)
-#define MIN_RU_POS 12
-#define MAX_RU_SEG (1 << 3)
-#define MAX_RU_POS 14
+#if CN91C4S96_USE_LETTERS
+typedef struct
+{
+    uint16_t cp;
+    uint8_t glyph;
+} Glyph_st;
 
-#define MIN_EN_SEG (1 << 7)
-#define MIN_EN_POS 11
-#define MAX_EN_SEG (1 << 7)
-#define MAX_EN_POS 14
+// code points above ASCII, see tools/glyphgen.py. Empty slots are {0, 0}
+static const Glyph_st glyphHash[1 << CN91C4S96_GLYPHS_HASH_BITS] = {CN91C4S96_GLYPHS_HASH};
 
-#define BURST_RU_SEG (1 << 3)
-#define BURST_RU_POS 15
-#define BURST_EN_SEG (1 << 6)
-#define BURST_EN_POS 15
-
-#define LEAK_RU_SEG (1 << 5)
-#define LEAK_RU_POS 15
-#define LEAK_EN_SEG (1 << 2)
-#define LEAK_EN_POS 15
-
-#define REV_RU_SEG (1 << 1)
-#define REV_RU_POS 15
-#define REV_EN_SEG (1 << 0)
-#define REV_EN_POS 15
-
-#define FROST_SEG (1 << 7)
-#define FROST_POS 15
-
-#define Q_SEG (1 << 2)
-#define Q_POS 14
-
-#define VER_RU_SEG (1 << 0)
-#define VER_RU_POS 14
-#define VER_EN_SEG (1 << 1)
-#define VER_EN_POS 14
-
-#define POV_SEG (1 << 4)
-#define POV_POS 15
-
-#define SN_SEG (1 << 6)
-#define SN_POS 0
-
-#define WARN_SEG (1 << 7)
-#define WARN_POS 0
-
-#define MAGNET_SEG (1 << 3)
-#define MAGNET_POS 0
+#endif //CN91C4S96_USE_LETTERS
 
-#define LEFT_SEG (1 << 7)
-#define LEFT_POS 1
-
-#define RIGHT_SEG (1 << 7)
-#define RIGHT_POS 2
-
-#define NOWATER_SEG (1 << 3)
-#define NOWATER_POS 1
-
-#define CRC_SEG (1 << 5)
-#define CRC_POS 0
-
-#define DELTA_SEG (1 << 4)
-#define DELTA_POS 0
-
-#define T_SEG (1 << 1)
-#define T_POS 0
-
-#define T1_SEG (1 << 2)
-#define T1_POS 0
-
-#define T2_SEG (1 << 6)
-#define T2_POS 1
-
-#define NBFI_SEG (1 << 3)
-#define NBFI_POS 2
-
-#define NBIOT_SEG (1 << 7)
-#define NBIOT_POS 3
-
-#define SIG1_SEG (1 << 6)
-#define SIG1_POS 2
-#define SIG2_SEG (1 << 2)
-#define SIG2_POS 2
-#define SIG3_SEG (1 << 6)
-#define SIG3_POS 3
-
-#define SP_RU_SEG (1 << 7)
-#define SP_RU_POS 4
-#define SP_EN_SEG (1 << 4)
-#define SP_EN_POS 3
-#define RP_RU_SEG (1 << 6)
-#define RP_RU_POS 4
-#define RP_EN_SEG (1 << 5)
-#define RP_EN_POS 3
-
-#define DEGREE_SEG (1 << 5)
-#define DEGREE_POS 1
-
-#define GCAL_SEG (1 << 1)
-#define GCAL_POS 3
-#define GCAL_H_SEG (1 << 5)
-#define GCAL_H_POS 4
-
-#define GJ_SEG (1 << 4)
-#define GJ_POS 1
-#define GJ_H_SEG (1 << 0)
-#define GJ_H_POS 3
-
-#define KW_SEG (1 << 4)
-#define KW_POS 5
-#define MW_SEG (1 << 5)
-#define MW_POS 5
-#define W_SEG (1 << 4)
-#define W_POS 4
-#define WH_SEG (1 << 0)
-#define WH_POS 4
-
-#define GAL_SEG (1 << 6)
-#define GAL_POS 5
-#define GAL_PM_SEG (1 << 1)
-#define GAL_PM_POS 4
-
-#define M3_SEG (1 << 7)
-#define M3_POS 5
-#define M3_H_SEG (1 << 2)
-#define M3_H_POS 4
-#define M3_H_EN_SEG (1 << 3)
-#define M3_H_EN_POS 4
-
-#define FT3_SEG (1 << 1)
-#define FT3_POS 1
-#define FT3_PM_SEG (1 << 0)
-#define FT3_PM_POS 1
-
-#define MMBTU_SEG (1 << 2)
-#define MMBTU_POS 1
-
-#define GALLONS_SEG (1 << 4)
-#define GALLONS_POS 2
-#define US_SEG (1 << 5)
-#define US_POS 2
-
-#define ALL_CLEAR_SEG 0xff
-#define ALL_CLEAR_POS 0
-
-#define DOT_SEG 0x80
-
-static const char ascii[] =
-    {
-        /*       0     1     2     3     4     5     6     7     8     9     a     b     c     d     e     f */
-        /*      ' '   ' '   ' '   ' '   ' '   ' '   ' '   ' '   ' '   ' '   ' '   ' '   ' '   '-'   ' '   ' ' */
-        /*2*/ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00,
-        /*      '0'   '1'   '2'   '3'   '4'   '5'   '6'   '7'   '8'   '9'   ' '   ' '   ' '   ' '   ' '   ' ' */
-        /*3*/ 0x7D, 0x60, 0x3e, 0x7a, 0x63, 0x5b, 0x5f, 0x70, 0x7f, 0x7b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-        /*      ' '   'A'   'B'   'C'   'D'   'E'   'F'   'G'   'H'   'I'   'J'   'K'   'L'   'M'   'N'   'O' */
-        /*4*/ 0x00, 0x77, 0x4f, 0x1d, 0x6e, 0x1f, 0x17, 0x5d, 0x47, 0x05, 0x68, 0x27, 0x0d, 0x54, 0x75, 0x4e,
-        /*      'P'   'Q'   'R'   'S'   'T'   'U'   'V'   'W'   'X'   'Y'   'Z'   ' '   ' '   ' '   ' '   '_' */
-        /*5*/ 0x37, 0x73, 0x06, 0x59, 0x0f, 0x6d, 0x23, 0x29, 0x67, 0x6b, 0x3c, 0x00, 0x00, 0x00, 0x00, 0x08,
-        /*      ' '   'A'   'B'   'C'   'D'   'E'   'F'   'G'   'H'   'I'   'J'   'K'   'L'   'M'   'N'   'O' */
-        /*6*/ 0x00, 0x77, 0x4f, 0x1d, 0x6e, 0x1f, 0x17, 0x5d, 0x47, 0x05, 0x68, 0x27, 0x0d, 0x54, 0x75, 0x4e,
-        /*      'P'   'Q'   'R'   'S'   'T'   'U'   'V'   'W'   'X'   'Y'   'Z'   ' '   ' '   ' '   ' '   ' ' */
-        /*7*/ 0x37, 0x73, 0x06, 0x59, 0x0f, 0x6d, 0x23, 0x29, 0x67, 0x6b, 0x3c, 0x00, 0x00, 0x00, 0x00, 0x00};
+#define UTF8_INVALID 0xFFFFFFFF // never found in the glyph tables
+#endif //CN91C4S96_USE_TEXT
 
 #define ASCII_SPACE_SYMBOL 0x00
 
-#define LITTLE_ENDIAN
+// frame bits which belong to the digit row and its dots
+static const uint8_t textMask[DATA_SIZE] = CN91C4S96_LAYOUT_TEXT_MASK;
 
-#if !defined(BIG_ENDIAN) && !defined(LITTLE_ENDIAN)
-#error "Unable to determine endian. Set it manually"
-#endif
+/**
+ * @brief DIGIT GLYPHS BLOCK
+ */
+#define GLYPH_BLANK 16
+#define GLYPH_MINUS 17
+#define GLYPH_HEX_BITS 4
+#define GLYPH_BIN_BITS 1
+#define GLYPH_BCD_MAX 9
+
+// digits 0..9, A b C d E F, blank and minus already split into the FGE and ABCD parts of two neighbour Buffer bytes
+static const uint8_t glyphFGE[] = {0x50, 0x00, 0x60, 0x20, 0x30, 0x30, 0x70, 0x00, 0x70, 0x30,
+                                   0x70, 0x70, 0x50, 0x60, 0x70, 0x70, 0x00, 0x20};
+static const uint8_t glyphABCD[] = {0x0f, 0x06, 0x0b, 0x0f, 0x06, 0x0d, 0x0d, 0x07, 0x0f, 0x0f,
+                                    0x07, 0x0c, 0x09, 0x0e, 0x09, 0x01, 0x00, 0x00};
+
+/**
+ * @brief CLOCK MODE BLOCK
+ */
+#if CN91C4S96_USE_CLOCK
+#define CLOCK_DIGITS 6
+#define CLOCK_NONE 0xff // nothing drawn by clock renderer, next call redraws whole digit row
+#define CLOCK_TIME 0
+#define CLOCK_DATE 1
+
+#define BCD_DIGIT_MAX 9
+#define BCD_SHIFT 4
 
-union tDataSeq
-{
-    struct //__attribute__((packed))
-    {
-#if defined LITTLE_ENDIAN
-        uint8_t padding : 7;
-        uint64_t data1 : 64;
-        uint64_t data0 : 64;
-        uint8_t addr : 6;
-        uint8_t type : 3;
-#elif defined BIG_ENDIAN
-        uint8_t type : 3;
-        uint8_t addr : 6;
-        uint16_t data0 : 16;
-        uint16_t data1 : 16;
-        uint16_t data2 : 16;
-        uint8_t padding : 7;
+#if DISPLAY_SIZE < 8 || PRECISION_MAX_POSITIVE < 4
+#error "clock needs 8 digits and 4 dots"
 #endif
-    };
-    uint8_t arr[18];
-};
+
+// digit row positions, right aligned: "HH-MM-SS" and "DD.MM.YY"
+#define CLOCK_LEFT (DISPLAY_SIZE - 8)
+static const uint8_t clockTimePos[CLOCK_DIGITS] = {CLOCK_LEFT + 0, CLOCK_LEFT + 1, CLOCK_LEFT + 3,
+                                                   CLOCK_LEFT + 4, CLOCK_LEFT + 6, CLOCK_LEFT + 7};
+static const uint8_t clockTimeSep[] = {CLOCK_LEFT + 2, CLOCK_LEFT + 5};
+static const uint8_t clockDatePos[CLOCK_DIGITS] = {CLOCK_LEFT + 2, CLOCK_LEFT + 3, CLOCK_LEFT + 4,
+                                                   CLOCK_LEFT + 5, CLOCK_LEFT + 6, CLOCK_LEFT + 7};
+// upper limits of time digits for ClockTick, hours are handled separately
+static const uint8_t clockTimeLimit[CLOCK_DIGITS] = {2, 9, 5, 9, 5, 9};
+
+static uint8_t clockMode = CLOCK_NONE;
+static uint8_t clockShown[CLOCK_DIGITS]; // digits which are in Buffer now
+
+// other content is drawn over the clock, next clock call redraws whole digit row
+#define CLOCK_RESET() (clockMode = CLOCK_NONE)
+#else
+#define CLOCK_RESET() ((void)0)
+#endif //CN91C4S96_USE_CLOCK
 
 CN91C4S96_HAL_st *CN91C4S96_hal = 0;
 
-// the most low-level function. Sends array of bytes into display
-void wrBytes(uint8_t *ptr, uint8_t size);
+CN91C4S96_Backend_st *CN91C4S96_backend = &CN91C4S96Backend;
+
 // write Buffer to the display
 void wrBuffer();
-// write command sequence to display
-void wrCmd(uint8_t cmd);
+// add hook which gets every frame after it was sent. Adding it again does nothing
+void commitAttach(void (*hook)(const uint8_t *frame));
+// remove hook, the others stay in place whatever order they were added in
+void commitDetach(void (*hook)(const uint8_t *frame));
 // set decimal separator. Used when print float numbers
 void decimalSeparator(uint8_t dpPosition);
-// set two dots for date
-void dateSeparator(uint8_t dpPosition, uint8_t dpPosition2);
-// check if number below minimum number with segment minus, show minus and abs num
-void showMinus(int32_t *num);
+// put number into digit row of frame, clear dots. Doesn't use any global state
+void numRender(uint8_t *frame, int32_t num, int32_t precision);
+// put number into digits and dots of one field. Doesn't use any global state
+void fieldRender(uint8_t *frame, const CN91C4S96Field_st *field, int32_t num, int32_t precision);
+// put `digits` low units of `bits` each of value into the right end of digit row, units above `unitMax` as minus,
+// dots between groups of `group` digits. Doesn't use any global state
+void codeRender(uint8_t *frame, uint32_t value, uint8_t digits, uint8_t bits, uint8_t unitMax, uint8_t group);
+// put decimal dot into frame, clear other dots. Doesn't use any global state
+void dotRender(uint8_t *frame, int32_t dpPosition);
 // takes the Buffer and puts it straight into the driver
 void update();
 // remove battery symbol from display Buffer
@@ -345,10 +343,22 @@ void batteryBufferClear();
 void dotsBufferClear();
 // remove all symbols from display Buffer except battery and dots
 void lettersBufferClear();
+// forget the digits drawn by the clock, another module has drawn over the digit row
+void clockReset(void);
 //Clear all segments
 void AllClear();
+#if CN91C4S96_USE_TEXT
 // coverts Buffer symbols to format, which can be displayed by LCD
 void BufferToAscii(const char *in, uint8_t *out);
+#endif
+#if CN91C4S96_USE_CLOCK
+// set two dots for date
+void dateSeparator(uint8_t dpPosition, uint8_t dpPosition2);
+// put one glyph (0..9, GLYPH_BLANK, GLYPH_MINUS) into digit row position, other bits of the bytes are kept
+void digitWrite(uint8_t pos, uint8_t digit);
+// redraw clock digits which differ from the shown ones
+void clockUpdate(const uint8_t *digits, uint8_t mode);
+#endif
 
 void CN91C4S96Init(CN91C4S96_HAL_st *hal_ptr)
 {
@@ -357,28 +367,157 @@ void CN91C4S96Init(CN91C4S96_HAL_st *hal_ptr)
     assert_param(hal_ptr->WaitI2C != NULL);
     CN91C4S96_hal = hal_ptr;
 
-    CN91C4S96_hal->InitI2C(); //
+    CN91C4S96InitBackend(&CN91C4S96Backend);
+}
+
+void CN91C4S96InitBackend(CN91C4S96_Backend_st *backend)
+{
+    assert_param(backend->Command != NULL);
+    assert_param(backend->Flush != NULL);
+    CN91C4S96_backend = backend;
+    BufferOldValid = false;
+
+    if (CN91C4S96_backend->Init)
+        CN91C4S96_backend->Init();
+    CN91C4S96_backend->Command(CTRL_INIT);
+}
+
+/**
+ * @brief RETAIN BLOCK DEFINES BLOCK
+ * tag | frame[DATA_SIZE] | shadow[DATA_SIZE] if RETAIN_SHADOW | clock mode, digits if RETAIN_CLOCK | CRC-8
+ */
+#define RETAIN_TAG 0xA0
+#define RETAIN_TAG_MASK 0xF0
+#define RETAIN_SYNC 0x01   // display RAM holds frame
+#define RETAIN_SHADOW 0x02 // display RAM holds the shadow which follows
+#define RETAIN_CLOCK 0x04  // clock renderer state follows
+#define RETAIN_CRC_POLY 0x07
+
+static uint8_t retainCrc(const uint8_t *data, size_t size)
+{
+    uint8_t crc = 0xff;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < BITS_PER_BYTE; bit++)
+        {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ RETAIN_CRC_POLY) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+size_t CN91C4S96Save(uint8_t *block, size_t size)
+{
+    const uint8_t *frame = BufferSend + SYS_SIZE;
+    const uint8_t *shadow = BufferSendOld + SYS_SIZE;
+    uint8_t tag = RETAIN_TAG;
+    size_t used = 1 + DATA_SIZE + 1;
+
+    if (BufferOldValid && memcmp(frame, shadow, DATA_SIZE) == 0)
+        tag |= RETAIN_SYNC;
+    else if (BufferOldValid)
+        tag |= RETAIN_SHADOW;
+    if (tag & RETAIN_SHADOW)
+        used += DATA_SIZE;
+#if CN91C4S96_USE_CLOCK
+    if (clockMode != CLOCK_NONE)
+    {
+        tag |= RETAIN_CLOCK;
+        used += 1 + CLOCK_DIGITS;
+    }
+#endif
+    if (size < used)
+        return 0;
+
+    uint8_t *p = block;
+    *p++ = tag;
+    memcpy(p, frame, DATA_SIZE);
+    p += DATA_SIZE;
+    if (tag & RETAIN_SHADOW)
+    {
+        memcpy(p, shadow, DATA_SIZE);
+        p += DATA_SIZE;
+    }
+#if CN91C4S96_USE_CLOCK
+    if (tag & RETAIN_CLOCK)
+    {
+        *p++ = clockMode;
+        memcpy(p, clockShown, CLOCK_DIGITS);
+        p += CLOCK_DIGITS;
+    }
+#endif
+    *p = retainCrc(block, used - 1);
+    return used;
+}
+
+bool CN91C4S96Resume(CN91C4S96_HAL_st *hal_ptr, const uint8_t *block, size_t size)
+{
+    assert_param(hal_ptr->InitI2C != NULL);
+    assert_param(hal_ptr->WriteI2C != NULL);
+    assert_param(hal_ptr->WaitI2C != NULL);
+    CN91C4S96_hal = hal_ptr;
+
+    return CN91C4S96ResumeBackend(&CN91C4S96Backend, block, size);
+}
+
+bool CN91C4S96ResumeBackend(CN91C4S96_Backend_st *backend, const uint8_t *block, size_t size)
+{
+    uint8_t tag = (size > 0) ? block[0] : 0;
+    size_t used = 1 + DATA_SIZE + 1;
+
+    if (tag & RETAIN_SHADOW)
+        used += DATA_SIZE;
+#if CN91C4S96_USE_CLOCK
+    if (tag & RETAIN_CLOCK)
+        used += 1 + CLOCK_DIGITS;
+#endif
+    // tag, size and CRC all must match, or the block is from other firmware or was never written
+    if ((tag & RETAIN_TAG_MASK) != RETAIN_TAG || size < used || retainCrc(block, used - 1) != block[used - 1])
+    {
+        CN91C4S96InitBackend(backend);
+        return false;
+    }
 
-    wrCmd(ULP | SYSEN);
-    //        wrCmd(PIXONOFFDATA);
-    //        wrCmd(NOBLINK);
-    //        wrCmd(EV0);
-    //        wrCmd(NORMALMODE);
+    assert_param(backend->Command != NULL);
+    assert_param(backend->Flush != NULL);
+    CN91C4S96_backend = backend;
+    // MCU bus peripheral was reset, the controller was not
+    if (CN91C4S96_backend->Init)
+        CN91C4S96_backend->Init();
+
+    const uint8_t *p = block + 1;
+    memcpy(BufferSend + SYS_SIZE, p, DATA_SIZE);
+    p += DATA_SIZE;
+    BufferOldValid = tag & (RETAIN_SYNC | RETAIN_SHADOW);
+    memcpy(BufferSendOld + SYS_SIZE, (tag & RETAIN_SHADOW) ? p : BufferSend + SYS_SIZE, DATA_SIZE);
+    if (tag & RETAIN_SHADOW)
+        p += DATA_SIZE;
+    CLOCK_RESET();
+#if CN91C4S96_USE_CLOCK
+    if (tag & RETAIN_CLOCK)
+    {
+        clockMode = *p++;
+        memcpy(clockShown, p, CLOCK_DIGITS);
+    }
+#endif
+    return true;
 }
 
 void CN91C4S96displayOn()
 {
-    wrCmd(LCDON);
+    CN91C4S96_backend->Command(CTRL_ALL_ON);
 }
 
 void CN91C4S96displayOff()
 {
-    wrCmd(LCDOFF);
+    CN91C4S96_backend->Command(CTRL_ALL_OFF);
 }
 
 void CN91C4S96displayData()
 {
-    wrCmd(PIXONOFFDATA);
+    CN91C4S96_backend->Command(CTRL_SHOW_DATA);
 }
 
 void *reverseBytes(void *inp, size_t len)
@@ -396,95 +535,109 @@ void *reverseBytes(void *inp, size_t len)
     return inp;
 }
 
-void wrBytes(uint8_t *ptr, uint8_t size)
+void wrBuffer()
 {
-    // TODO: check wrong size
-    assert_param(CN91C4S96_hal->WriteI2C != NULL);
-    CN91C4S96_hal->WriteI2C(SLAVE_OWN_ADDRESS, ptr, size);
+    const uint8_t *frame = BufferSend + SYS_SIZE; // base page, Buffer may point to a layer now
+
+    if (CN91C4S96_compose)
+        frame = CN91C4S96_compose(frame);
+    // display RAM content is unknown before the first write
+    CN91C4S96_backend->Flush(frame, BufferOldValid ? BufferSendOld + SYS_SIZE : NULL);
+    memcpy(BufferSendOld + SYS_SIZE, frame, DATA_SIZE);
+    BufferOldValid = true;
+    for (uint8_t i = 0; i < COMMIT_HOOKS; i++)
+    {
+        if (commitHooks[i])
+            commitHooks[i](frame);
+    }
 }
 
-void wrBuffer()
+void commitAttach(void (*hook)(const uint8_t *frame))
 {
-    BufferSend[0] = ADR56_CMD;
-    BufferSend[1] = MODE_DATA;
-    if (memcmp(BufferSendOld, BufferSend, DISPLAY_BUFFER_SIZE) != 0)
+    uint8_t slot = COMMIT_HOOKS;
+
+    for (uint8_t i = 0; i < COMMIT_HOOKS; i++)
     {
-        memcpy(BufferSendOld, BufferSend, sizeof(BufferSend));
-        wrBytes(BufferSend, sizeof(BufferSend));
+        if (commitHooks[i] == hook)
+            return;
+        if (!commitHooks[i] && slot == COMMIT_HOOKS)
+            slot = i;
     }
+    assert_param(slot < COMMIT_HOOKS);
+    if (slot < COMMIT_HOOKS)
+        commitHooks[slot] = hook;
 }
 
-void wrCmd(uint8_t cmd)
+void commitDetach(void (*hook)(const uint8_t *frame))
 {
-    assert_param(CN91C4S96_hal->WaitI2C != NULL);
-    union
+    for (uint8_t i = 0; i < COMMIT_HOOKS; i++)
     {
-        struct __attribute__((packed))
-        {
-#if defined LITTLE_ENDIAN
-            uint8_t data : 7;
-            uint8_t type : 1;
-#elif defined BIG_ENDIAN
-            uint8_t type : 1;
-            uint8_t data : 7;
-#endif
-        };
-        uint8_t arr[1];
-    } CommandSeq;
-    CommandSeq.type = MODE_CMD;
-    CommandSeq.data = cmd;
+        if (commitHooks[i] == hook)
+            commitHooks[i] = NULL;
+    }
+}
 
-    wrBytes(CommandSeq.arr, sizeof(CommandSeq));
-    CN91C4S96_hal->WaitI2C();
+void CN91C4S96DispRefresh(void)
+{
+    BufferOldValid = false;
+    wrBuffer();
 }
 
 void CN91C4S96batteryLevel(uint8_t percents)
 {
     batteryBufferClear();
-    SET_BIT(Buffer[BAT14_POS], BAT4_SEG);
+    SET_BIT(Buffer[BAT4_POS], BAT4_SEG);
     if (percents > 75)
     {
-        SET_BIT(Buffer[BAT14_POS], BAT1_SEG);
+        SET_BIT(Buffer[BAT1_POS], BAT1_SEG);
     }
     if (percents > 50)
     {
-        SET_BIT(Buffer[BAT23_POS], BAT2_SEG);
+        SET_BIT(Buffer[BAT2_POS], BAT2_SEG);
     }
     if (percents > 25)
     {
-        SET_BIT(Buffer[BAT23_POS], BAT3_SEG);
+        SET_BIT(Buffer[BAT3_POS], BAT3_SEG);
     }
 }
 
 void batteryBufferClear()
 {
-    CLEAR_BIT(Buffer[BAT14_POS], BAT1_SEG | BAT4_SEG);
-    CLEAR_BIT(Buffer[BAT23_POS], BAT2_SEG | BAT3_SEG);
+    CLEAR_BIT(Buffer[BAT1_POS], BAT1_SEG);
+    CLEAR_BIT(Buffer[BAT2_POS], BAT2_SEG);
+    CLEAR_BIT(Buffer[BAT3_POS], BAT3_SEG);
+    CLEAR_BIT(Buffer[BAT4_POS], BAT4_SEG);
 }
 
 void dotsBufferClear()
 {
-    for (size_t i = 0; i < PRECISION_MAX_POSITIVE; i++)
+    for (size_t i = PRECISION_MIN; i <= PRECISION_MAX_POSITIVE; i++)
     {
-        CLEAR_BIT(Buffer[P5_POS + i], P5_SEG);
+        CLEAR_BIT(Buffer[DOT_POS(i)], DOT_SEG(i));
     }
 }
 
+void clockReset(void)
+{
+    CLOCK_RESET();
+}
+
 void lettersBufferClear()
 {
+    CLOCK_RESET();
     for (size_t i = 0; i < DISPLAY_SIZE; i++)
     {
-        CLEAR_BIT(Buffer[NUM1FGE_POS - i], NUM1FGE_SEG);
-        CLEAR_BIT(Buffer[NUM1ABCD_POS - i], NUM1ABCD_SEG);
+        CLEAR_BIT(Buffer[DIGIT_FGE_POS(i)], NUM1FGE_SEG);
+        CLEAR_BIT(Buffer[DIGIT_ABCD_POS(i)], NUM1ABCD_SEG);
     }
 }
 
 void AllClear()
 {
-    CLEAR_BIT(Buffer[ALL_CLEAR_POS], ALL_CLEAR_SEG);
+    CLOCK_RESET();
     for (size_t i = 0; i < DATA_SIZE; i++)
     {
-        Buffer[i + SYS_SIZE] = 0;
+        Buffer[i] = 0;
     }
 }
 void clear()
@@ -492,26 +645,59 @@ void clear()
     AllClear();
 }
 
-void BufferToAscii(const char *in, uint8_t *out)
+#if CN91C4S96_USE_TEXT
+// decode one UTF-8 sequence and move `s` behind it. A broken sequence gives UTF8_INVALID
+static uint32_t utf8Next(const uint8_t **s)
 {
-    size_t len = MIN(DISPLAY_SIZE, strlen(in));
-    for (size_t i = 0; i < len; i++)
+    const uint8_t *p = *s;
+    uint32_t cp = *p++;
+    uint8_t extra = (cp >= 0xF0) ? 3 : (cp >= 0xE0) ? 2 : (cp >= 0xC0) ? 1 : 0;
+
+    if (cp >= 0x80)
     {
-        char c = in[i];
-        // Handle situation when char is out of displayable ascii table part.
-        // Show space instead
-        if ((c < ' ') || (c - ' ' >= (int)sizeof(ascii)))
+        // stray continuation byte, or sequence cut by the next character or the end of string
+        cp = (extra == 0) ? UTF8_INVALID : cp & (0x3F >> extra);
+        for (; extra > 0; extra--)
         {
-            CLEAR_BIT(out[NUM1FGE_POS - i], NUM1FGE_SEG);
-            CLEAR_BIT(out[NUM1ABCD_POS - i], NUM1ABCD_SEG);
-        }
-        else
-        {
-            SET_BIT(out[NUM1FGE_POS - i], NUM1FGE_SEG & (ascii[c - ' '] << 4));   // shift 4 for changing data format from library to our display
-            SET_BIT(out[NUM1ABCD_POS - i], NUM1ABCD_SEG & (ascii[c - ' '] >> 4)); // shift 4 for changing data format from library to our display
-            SET_BIT(out[NUM1ABCD_POS - i], NUM1ABCD_SEG & ascii[c - ' '] & 0x08); // mask for changing D segment from library to our display
+            if ((*p & 0xC0) != 0x80)
+            {
+                cp = UTF8_INVALID;
+                break;
+            }
+            cp = (cp << 6) | (*p++ & 0x3F);
         }
     }
+    *s = p;
+    return cp;
+}
+
+static uint8_t glyphLookup(uint32_t cp)
+{
+    if (cp - ' ' < sizeof(glyphAscii))
+        return glyphAscii[cp - ' '];
+#if CN91C4S96_USE_LETTERS
+    // lowercase cyrillic shows the uppercase glyph, without branches
+    cp -= (uint32_t)(cp - CN91C4S96_CYRILLIC_LOWER_FIRST < CN91C4S96_CYRILLIC_CASE_COUNT) *
+          CN91C4S96_CYRILLIC_CASE_COUNT;
+    cp -= (uint32_t)(cp == CN91C4S96_CYRILLIC_YO_LOWER) * CN91C4S96_CYRILLIC_YO_DELTA;
+    const Glyph_st *g = &glyphHash[CN91C4S96_GLYPH_HASH(cp)];
+    return (g->cp == cp) ? g->glyph : ASCII_SPACE_SYMBOL;
+#else
+    return ASCII_SPACE_SYMBOL;
+#endif
+}
+
+void BufferToAscii(const char *in, uint8_t *out)
+{
+    const uint8_t *s = (const uint8_t *)in;
+    CLOCK_RESET();
+    for (size_t i = 0; i < DISPLAY_SIZE && *s; i++)
+    {
+        uint8_t glyph = glyphLookup(utf8Next(&s));
+        // shift 4 for changing data format from library to our display, D segment is at the same bit
+        MODIFY_REG(out[DIGIT_FGE_POS(i)], NUM1FGE_SEG, NUM1FGE_SEG & (glyph << 4));
+        MODIFY_REG(out[DIGIT_ABCD_POS(i)], NUM1ABCD_SEG, NUM1ABCD_SEG & ((glyph >> 4) | (glyph & 0x08)));
+    }
 }
 
 void CN91C4S96printStr(const char *str)
@@ -520,71 +706,295 @@ void CN91C4S96printStr(const char *str)
     lettersBufferClear();
     BufferToAscii(str, Buffer);
 }
+#endif //CN91C4S96_USE_TEXT
+
+void CN91C4S96printText(const CN91C4S96Text_st *text)
+{
+    CLOCK_RESET();
+    for (size_t i = 0; i < DATA_SIZE; i++)
+    {
+        MODIFY_REG(Buffer[i], textMask[i], text->frame[i]);
+    }
+}
 
 void CN91C4S96printNum(int32_t num, int32_t precision)
 {
+    CLOCK_RESET();
+    numRender(Buffer, num, precision);
+}
+
+void numRender(uint8_t *frame, int32_t num, int32_t precision)
+{
+    uint8_t glyphs[DISPLAY_SIZE];
+    uint32_t value;
+    bool negative = num < 0;
+    bool minusSeg = false;
+
     if (num > MAX_NUM)
         num = MAX_NUM;
     if (num < MIN_NUM)
         num = MIN_NUM;
+    value = negative ? (uint32_t)(-num) : (uint32_t)num;
 
-    dotsBufferClear();
-    lettersBufferClear();
+    // at least precision + 1 digits to show leading zero before the dot
+    int8_t digitsMin = (int8_t)MIN(MAX(precision, 0), DISPLAY_SIZE - 1) + 1;
+    int8_t i = DISPLAY_SIZE;
+    memset(glyphs, GLYPH_BLANK, sizeof(glyphs));
+    do
+    {
+        glyphs[--i] = value % 10;
+        value /= 10;
+    } while (i > 0 && (value != 0 || DISPLAY_SIZE - i < digitsMin));
 
-    showMinus(&num);
+    // minus takes a digit in front of the number, or separate segment when the whole row is busy
+    if (negative)
+    {
+        if (i > 0)
+            glyphs[i - 1] = GLYPH_MINUS;
+        else
+            minusSeg = true;
+    }
 
-    char str[DISPLAY_SIZE + 1] = {0};
-    char strNum[DISPLAY_SIZE + 1] = {0};
-    int8_t numberSymbols = (int32_t)log10(num) + 1;
-    for (int8_t i = 0; i < DISPLAY_SIZE - numberSymbols; i++)
+    for (i = 0; i < DISPLAY_SIZE; i++)
     {
-        if (i < DISPLAY_SIZE - precision - 1)
+        MODIFY_REG(frame[DIGIT_FGE_POS(i)], NUM1FGE_SEG, glyphFGE[glyphs[i]]);
+        MODIFY_REG(frame[DIGIT_ABCD_POS(i)], NUM1ABCD_SEG, glyphABCD[glyphs[i]]);
+    }
+    MODIFY_REG(frame[MINUS_POS], MINUS_SEG, minusSeg ? MINUS_SEG : 0);
+    dotRender(frame, 0);
+}
+
+void CN91C4S96printField(const CN91C4S96Field_st *field, int32_t num, int32_t precision)
+{
+    CLOCK_RESET();
+    fieldRender(Buffer, field, num, precision);
+}
+
+void fieldRender(uint8_t *frame, const CN91C4S96Field_st *field, int32_t num, int32_t precision)
+{
+    uint8_t glyphs[DISPLAY_SIZE];
+    uint8_t width = field->width;
+    bool negative = field->sign && num < 0;
+    bool minusSeg = false;
+    bool minusSegOwn = field->first == 0; // separate minus segment is left of the first digit
+    bool minusDigit = negative && !minusSegOwn; // minus always takes a digit
+
+    if (width == 0 || field->first + width > DISPLAY_SIZE)
+        return;
+
+    uint32_t max = 1;
+    for (uint8_t i = 0; i < width; i++)
+    {
+        max *= 10;
+    }
+    max -= 1;
+    if (minusDigit)
+        max /= 10;
+
+    uint32_t value = negative ? 0u - (uint32_t)num : (num < 0 ? 0 : (uint32_t)num);
+    if (value > max)
+        value = max;
+
+    // at least precision + 1 digits to show leading zero before the dot
+    int8_t digitsMin = (int8_t)MIN(MAX(precision, 0), width - 1) + 1;
+    if (field->zeros || digitsMin > width - minusDigit)
+        digitsMin = width - minusDigit;
+    int8_t i = width;
+    memset(glyphs, GLYPH_BLANK, sizeof(glyphs));
+    do
+    {
+        glyphs[--i] = value % 10;
+        value /= 10;
+    } while (i > 0 && (value != 0 || width - i < digitsMin));
+
+    if (negative)
+    {
+        if (i > 0)
+            glyphs[i - 1] = GLYPH_MINUS;
+        else
+            minusSeg = true;
+    }
+
+    for (i = 0; i < width; i++)
+    {
+        uint8_t pos = field->first + i;
+        MODIFY_REG(frame[DIGIT_FGE_POS(pos)], NUM1FGE_SEG, glyphFGE[glyphs[i]]);
+        MODIFY_REG(frame[DIGIT_ABCD_POS(pos)], NUM1ABCD_SEG, glyphABCD[glyphs[i]]);
+    }
+    if (minusSegOwn)
+        MODIFY_REG(frame[MINUS_POS], MINUS_SEG, minusSeg ? MINUS_SEG : 0);
+
+    // dot n is right of digit DISPLAY_SIZE - 1 - n, the field owns the dots between its digits
+    uint8_t last = field->first + width - 1;
+    for (int32_t dp = DISPLAY_SIZE - last; dp <= DISPLAY_SIZE - 1 - field->first; dp++)
+    {
+        if (dp >= PRECISION_MIN && dp <= PRECISION_MAX_POSITIVE)
+            CLEAR_BIT(frame[DOT_POS(dp)], DOT_SEG(dp));
+    }
+    if (precision > 0 && precision < width)
+    {
+        // computed after the check, a large precision would overflow
+        int32_t dp = DISPLAY_SIZE - 1 - last + precision;
+        if (dp >= PRECISION_MIN && dp <= PRECISION_MAX_POSITIVE)
+            SET_BIT(frame[DOT_POS(dp)], DOT_SEG(dp));
+    }
+}
+
+void dotRender(uint8_t *frame, int32_t dpPosition)
+{
+    for (size_t i = PRECISION_MIN; i <= PRECISION_MAX_POSITIVE; i++)
+    {
+        CLEAR_BIT(frame[DOT_POS(i)], DOT_SEG(i));
+    }
+
+    if (dpPosition < PRECISION_MIN || dpPosition > PRECISION_MAX_POSITIVE)
+        // selected dot position not supported by display hardware
+        return;
+
+    SET_BIT(frame[DOT_POS(dpPosition)], DOT_SEG(dpPosition));
+}
+
+// powers of ten for the batch renderer, int32_t has 10 decimal digits
+#define POW10_COUNT 10
+static const uint32_t pow10Table[POW10_COUNT] = {1,      10,      100,      1000,      10000,
+                                                 100000, 1000000, 10000000, 100000000, 1000000000};
+
+void CN91C4S96RenderNumBatch(const int32_t *values, const uint8_t *precisions, const uint8_t *base,
+                             size_t baseStride, uint8_t *frames, size_t count)
+{
+    static const uint8_t zero[DATA_SIZE] = {0};
+
+    for (size_t n = 0; n < count; n++)
+    {
+        uint8_t *frame = frames + n * DATA_SIZE;
+        uint8_t precision = precisions ? precisions[n] : 0;
+        int32_t num = values[n];
+        bool negative = num < 0;
+        uint8_t glyphs[DISPLAY_SIZE];
+
+        if (num > MAX_NUM)
+            num = MAX_NUM;
+        if (num < MIN_NUM)
+            num = MIN_NUM;
+        uint32_t value = negative ? (uint32_t)(-num) : (uint32_t)num;
+
+        // fixed width: digits of the value, at least precision + 1, then the same digits as numRender gives.
+        // Subtraction on the power table instead of divisions, Cortex-M0 has no divide instruction
+        uint8_t shown = 1;
+        while (shown < POW10_COUNT && value >= pow10Table[shown])
+            shown++;
+        shown = MAX(shown, MIN(precision, DISPLAY_SIZE - 1) + 1);
+
+        memset(glyphs, GLYPH_BLANK, sizeof(glyphs));
+        for (uint8_t k = shown; k-- > 0;)
         {
-            str[i] = ' ';
+            uint8_t digit = 0;
+            if (k < POW10_COUNT)
+            {
+                while (value >= pow10Table[k])
+                {
+                    value -= pow10Table[k];
+                    digit++;
+                }
+            }
+            glyphs[DISPLAY_SIZE - 1 - k] = digit;
         }
-        else
+        // minus takes a digit in front of the number, or separate segment when the whole row is busy
+        bool minusSeg = negative && shown == DISPLAY_SIZE;
+        if (negative && !minusSeg)
+            glyphs[DISPLAY_SIZE - 1 - shown] = GLYPH_MINUS;
+
+        memcpy(frame, base ? base + n * baseStride : zero, DATA_SIZE);
+        for (uint8_t i = 0; i < DISPLAY_SIZE; i++)
         {
-            str[i] = '0';
+            MODIFY_REG(frame[DIGIT_FGE_POS(i)], NUM1FGE_SEG, glyphFGE[glyphs[i]]);
+            MODIFY_REG(frame[DIGIT_ABCD_POS(i)], NUM1ABCD_SEG, glyphABCD[glyphs[i]]);
         }
+        MODIFY_REG(frame[MINUS_POS], MINUS_SEG, minusSeg ? MINUS_SEG : 0);
+        dotRender(frame, precision);
     }
-#if __STDC_WANT_LIB_EXT1__ == 1
-    snprintf_s(str, sizeof(str), "%9li", num);
-#else
-    snprintf(strNum, sizeof(strNum), "%9li", num);
-#endif
-    for (int32_t i = DISPLAY_SIZE - numberSymbols; i < DISPLAY_SIZE; i++)
+}
+
+#if CN91C4S96_USE_FLOAT
+void CN91C4S96printFloat(float num, uint8_t precision)
+{
+    // NaN is neither >= 0 nor < 0, it gets the positive limit
+    uint8_t precisionMax = (num < 0) ? PRECISION_MAX_NEGATIVE : PRECISION_MAX_POSITIVE;
+    if (precision > precisionMax)
+        precision = precisionMax;
+
+    // exact powers of ten, same result as pow() without libm
+    double multiplier = 1;
+    for (uint8_t i = 0; i < precision; i++)
     {
-        str[i] = strNum[i];
+        multiplier *= 10;
     }
-    BufferToAscii(str, Buffer);
+    // clamp before conversion: out of int32_t range it is undefined. NaN is 0, as the Cortex-M runtime converts it
+    double scaled = num * multiplier;
+    if (scaled != scaled)
+        scaled = 0;
+    if (scaled > MAX_NUM)
+        scaled = MAX_NUM;
+    if (scaled < MIN_NUM)
+        scaled = MIN_NUM;
+    int32_t integerated = (int32_t)scaled;
+
+    CN91C4S96printNum(integerated, precision);
+    decimalSeparator(precision);
 }
+#endif //CN91C4S96_USE_FLOAT
 
-void CN91C4S96printFloat(float num, uint8_t precision)
+void codeRender(uint8_t *frame, uint32_t value, uint8_t digits, uint8_t bits, uint8_t unitMax, uint8_t group)
 {
-    if (num >= 0 && precision > PRECISION_MAX_POSITIVE)
-        precision = PRECISION_MAX_POSITIVE;
-    else if (num < 0 && precision > PRECISION_MAX_NEGATIVE)
-        precision = PRECISION_MAX_NEGATIVE;
+    uint8_t digitsMax = MIN(32 / bits, DISPLAY_SIZE);
+    uint32_t unitMask = (1UL << bits) - 1;
 
-    if (num < (float)MIN_NUM / 10)
+    // as many as value needs, at least one
+    if (digits == 0)
     {
-        num = num * (-1);
-        SET_BIT(Buffer[MINUS_POS], MINUS_SEG);
+        digits = 1;
+        while (digits < digitsMax && (value >> (digits * bits)) != 0)
+            digits++;
     }
-    else
+    digits = MIN(digits, digitsMax);
+
+    for (uint8_t i = 0; i < DISPLAY_SIZE; i++)
     {
-        CLEAR_BIT(Buffer[MINUS_POS], MINUS_SEG);
+        uint8_t glyph = GLYPH_BLANK;
+        if (i < digits)
+        {
+            // table index is the unit itself, no conversion to characters
+            uint8_t unit = (value >> (i * bits)) & unitMask;
+            glyph = (unit > unitMax) ? GLYPH_MINUS : unit;
+        }
+        MODIFY_REG(frame[DIGIT_FGE_POS(DISPLAY_SIZE - 1 - i)], NUM1FGE_SEG, glyphFGE[glyph]);
+        MODIFY_REG(frame[DIGIT_ABCD_POS(DISPLAY_SIZE - 1 - i)], NUM1ABCD_SEG, glyphABCD[glyph]);
     }
+    CLEAR_BIT(frame[MINUS_POS], MINUS_SEG);
 
-    int32_t integerated = (int32_t)(num * pow(10, precision));
+    dotRender(frame, 0);
+    for (uint8_t dp = group; group > 0 && dp < digits && dp <= PRECISION_MAX_POSITIVE; dp += group)
+    {
+        SET_BIT(frame[DOT_POS(dp)], DOT_SEG(dp));
+    }
+}
 
-    if (integerated > MAX_NUM)
-        integerated = MAX_NUM;
-    if (integerated < MIN_NUM)
-        integerated = MIN_NUM;
+void CN91C4S96printHex(uint32_t value, uint8_t digits, uint8_t group)
+{
+    CLOCK_RESET();
+    codeRender(Buffer, value, digits, GLYPH_HEX_BITS, UINT8_MAX, group);
+}
 
-    CN91C4S96printNum(integerated, precision);
-    decimalSeparator(precision);
+void CN91C4S96printBCD(uint32_t bcd, uint8_t digits, uint8_t group)
+{
+    CLOCK_RESET();
+    codeRender(Buffer, bcd, digits, GLYPH_HEX_BITS, GLYPH_BCD_MAX, group);
+}
+
+void CN91C4S96printBin(uint32_t value, uint8_t digits, uint8_t group)
+{
+    CLOCK_RESET();
+    codeRender(Buffer, value, digits, GLYPH_BIN_BITS, UINT8_MAX, group);
 }
 
 // TODO: make multiplier more strict.
@@ -614,31 +1024,133 @@ void CN91C4S96printFixed(int32_t multiplied_float, uint32_t multiplier)
     decimalSeparator(precision);
 }
 
+#if CN91C4S96_USE_CLOCK
 void CN91C4S96printDate(int32_t day, int32_t mon, int32_t year)
 {
-    char str[DISPLAY_SIZE + 1] = {"   "};
-    char strDate[DISPLAY_SIZE + 1] = {0};
-#if __STDC_WANT_LIB_EXT1__ == 1
-    snprintf_s(strDate, sizeof(strDate), "%02hhu%02hhu%02hhu", day, mon, year);
-    strcat_s(str, sizeof(str), strDate);
-#else
-    snprintf(strDate, sizeof(strDate), "%02hhu%02hhu%02hhu", day, mon, year);
-    strcat(str, strDate);
-#endif
+    int32_t fields[] = {day, mon, year};
+    uint8_t digits[CLOCK_DIGITS];
 
-    BufferToAscii(str, Buffer);
-    dateSeparator(2, 4);
+    for (size_t i = 0; i < CLOCK_DIGITS / 2; i++)
+    {
+        // negative field would index past the glyph tables, show it as 00
+        uint8_t v = (uint8_t)(MAX(fields[i], 0) % 100);
+        digits[2 * i] = v / 10;
+        digits[2 * i + 1] = v % 10;
+    }
+    clockUpdate(digits, CLOCK_DATE);
 }
 
-void decimalSeparator(uint8_t dpPosition)
+void CN91C4S96printDateBCD(uint8_t day, uint8_t mon, uint8_t year)
 {
-    dotsBufferClear();
+    uint8_t fields[] = {day, mon, year};
+    uint8_t digits[CLOCK_DIGITS];
 
-    if (dpPosition < PRECISION_MIN || dpPosition > PRECISION_MAX_POSITIVE)
-        // selected dot position not supported by display hardware
+    for (size_t i = 0; i < CLOCK_DIGITS / 2; i++)
+    {
+        digits[2 * i] = MIN(fields[i] >> BCD_SHIFT, BCD_DIGIT_MAX);
+        digits[2 * i + 1] = MIN(fields[i] & 0x0f, BCD_DIGIT_MAX);
+    }
+    clockUpdate(digits, CLOCK_DATE);
+}
+
+void CN91C4S96printTime(uint8_t hours, uint8_t minutes, uint8_t seconds)
+{
+    uint8_t fields[] = {hours, minutes, seconds};
+    uint8_t digits[CLOCK_DIGITS];
+
+    for (size_t i = 0; i < CLOCK_DIGITS / 2; i++)
+    {
+        uint8_t v = MIN(fields[i], 99);
+        digits[2 * i] = v / 10;
+        digits[2 * i + 1] = v % 10;
+    }
+    clockUpdate(digits, CLOCK_TIME);
+}
+
+void CN91C4S96printTimeBCD(uint8_t hours, uint8_t minutes, uint8_t seconds)
+{
+    uint8_t fields[] = {hours, minutes, seconds};
+    uint8_t digits[CLOCK_DIGITS];
+
+    for (size_t i = 0; i < CLOCK_DIGITS / 2; i++)
+    {
+        digits[2 * i] = MIN(fields[i] >> BCD_SHIFT, BCD_DIGIT_MAX);
+        digits[2 * i + 1] = MIN(fields[i] & 0x0f, BCD_DIGIT_MAX);
+    }
+    clockUpdate(digits, CLOCK_TIME);
+}
+
+void CN91C4S96ClockTick(void)
+{
+    if (clockMode != CLOCK_TIME)
         return;
 
-    SET_BIT(Buffer[P1_POS - PRECISION_MAX_POSITIVE + dpPosition], P1_SEG);
+    uint8_t digits[CLOCK_DIGITS];
+    memcpy(digits, clockShown, sizeof(digits));
+
+    // seconds and minutes carry, stop at the first digit which doesn't overflow
+    for (int8_t i = CLOCK_DIGITS - 1; i >= 2; i--)
+    {
+        if (++digits[i] <= clockTimeLimit[i])
+        {
+            clockUpdate(digits, CLOCK_TIME);
+            return;
+        }
+        digits[i] = 0;
+    }
+
+    if (digits[0] >= 2 && digits[1] >= 3)
+    {
+        digits[0] = 0;
+        digits[1] = 0;
+    }
+    else if (++digits[1] > BCD_DIGIT_MAX)
+    {
+        digits[1] = 0;
+        digits[0]++;
+    }
+    clockUpdate(digits, CLOCK_TIME);
+}
+
+void digitWrite(uint8_t pos, uint8_t digit)
+{
+    MODIFY_REG(Buffer[DIGIT_FGE_POS(pos)], NUM1FGE_SEG, glyphFGE[digit]);
+    MODIFY_REG(Buffer[DIGIT_ABCD_POS(pos)], NUM1ABCD_SEG, glyphABCD[digit]);
+}
+
+void clockUpdate(const uint8_t *digits, uint8_t mode)
+{
+    const uint8_t *pos = (mode == CLOCK_TIME) ? clockTimePos : clockDatePos;
+
+    if (clockMode != mode)
+    {
+        // first call after other content: draw the static part once
+        lettersBufferClear();
+        CLEAR_BIT(Buffer[MINUS_POS], MINUS_SEG);
+        if (mode == CLOCK_TIME)
+        {
+            dotsBufferClear();
+            for (size_t i = 0; i < sizeof(clockTimeSep); i++)
+            {
+                digitWrite(clockTimeSep[i], GLYPH_MINUS);
+            }
+        }
+        else
+        {
+            dateSeparator(2, 4);
+        }
+        memset(clockShown, CLOCK_NONE, sizeof(clockShown));
+        clockMode = mode;
+    }
+
+    for (size_t i = 0; i < CLOCK_DIGITS; i++)
+    {
+        if (digits[i] != clockShown[i])
+        {
+            digitWrite(pos[i], digits[i]);
+            clockShown[i] = digits[i];
+        }
+    }
 }
 
 void dateSeparator(uint8_t dpPosition, uint8_t dpPosition2)
@@ -652,25 +1164,19 @@ void dateSeparator(uint8_t dpPosition, uint8_t dpPosition2)
         // selected dot position not supported by display hardware
         return;
 
-    SET_BIT(Buffer[P1_POS - PRECISION_MAX_POSITIVE + dpPosition], P1_SEG);
-    SET_BIT(Buffer[P1_POS - PRECISION_MAX_POSITIVE + dpPosition2], P1_SEG);
+    SET_BIT(Buffer[DOT_POS(dpPosition)], DOT_SEG(dpPosition));
+    SET_BIT(Buffer[DOT_POS(dpPosition2)], DOT_SEG(dpPosition2));
 }
+#endif //CN91C4S96_USE_CLOCK
 
-void showMinus(int32_t *num)
+void decimalSeparator(uint8_t dpPosition)
 {
-    if (*num < MIN_MINUS_NUM)
-    {
-        SET_BIT(Buffer[MINUS_POS], MINUS_SEG);
-        *num *= -1;
-    }
-    else
-    {
-        CLEAR_BIT(Buffer[MINUS_POS], MINUS_SEG);
-    }
+    dotRender(Buffer, dpPosition);
 }
 
 void CN91C4S96DispMinMax(bool enable, bool mode, bool min)
 {
+    mode = ICON_LANG_RU(mode);
     if (enable)
     {
         if (mode)
@@ -693,6 +1199,7 @@ void CN91C4S96DispMinMax(bool enable, bool mode, bool min)
 
 void CN91C4S96DispBurst(bool enable, bool mode)
 {
+    mode = ICON_LANG_RU(mode);
     if (enable)
     {
         LCD_TOGGLE(mode, BURST_RU_POS, BURST_RU_SEG, BURST_EN_POS, BURST_EN_SEG);
@@ -706,6 +1213,7 @@ void CN91C4S96DispBurst(bool enable, bool mode)
 
 void CN91C4S96DispLeak(bool enable, bool mode)
 {
+    mode = ICON_LANG_RU(mode);
     if (enable)
     {
         LCD_TOGGLE(mode, LEAK_RU_POS, LEAK_RU_SEG, LEAK_EN_POS, LEAK_EN_SEG);
@@ -719,6 +1227,7 @@ void CN91C4S96DispLeak(bool enable, bool mode)
 
 void CN91C4S96DispRev(bool enable, bool mode)
 {
+    mode = ICON_LANG_RU(mode);
     if (enable)
     {
         LCD_TOGGLE(mode, REV_RU_POS, REV_RU_SEG, REV_EN_POS, REV_EN_SEG);
@@ -742,6 +1251,7 @@ void CN91C4S96DispQ(bool enable)
 
 void CN91C4S96DispVer(bool enable, bool mode)
 {
+    mode = ICON_LANG_RU(mode);
     if (enable)
     {
         LCD_TOGGLE(mode, VER_RU_POS, VER_RU_SEG, VER_EN_POS, VER_EN_SEG);
@@ -792,6 +1302,7 @@ void CN91C4S96DispNoWater(bool enable)
 
 void CN91C4S96DispSP(bool enable, bool mode)
 {
+    mode = ICON_LANG_RU(mode);
     if (enable)
     {
         if (mode)
@@ -812,6 +1323,7 @@ void CN91C4S96DispSP(bool enable, bool mode)
 
 void CN91C4S96DispRP(bool enable, bool mode)
 {
+    mode = ICON_LANG_RU(mode);
     if (enable)
     {
         if (mode)
@@ -932,6 +1444,7 @@ void CN91C4S96DispEnergyW(bool enable, bool M, bool perH)
 
 void CN91C4S96DispFlowM3(bool enable, bool mode, bool perH)
 {
+    mode = ICON_LANG_RU(mode);
     if (enable)
     {
         SET_BIT(Buffer[M3_POS], M3_SEG);
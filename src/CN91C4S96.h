@@ -34,6 +34,15 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include "CN91C4S96ctrl.h"
+#include "CN91C4S96layout.h"
+#include "CN91C4S96config.h"
+
+#define DISPLAY_SIZE CN91C4S96_LAYOUT_DIGITS       // digits of the glass, see CN91C4S96layout.h
+#define SYS_SIZE 2                                 // 2 byte for address and commands
+#define DATA_SIZE 16                               // 16 * 8  = 128 symbols on display
+#define DISPLAY_BUFFER_SIZE (DATA_SIZE + SYS_SIZE) //  plus 2 byte for address
 
 typedef struct
 {
@@ -51,6 +60,43 @@ typedef struct
      */
 void CN91C4S96Init(CN91C4S96_HAL_st *hal_ptr);
 
+/**
+     * @brief Starts the lcd with another controller backend, see CN91C4S96ctrl.h and HT1621ctrl.h.
+     * All print and icon functions work the same way with every backend
+     *
+     * @param backend
+     */
+void CN91C4S96InitBackend(CN91C4S96_Backend_st *backend);
+
+// largest block of CN91C4S96Save: tag, frame, shadow, clock mode and digits, CRC. Usual one is DATA_SIZE + 2 bytes
+#define CN91C4S96_RETAIN_SIZE (1 + 2 * DATA_SIZE + 1 + 6 + 1)
+
+/**
+     * @brief Save frame, shadow of display RAM and clock renderer state before MCU standby,
+     * into backup registers or retained RAM. The controller keeps its RAM and mode
+     *
+     * @param block - memory for the state
+     * @param size - bytes in block, CN91C4S96_RETAIN_SIZE is always enough
+     * @return bytes used, 0 if block is too small
+     */
+size_t CN91C4S96Save(uint8_t *block, size_t size);
+
+/**
+     * @brief Starts the driver after MCU standby instead of CN91C4S96Init. Only the bus is initialised,
+     * nothing is sent: the controller is not started again and the next CN91C4S96DispWrite sends only changes
+     *
+     * @param hal_ptr
+     * @param block - state from CN91C4S96Save
+     * @param size - bytes in block
+     * @return false if block is not valid (power loss, other firmware). Then the driver is started as by CN91C4S96Init
+     */
+bool CN91C4S96Resume(CN91C4S96_HAL_st *hal_ptr, const uint8_t *block, size_t size);
+
+/**
+     * @brief CN91C4S96Resume with another controller backend, see CN91C4S96InitBackend
+     */
+bool CN91C4S96ResumeBackend(CN91C4S96_Backend_st *backend, const uint8_t *block, size_t size);
+
 /**
      * @brief Turns on the display (doesn't affect the backlight)
      */
@@ -73,24 +119,78 @@ void CN91C4S96displayData();
      */
 void CN91C4S96batteryLevel(uint8_t percents);
 
+#if CN91C4S96_USE_TEXT
 /**
-     * @brief Print string (up to 6 characters)
+     * @brief Print string, one character per digit
      *
-     * @param str String to be displayed.
-     * Allowed: letters, digits, space, minus, underscore
+     * @param str UTF-8 string to be displayed.
+     * Allowed: characters of extras/glyphs.map - letters, cyrillic, digits, space, minus, underscore, degree
      * Not allowed symbols will be displayed as spaces. See symbols appearance in README.md
      */
 void CN91C4S96printStr(const char *str);
+#endif
+
+// message encoded before run time: digit and dot bits of the frame, see tools/textgen.py and CN91C4S96text.hpp
+typedef struct
+{
+    uint8_t frame[DATA_SIZE];
+} CN91C4S96Text_st;
+
+/**
+     * @brief Print constant message, the same digits as CN91C4S96printStr with its text.
+     * Glyphs are looked up when the message is made, here it is one masked copy into the frame.
+     * Works also with CN91C4S96_USE_TEXT off
+     *
+     * @param text - message from tools/textgen.py or CN91C4S96text.hpp, usually in flash
+     */
+void CN91C4S96printText(const CN91C4S96Text_st *text);
 
 /**
-     * @brief Prints a signed integer between -99999 and 999999.
-     * Larger and smaller values will be displayed as -99999 and 999999
+     * @brief Prints a signed integer between -999999999 and 999999999.
+     * Larger and smaller values will be displayed as -999999999 and 999999999.
+     * Minus takes a digit in front of the number, or the separate minus segment when all 9 digits are used
      *
      * @param num - number to be printed
      * @param precision - point or number of symbols to show numbers like "0.0000"
      */
 void CN91C4S96printNum(int32_t num, int32_t precision);
 
+typedef struct
+{
+    uint8_t first; // leftmost digit of the field, 0 - left edge of the digit row
+    uint8_t width; // digits
+    bool zeros;    // leading zeros instead of blanks
+    bool sign;     // negative numbers with minus, else they are shown as 0
+} CN91C4S96Field_st;
+
+/**
+     * @brief Prints number into a part of the digit row. Only digits and dots of the field are changed,
+     * so several fields (e.g. T1 and T2, or channel and value) are updated independently.
+     * Numbers which don't fit are clamped. Minus takes a digit, the separate minus segment
+     * is used only by a field which starts at the left edge
+     *
+     * @param field - digit range and format, usually a constant
+     * @param num - number to be printed, multiplied by 10^precision
+     * @param precision - digits after the dot. The dot is shown if the glass has it at this place
+     */
+void CN91C4S96printField(const CN91C4S96Field_st *field, int32_t num, int32_t precision);
+
+/**
+     * @brief Renders `count` numbers into separate frames without touching the display Buffer.
+     * Gives the same digits, minus and dot as CN91C4S96printFixed. Has no global state,
+     * so different parts of one batch may be rendered by different threads
+     *
+     * @param values - numbers, already multiplied as for CN91C4S96printFixed
+     * @param precisions - digits after the dot for every number, NULL for all integers
+     * @param base - frames with icons to render numbers over, NULL for empty ones
+     * @param baseStride - distance between base frames in bytes. 0 to use one base frame for all numbers
+     * @param frames - output, count * DATA_SIZE bytes, one frame after another
+     * @param count - number of frames
+     */
+void CN91C4S96RenderNumBatch(const int32_t *values, const uint8_t *precisions, const uint8_t *base,
+                             size_t baseStride, uint8_t *frames, size_t count);
+
+#if CN91C4S96_USE_FLOAT
 /**
      * @brief Prints a float with 0 to 3 decimals, based on the `precision` parameter. Default value is 3
      * This method may be slow on many systems. Try to avoid float usage.
@@ -100,6 +200,7 @@ void CN91C4S96printNum(int32_t num, int32_t precision);
      * @param precision - precision of the number
      */
 void CN91C4S96printFloat(float num, uint8_t precision);
+#endif
 
 /**
      * @brief Prints number with dot. Use it instead float. Float type usage may slow down many systems
@@ -107,10 +208,63 @@ void CN91C4S96printFloat(float num, uint8_t precision);
 void CN91C4S96printFixed(int32_t multiplied_float, uint32_t multiplier);
 
 /**
-     * @brief Prints number of date with dots in DD-MM-YYYY format.
+     * @brief Prints number in hexadecimal with leading zeros: 0-9, A, b, C, d, E, F.
+     * No libc, every nibble is an index into the digit glyph table
+     *
+     * @param value - number to be printed, e.g. CRC shown with CN91C4S96DispCRC
+     * @param digits - low nibbles shown, up to 8. 0 for as many as the value needs
+     * @param group - dot between every `group` digits from the right: 4 for "1234.AbCd". 0 for no dots
+     */
+void CN91C4S96printHex(uint32_t value, uint8_t digits, uint8_t group);
+
+/**
+     * @brief Prints packed BCD with leading zeros, like CN91C4S96printHex. Nibbles above 9 are shown as minus
+     *
+     * @param bcd - number to be printed, one decimal digit per nibble
+     * @param digits - low nibbles shown, up to 8. 0 for as many as the value needs
+     * @param group - dot between every `group` digits from the right. 0 for no dots
+     */
+void CN91C4S96printBCD(uint32_t bcd, uint8_t digits, uint8_t group);
+
+/**
+     * @brief Prints bit pattern, bit 0 is the rightmost digit: 0 or 1 per digit
+     *
+     * @param value - bits to be printed, e.g. error bitmap
+     * @param digits - low bits shown, up to the number of digits. 0 for as many as the value needs
+     * @param group - dot between every `group` digits from the right: 4 for "0010.0110". 0 for no dots
+     */
+void CN91C4S96printBin(uint32_t value, uint8_t digits, uint8_t group);
+
+#if CN91C4S96_USE_CLOCK
+/**
+     * @brief Prints number of date with dots in DD-MM-YY format. Only two low decimal digits of year are shown.
+     * Repeated calls redraw only digits which have changed since the previous call
      */
 void CN91C4S96printDate(int32_t day, int32_t mon, int32_t year);
 
+/**
+     * @brief Same as CN91C4S96printDate, but fields are packed BCD as they are stored in RTC registers
+     */
+void CN91C4S96printDateBCD(uint8_t day, uint8_t mon, uint8_t year);
+
+/**
+     * @brief Prints time in HH-MM-SS format.
+     * Repeated calls redraw only digits which have changed since the previous call,
+     * so a new second usually costs one or two bytes of display write
+     */
+void CN91C4S96printTime(uint8_t hours, uint8_t minutes, uint8_t seconds);
+
+/**
+     * @brief Same as CN91C4S96printTime, but fields are packed BCD as they are stored in RTC registers
+     */
+void CN91C4S96printTimeBCD(uint8_t hours, uint8_t minutes, uint8_t seconds);
+
+/**
+     * @brief Advances the shown time by one second. Does nothing if time is not on the display
+     */
+void CN91C4S96ClockTick(void);
+#endif
+
 /*!
     * \brief display min or max value
     *
@@ -358,10 +512,10 @@ void CN91C4S96DispPOV(bool enable);
      */
 void CN91C4S96DispWrite(void);
 
-#define DISPLAY_SIZE 9                             // 16 * 8  = 128 symbols on display plus 2 byte for address
-#define SYS_SIZE 2                                 // 2 byte for address and commands
-#define DATA_SIZE 16                               // 16 * 8  = 128 symbols on display
-#define DISPLAY_BUFFER_SIZE (DATA_SIZE + SYS_SIZE) //  plus 2 byte for address
+/*!
+     * \brief write whole buffer to display, also bytes which didn't change. For display RAM with unknown content
+     */
+void CN91C4S96DispRefresh(void);
 
 // defines to set display pin to low or high level
 #define LOW 0
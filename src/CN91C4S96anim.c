@@ -0,0 +1,134 @@
+/*******************************************************************************
+Animation player for CN91C4S96 driver. See CN91C4S96anim.h
+*******************************************************************************/
+
+#include "CN91C4S96anim.h"
+#include "CN91C4S96.h"
+
+#define DIGIT_FGE 0x70
+#define DIGIT_ABCD 0x0f
+#define DIGIT_NUM_MASK 0x7f
+
+#define SPINNER_MASK (CN91C4S96_ANIM_SEG_A | CN91C4S96_ANIM_SEG_B | CN91C4S96_ANIM_SEG_C | CN91C4S96_ANIM_SEG_D | \
+                      CN91C4S96_ANIM_SEG_E | CN91C4S96_ANIM_SEG_F)
+
+extern uint8_t *Buffer;
+// see CN91C4S96.c
+void clockReset(void);
+
+static const CN91C4S96AnimDelta_st spinA[] = {CN91C4S96_ANIM_DIGIT(0, SPINNER_MASK, CN91C4S96_ANIM_SEG_A)};
+static const CN91C4S96AnimDelta_st spinB[] = {CN91C4S96_ANIM_DIGIT(0, SPINNER_MASK, CN91C4S96_ANIM_SEG_B)};
+static const CN91C4S96AnimDelta_st spinC[] = {CN91C4S96_ANIM_DIGIT(0, SPINNER_MASK, CN91C4S96_ANIM_SEG_C)};
+static const CN91C4S96AnimDelta_st spinD[] = {CN91C4S96_ANIM_DIGIT(0, SPINNER_MASK, CN91C4S96_ANIM_SEG_D)};
+static const CN91C4S96AnimDelta_st spinE[] = {CN91C4S96_ANIM_DIGIT(0, SPINNER_MASK, CN91C4S96_ANIM_SEG_E)};
+static const CN91C4S96AnimDelta_st spinF[] = {CN91C4S96_ANIM_DIGIT(0, SPINNER_MASK, CN91C4S96_ANIM_SEG_F)};
+
+static const CN91C4S96AnimStep_st spinnerSteps[] = {
+    CN91C4S96_ANIM_STEP(spinA, 1), CN91C4S96_ANIM_STEP(spinB, 1), CN91C4S96_ANIM_STEP(spinC, 1),
+    CN91C4S96_ANIM_STEP(spinD, 1), CN91C4S96_ANIM_STEP(spinE, 1), CN91C4S96_ANIM_STEP(spinF, 1),
+};
+
+const CN91C4S96Anim_st CN91C4S96AnimSpinner = CN91C4S96_ANIM(spinnerSteps, true);
+
+// BAT4 is the battery body, CN91C4S96batteryLevel keeps it on at any level
+static const CN91C4S96AnimDelta_st charge0[] = {
+    CN91C4S96_ANIM_ICON(BAT4, true),
+    CN91C4S96_ANIM_ICON(BAT3, false),
+    CN91C4S96_ANIM_ICON(BAT2, false),
+    CN91C4S96_ANIM_ICON(BAT1, false),
+};
+static const CN91C4S96AnimDelta_st charge1[] = {CN91C4S96_ANIM_ICON(BAT3, true)};
+static const CN91C4S96AnimDelta_st charge2[] = {CN91C4S96_ANIM_ICON(BAT2, true)};
+static const CN91C4S96AnimDelta_st charge3[] = {CN91C4S96_ANIM_ICON(BAT1, true)};
+
+static const CN91C4S96AnimStep_st chargeSteps[] = {
+    CN91C4S96_ANIM_STEP(charge0, 1),
+    CN91C4S96_ANIM_STEP(charge1, 1),
+    CN91C4S96_ANIM_STEP(charge2, 1),
+    CN91C4S96_ANIM_STEP(charge3, 1),
+};
+
+const CN91C4S96Anim_st CN91C4S96AnimBatteryCharge = CN91C4S96_ANIM(chargeSteps, true);
+
+static void animWrite(uint8_t pos, uint8_t mask, uint8_t value)
+{
+    Buffer[pos] = (Buffer[pos] & ~mask) | (value & mask);
+}
+
+static void animApply(const CN91C4S96AnimStep_st *step)
+{
+    for (uint8_t i = 0; i < step->count; i++)
+    {
+        const CN91C4S96AnimDelta_st *d = &step->deltas[i];
+
+        if (!(d->pos & CN91C4S96_ANIM_DIGIT_FLAG))
+        {
+            if (d->pos < DATA_SIZE)
+                animWrite(d->pos, d->mask, d->value);
+            continue;
+        }
+
+        uint8_t n = d->pos & DIGIT_NUM_MASK;
+        if (n >= DISPLAY_SIZE)
+            // glass has less digits than the animation
+            continue;
+        n = DISPLAY_SIZE - 1 - n;
+        // the clock redraws only changed digits, this one isn't what it drew anymore
+        clockReset();
+        animWrite(CN91C4S96Layout.digitFGE[n], d->mask & DIGIT_FGE, d->value);
+        animWrite(CN91C4S96Layout.digitABCD[n], d->mask & DIGIT_ABCD, d->value);
+    }
+}
+
+static void animShow(CN91C4S96AnimPlayer_st *player)
+{
+    const CN91C4S96AnimStep_st *step = &player->anim->steps[player->step];
+    animApply(step);
+    player->wait = step->ticks ? step->ticks : 1;
+}
+
+void CN91C4S96AnimStart(CN91C4S96AnimPlayer_st *player, const CN91C4S96Anim_st *anim)
+{
+    player->anim = (anim && anim->count) ? anim : NULL;
+    player->step = 0;
+    if (!player->anim)
+        return;
+
+    animShow(player);
+    CN91C4S96DispWrite();
+}
+
+void CN91C4S96AnimStop(CN91C4S96AnimPlayer_st *player)
+{
+    player->anim = NULL;
+}
+
+bool CN91C4S96AnimTick(CN91C4S96AnimPlayer_st *players, size_t count)
+{
+    bool changed = false;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        CN91C4S96AnimPlayer_st *player = &players[i];
+        if (!player->anim || --player->wait)
+            continue;
+
+        if (player->step + 1 < player->anim->count)
+            player->step++;
+        else if (player->anim->loop)
+            player->step = 0;
+        else
+        {
+            // last step stays on the display
+            player->anim = NULL;
+            continue;
+        }
+        animShow(player);
+        changed = true;
+    }
+
+    // one write for all players, only bytes which differ from display RAM are sent
+    if (changed)
+        CN91C4S96DispWrite();
+    return changed;
+}
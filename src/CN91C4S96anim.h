@@ -0,0 +1,104 @@
+/*******************************************************************************
+Animation player for CN91C4S96 driver.
+
+An animation is a const table of steps, every step is a list of masked
+writes into the display Buffer. The player applies one step when its hold
+time runs out and sends the frame, so only the bytes touched by the step go
+to the display. Bits outside of the masks keep what print and icon functions
+put there. A digit delta is drawn over the clock like any print: ClockTick
+stops counting, the next printTime or printDate redraws the whole row.
+
+    static const CN91C4S96AnimDelta_st warnOn[] = {CN91C4S96_ANIM_ICON(WARN, true)};
+    static const CN91C4S96AnimDelta_st warnOff[] = {CN91C4S96_ANIM_ICON(WARN, false)};
+    static const CN91C4S96AnimStep_st warnSteps[] = {CN91C4S96_ANIM_STEP(warnOn, 5), CN91C4S96_ANIM_STEP(warnOff, 5)};
+    static const CN91C4S96Anim_st blinkWarn = CN91C4S96_ANIM(warnSteps, true);
+*******************************************************************************/
+
+#ifndef CN91C4S96ANIM_H_
+#define CN91C4S96ANIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "CN91C4S96layout.h"
+
+#define CN91C4S96_ANIM_DIGIT_FLAG 0x80 // pos is a digit number counted from the right, not a Buffer byte
+
+// digit segments in delta masks, same split as in frame: A, B, C, D in low nibble, F, G, E above
+#define CN91C4S96_ANIM_SEG_A 0x01
+#define CN91C4S96_ANIM_SEG_B 0x02
+#define CN91C4S96_ANIM_SEG_C 0x04
+#define CN91C4S96_ANIM_SEG_D 0x08
+#define CN91C4S96_ANIM_SEG_F 0x10
+#define CN91C4S96_ANIM_SEG_G 0x20
+#define CN91C4S96_ANIM_SEG_E 0x40
+
+typedef struct
+{
+    uint8_t pos;   // Buffer byte, or CN91C4S96_ANIM_DIGIT_FLAG | digit
+    uint8_t mask;  // bits owned by the animation. For digits: CN91C4S96_ANIM_SEG_x bits
+    uint8_t value; // new state of the masked bits
+} CN91C4S96AnimDelta_st;
+
+typedef struct
+{
+    const CN91C4S96AnimDelta_st *deltas;
+    uint8_t count;
+    uint8_t ticks; // ticks to show this step, 0 is the same as 1
+} CN91C4S96AnimStep_st;
+
+typedef struct
+{
+    const CN91C4S96AnimStep_st *steps;
+    uint8_t count;
+    bool loop; // start again after the last step, otherwise stop on it
+} CN91C4S96Anim_st;
+
+typedef struct
+{
+    const CN91C4S96Anim_st *anim; // NULL when stopped
+    uint8_t step;
+    uint8_t wait; // ticks left on the current step
+} CN91C4S96AnimPlayer_st;
+
+// icon of the selected glass on or off. Icons missing on the glass have zero mask
+#define CN91C4S96_ANIM_ICON(NAME, ON) {CN91C4S96_LAYOUT_ICON_##NAME, (ON) ? 0xff : 0x00}
+// segments of digit N counted from the right, 0 is the last digit
+#define CN91C4S96_ANIM_DIGIT(N, MASK, VALUE) {CN91C4S96_ANIM_DIGIT_FLAG | (N), MASK, VALUE}
+#define CN91C4S96_ANIM_STEP(DELTAS, TICKS) {DELTAS, sizeof(DELTAS) / sizeof((DELTAS)[0]), TICKS}
+#define CN91C4S96_ANIM(STEPS, LOOP) {STEPS, sizeof(STEPS) / sizeof((STEPS)[0]), LOOP}
+
+/*!
+    * \brief spinner on the last digit: one outer segment runs around, one step per tick
+    */
+extern const CN91C4S96Anim_st CN91C4S96AnimSpinner;
+
+/*!
+    * \brief battery charging: bars BAT3, BAT2, BAT1 fill up one by one, then start again
+    */
+extern const CN91C4S96Anim_st CN91C4S96AnimBatteryCharge;
+
+/*!
+    * \brief start animation from the first step and send it to display
+    *
+    * \param player state of one animation, any number of players may run together
+    * \param anim const table, stored by pointer
+    */
+void CN91C4S96AnimStart(CN91C4S96AnimPlayer_st *player, const CN91C4S96Anim_st *anim);
+
+/*!
+    * \brief stop animation. Its segments stay as the last applied step left them
+    */
+void CN91C4S96AnimStop(CN91C4S96AnimPlayer_st *player);
+
+/*!
+    * \brief advance running players by one tick. Applies steps which are due and sends the changed
+    * bytes to display in one write
+    *
+    * \param players array of players, stopped ones are skipped
+    * \param count number of players
+    * \return true if display was written
+    */
+bool CN91C4S96AnimTick(CN91C4S96AnimPlayer_st *players, size_t count);
+
+#endif
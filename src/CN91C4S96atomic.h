@@ -0,0 +1,33 @@
+/*******************************************************************************
+Atomic field types of the CN91C4S96 driver structs.
+
+Structs of the public headers which are shared between a producer and the
+display task have atomic fields. C11 <stdatomic.h> can't be included from
+C++, so a C++ translation unit sees std::atomic of the same value type
+instead: GCC and Clang give both the same size, alignment and lock-free
+representation. Only the C sources of the driver touch these fields, C++
+code allocates the structs and passes them to the driver functions.
+
+The header may be included inside extern "C", as the driver headers are.
+*******************************************************************************/
+
+#ifndef CN91C4S96ATOMIC_H_
+#define CN91C4S96ATOMIC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C++"
+{
+#include <atomic>
+    typedef std::atomic<uint_fast8_t> CN91C4S96_atomic_u8;
+    typedef std::atomic<bool> CN91C4S96_atomic_bool;
+}
+#else
+#include <stdatomic.h>
+typedef atomic_uint_fast8_t CN91C4S96_atomic_u8;
+typedef atomic_bool CN91C4S96_atomic_bool;
+#endif
+
+#endif
@@ -0,0 +1,111 @@
+/*******************************************************************************
+Shared I2C bus arbiter for CN91C4S96 driver. See CN91C4S96bus.h
+*******************************************************************************/
+
+#include "CN91C4S96bus.h"
+
+#define PRIORITY_ALL (-1) // below every job priority
+
+static CN91C4S96_HAL_st *busHal = 0;
+static CN91C4S96_HAL_st busWrapHal;
+static uint8_t busPriority = 0;
+static CN91C4S96BusJob_st *busJobs = NULL; // highest priority first
+static bool busInFlight = false;           // display transfer started and not waited for
+
+static void busFinish(void)
+{
+    if (busInFlight)
+    {
+        busHal->WaitI2C();
+        busInFlight = false;
+    }
+}
+
+// run pending jobs with priority above `floor`, the most urgent first
+static uint8_t busRun(int16_t floor)
+{
+    uint8_t count = 0;
+    CN91C4S96BusJob_st *job = busJobs;
+
+    while (job && job->priority > floor)
+    {
+        if (!atomic_load_explicit(&job->pending, memory_order_acquire))
+        {
+            job = job->next;
+            continue;
+        }
+        // display transfer is over before another device is addressed
+        busFinish();
+        // cleared before run: a request made while it runs is kept
+        atomic_store_explicit(&job->pending, false, memory_order_relaxed);
+        job->status = job->run(job->ctx);
+        count++;
+        // a more urgent job may have been requested meanwhile
+        job = busJobs;
+    }
+    return count;
+}
+
+static void busInitI2C(void)
+{
+    if (busHal->InitI2C)
+        busHal->InitI2C();
+}
+
+static int8_t busWriteI2C(uint8_t address, const uint8_t *data, uint16_t size)
+{
+    busRun(busPriority);
+    busInFlight = true;
+    return busHal->WriteI2C(address, data, size);
+}
+
+static void busWaitI2C(void)
+{
+    busHal->WaitI2C();
+    busInFlight = false;
+    // chunk is over: urgent jobs go before the next one
+    busRun(busPriority);
+}
+
+CN91C4S96_HAL_st *CN91C4S96BusHal(CN91C4S96_HAL_st *hal_ptr, uint8_t chunk, uint8_t priority)
+{
+    if (!hal_ptr)
+        return hal_ptr;
+
+    busHal = hal_ptr;
+    busPriority = priority;
+    busInFlight = false;
+    // backend splits the frame, every burst is addressed on its own
+    CN91C4S96Backend.maxBurst = (chunk && chunk < DATA_SIZE) ? chunk : DATA_SIZE;
+
+    busWrapHal.InitI2C = busInitI2C;
+    busWrapHal.WriteI2C = busWriteI2C;
+    busWrapHal.WaitI2C = busWaitI2C;
+    return &busWrapHal;
+}
+
+void CN91C4S96BusAttach(CN91C4S96BusJob_st *job)
+{
+    CN91C4S96BusJob_st **link = &busJobs;
+
+    // after the jobs of the same priority, they are served in attach order
+    while (*link && (*link)->priority >= job->priority)
+    {
+        link = &(*link)->next;
+    }
+    atomic_init(&job->pending, false);
+    job->next = *link;
+    *link = job;
+}
+
+void CN91C4S96BusRequest(CN91C4S96BusJob_st *job)
+{
+    atomic_store_explicit(&job->pending, true, memory_order_release);
+}
+
+uint8_t CN91C4S96BusService(void)
+{
+    if (!busHal)
+        return 0;
+    return busRun(PRIORITY_ALL);
+}
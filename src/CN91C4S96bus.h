@@ -0,0 +1,78 @@
+/*******************************************************************************
+Shared I2C bus arbiter for CN91C4S96 driver.
+
+Sits between the driver and the HAL like the trace recorder. Display data
+is sent in chunks of at most `chunk` bytes; every chunk is a complete
+transfer with its own display RAM address, so the controller never sees a
+write cut by traffic to other devices. Between chunks, the bus is given to
+other clients (EEPROM, sensors) whose jobs have a higher priority than the
+display. A waiting urgent job is delayed by one chunk at most:
+(chunk + 3) bytes on the bus instead of the 19 of a full frame.
+
+A client owns a job: a function which does its whole transfer with the
+blocking HAL calls, and a priority. Jobs are attached once and requested
+from any context, ISRs too; requests never block. Pending jobs run between
+display chunks if they are more urgent than the display, and all of them
+in CN91C4S96BusService(), which is called by the code which owns the bus:
+the main loop or the display task.
+
+    static int8_t tempRead(void *ctx) { return I2C_Read(TEMP_ADDR, ctx, 2); }
+    static uint8_t tempRaw[2];
+    static CN91C4S96BusJob_st tempJob = {200, tempRead, tempRaw};
+
+    CN91C4S96BusAttach(&tempJob);
+    CN91C4S96Init(CN91C4S96BusHal(&hal, 4, 100));
+
+    // timer ISR
+    CN91C4S96BusRequest(&tempJob);
+
+    // main loop
+    CN91C4S96DispWrite();
+    CN91C4S96BusService();
+*******************************************************************************/
+
+#ifndef CN91C4S96BUS_H_
+#define CN91C4S96BUS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "CN91C4S96atomic.h"
+#include "CN91C4S96.h"
+
+typedef struct CN91C4S96BusJob_st
+{
+    uint8_t priority;              // higher runs first. Above display priority: also between display chunks
+    int8_t (*run)(void *ctx);      // whole transfer of the client, blocking HAL calls. Returns HAL status
+    void *ctx;
+    int8_t status;                 // what run returned last time
+    CN91C4S96_atomic_bool pending; // requested and not yet started
+    struct CN91C4S96BusJob_st *next;
+} CN91C4S96BusJob_st;
+
+/**
+     * @brief Returns HAL to be passed into CN91C4S96Init instead of the original one
+     *
+     * @param hal_ptr - original HAL
+     * @param chunk - most data bytes of a display transfer, 0 for whole frame
+     * @param priority - jobs with higher priority are run between display chunks
+     */
+CN91C4S96_HAL_st *CN91C4S96BusHal(CN91C4S96_HAL_st *hal_ptr, uint8_t chunk, uint8_t priority);
+
+/**
+     * @brief Add job of a bus client. Call before jobs are requested
+     */
+void CN91C4S96BusAttach(CN91C4S96BusJob_st *job);
+
+/**
+     * @brief Ask to run job on the bus. Any context, never blocks. A job requested again before it started runs once
+     */
+void CN91C4S96BusRequest(CN91C4S96BusJob_st *job);
+
+/**
+     * @brief Run all pending jobs, highest priority first. Call from the context which writes the display
+     *
+     * @return number of jobs run
+     */
+uint8_t CN91C4S96BusService(void);
+
+#endif
@@ -0,0 +1,51 @@
+/*******************************************************************************
+Feature switches of the CN91C4S96 driver.
+
+Every switch is on by default. Set it to 0 with -D or edit this file to drop
+the code and tables of an unused feature from flash. Functions of a disabled
+feature are not declared, so a call to one of them fails at compile time.
+
+Icon setters and other small functions which are not called are also removed
+by the linker when the driver is built with
+-ffunction-sections -fdata-sections and linked with -Wl,--gc-sections.
+
+tools/sizereport.py shows what every switch costs.
+*******************************************************************************/
+
+#ifndef CN91C4S96CONFIG_H_
+#define CN91C4S96CONFIG_H_
+
+// CN91C4S96printFloat. Pulls floating point support of the compiler runtime
+#ifndef CN91C4S96_USE_FLOAT
+#define CN91C4S96_USE_FLOAT 1
+#endif
+
+// CN91C4S96printStr and the ASCII glyph table
+#ifndef CN91C4S96_USE_TEXT
+#define CN91C4S96_USE_TEXT 1
+#endif
+
+// letter rows of the ASCII glyph table and non-ASCII glyphs. Without them printStr shows only digits, space, minus and underscore
+#ifndef CN91C4S96_USE_LETTERS
+#define CN91C4S96_USE_LETTERS 1
+#endif
+
+// CN91C4S96printDate, CN91C4S96printTime, their BCD variants and CN91C4S96ClockTick
+#ifndef CN91C4S96_USE_CLOCK
+#define CN91C4S96_USE_CLOCK 1
+#endif
+
+// icon languages. With one of them off `mode` arguments which select RU or EN icon are ignored
+#ifndef CN91C4S96_ICONS_RU
+#define CN91C4S96_ICONS_RU 1
+#endif
+
+#ifndef CN91C4S96_ICONS_EN
+#define CN91C4S96_ICONS_EN 1
+#endif
+
+#if !CN91C4S96_ICONS_RU && !CN91C4S96_ICONS_EN
+#error "at least one of CN91C4S96_ICONS_RU and CN91C4S96_ICONS_EN is needed"
+#endif
+
+#endif
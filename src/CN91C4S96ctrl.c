@@ -0,0 +1,201 @@
+/*******************************************************************************
+CN91C4S96 controller backend. See CN91C4S96ctrl.h
+*******************************************************************************/
+
+#include "CN91C4S96.h"
+#include "CN91C4S96ctrl.h"
+#include "main.h"
+#include <string.h>
+
+/**
+ * @brief DISPLAY HARDWARE DEFINES BLOCK
+ */
+#define ULP 0x50    //0b 0101 0000  ULP Set ‘1’ to enable the Ultra-Low-Power mode, which can decrease total power consumption further more along with ‘SR’ and ‘FR’ Power
+#define SYSEN 0x48  //0b 0100 1000  EN 0: disable all blocks on-chip, all com/seg pin will be pulled to GND. 1: enable
+#define LCDOFF 0x79 //0b 0111 1001  Turn off all LCD segments
+#define LCDON 0x7A  //0b 0111 1010  Turn on all LCD segments
+
+#define PIXONOFFDATA 0x78 //0b 0111 1000  All pixels are ON/OFF depending on the data in
+#define NOBLINK 0x70      //0b 0111 0000  No blink
+#define EV0 0x60          //0b 0110 0000 EV=0 Adjust resistor divider for LCD contrast setting.
+#define NORMALMODE 0x20   //0b 0010 0000 80Hz Normal Mode, Line inverse, *0.5, Power Save Mode 1
+
+#define SLAVE_OWN_ADDRESS 0x7C
+#define MODE_CMD 0x01
+#define MODE_DATA 0x00
+#define ADR04_CMD 0x80
+#define ADR56_CMD 0xe8
+#define ADR04_MASK 0x1f    // DRAM address bits sent together with MODE_DATA
+#define NIBBLES_PER_BYTE 2 // DRAM is addressed by 4-bit SEG columns, frame keeps two of them per byte
+
+#define ADR0_SHIFT 0
+#define ADR1_SHIFT 7
+
+// unchanged bytes between two changed runs are sent too if they cost less than new transfer:
+// I2C address byte and SYS_SIZE header bytes
+#define MERGE_GAP (SYS_SIZE + 1)
+
+#define LITTLE_ENDIAN
+
+#if !defined(BIG_ENDIAN) && !defined(LITTLE_ENDIAN)
+#error "Unable to determine endian. Set it manually"
+#endif
+
+union tDataSeq
+{
+    struct //__attribute__((packed))
+    {
+#if defined LITTLE_ENDIAN
+        uint8_t padding : 7;
+        uint64_t data1 : 64;
+        uint64_t data0 : 64;
+        uint8_t addr : 6;
+        uint8_t type : 3;
+#elif defined BIG_ENDIAN
+        uint8_t type : 3;
+        uint8_t addr : 6;
+        uint16_t data0 : 16;
+        uint16_t data1 : 16;
+        uint16_t data2 : 16;
+        uint8_t padding : 7;
+#endif
+    };
+    uint8_t arr[18];
+};
+
+extern CN91C4S96_HAL_st *CN91C4S96_hal;
+
+// the most low-level function. Sends array of bytes into display
+void wrBytes(uint8_t *ptr, uint8_t size);
+// write command sequence to display
+void wrCmd(uint8_t cmd);
+// write `count` bytes of frame starting from `first` using DRAM address auto-increment
+void wrRange(const uint8_t *frame, uint8_t first, uint8_t count);
+
+static void ctrlInit(void);
+static bool ctrlCommand(CN91C4S96_Ctrl_en cmd);
+static void ctrlFlush(const uint8_t *frame, const uint8_t *shadow);
+
+CN91C4S96_Backend_st CN91C4S96Backend = {ctrlInit, ctrlCommand, ctrlFlush, DATA_SIZE};
+
+static void ctrlInit(void)
+{
+    assert_param(CN91C4S96_hal->InitI2C != NULL);
+    CN91C4S96_hal->InitI2C();
+}
+
+static bool ctrlCommand(CN91C4S96_Ctrl_en cmd)
+{
+    switch (cmd)
+    {
+    case CTRL_INIT:
+        wrCmd(ULP | SYSEN);
+        //        wrCmd(PIXONOFFDATA);
+        //        wrCmd(NOBLINK);
+        //        wrCmd(EV0);
+        //        wrCmd(NORMALMODE);
+        return true;
+    case CTRL_SHOW_DATA:
+        wrCmd(PIXONOFFDATA);
+        return true;
+    case CTRL_ALL_ON:
+        wrCmd(LCDON);
+        return true;
+    case CTRL_ALL_OFF:
+        wrCmd(LCDOFF);
+        return true;
+    case CTRL_DISABLE:
+        wrCmd(ULP);
+        return true;
+    case CTRL_LOW_POWER:
+        wrCmd(ULP | SYSEN);
+        return true;
+    case CTRL_FULL_POWER:
+        wrCmd(SYSEN);
+        return true;
+    }
+    return false;
+}
+
+static void ctrlFlush(const uint8_t *frame, const uint8_t *shadow)
+{
+    uint8_t maxBurst = CN91C4S96Backend.maxBurst ? CN91C4S96Backend.maxBurst : DATA_SIZE;
+    bool pending = false;
+    uint8_t i = 0;
+
+    while (i < DATA_SIZE)
+    {
+        if (shadow && frame[i] == shadow[i])
+        {
+            i++;
+            continue;
+        }
+
+        // one auto-increment burst over the changed bytes and short unchanged gaps between them
+        uint8_t first = i;
+        uint8_t end = i + 1;
+        uint8_t gap = 0;
+        for (uint8_t j = i + 1; j < DATA_SIZE && j - first < maxBurst; j++)
+        {
+            if (!shadow || frame[j] != shadow[j])
+            {
+                end = j + 1;
+                gap = 0;
+            }
+            else if (++gap > MERGE_GAP)
+            {
+                break;
+            }
+        }
+
+        if (pending)
+            CN91C4S96_hal->WaitI2C(); // previous burst buffer is reused
+        wrRange(frame, first, end - first);
+        pending = true;
+        i = end;
+    }
+}
+
+void wrBytes(uint8_t *ptr, uint8_t size)
+{
+    // TODO: check wrong size
+    assert_param(CN91C4S96_hal->WriteI2C != NULL);
+    CN91C4S96_hal->WriteI2C(SLAVE_OWN_ADDRESS, ptr, size);
+}
+
+void wrRange(const uint8_t *frame, uint8_t first, uint8_t count)
+{
+    static uint8_t BufferPart[DISPLAY_BUFFER_SIZE]; // static: transfer may still be in progress after return
+
+    if (count == 0 || first + count > DATA_SIZE)
+        return;
+
+    BufferPart[0] = ADR56_CMD;
+    BufferPart[1] = MODE_DATA | ((first * NIBBLES_PER_BYTE) & ADR04_MASK);
+    memcpy(BufferPart + SYS_SIZE, frame + first, count);
+    wrBytes(BufferPart, count + SYS_SIZE);
+}
+
+void wrCmd(uint8_t cmd)
+{
+    assert_param(CN91C4S96_hal->WaitI2C != NULL);
+    union
+    {
+        struct __attribute__((packed))
+        {
+#if defined LITTLE_ENDIAN
+            uint8_t data : 7;
+            uint8_t type : 1;
+#elif defined BIG_ENDIAN
+            uint8_t type : 1;
+            uint8_t data : 7;
+#endif
+        };
+        uint8_t arr[1];
+    } CommandSeq;
+    CommandSeq.type = MODE_CMD;
+    CommandSeq.data = cmd;
+
+    wrBytes(CommandSeq.arr, sizeof(CommandSeq));
+    CN91C4S96_hal->WaitI2C();
+}
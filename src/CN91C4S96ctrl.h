@@ -0,0 +1,48 @@
+/*******************************************************************************
+Controller backend interface of the CN91C4S96 driver.
+
+The driver keeps frame and glyph logic, a backend knows how to talk to one
+controller type: command encoding, addressing and how to send the changed
+part of a frame in as few and as short transfers as the chip allows.
+
+Frame layout is the same for every backend: DATA_SIZE bytes, byte n holds
+display RAM nibble addresses 2n (bits 7..4) and 2n + 1 (bits 3..0), bit 3 of
+a nibble is COM0.
+*******************************************************************************/
+
+#ifndef CN91C4S96CTRL_H_
+#define CN91C4S96CTRL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum
+{
+    CTRL_INIT = 0,   // start controller after power-on or CTRL_DISABLE
+    CTRL_SHOW_DATA,  // segments follow display RAM
+    CTRL_ALL_ON,     // all segments on, display RAM is kept
+    CTRL_ALL_OFF,    // all segments off, display RAM is kept
+    CTRL_DISABLE,    // stop oscillator and LCD drive, display RAM is kept
+    CTRL_LOW_POWER,  // lowest drive power, segments stay visible. CN91C4S96 starts in it
+    CTRL_FULL_POWER, // normal drive power
+} CN91C4S96_Ctrl_en;
+
+typedef struct
+{
+    // init bus and controller interface
+    void (*Init)(void);
+    // send command. Returns false if controller has no such command
+    bool (*Command)(CN91C4S96_Ctrl_en cmd);
+    // send the part of `frame` which differs from `shadow`. `shadow` is NULL if RAM content is unknown
+    void (*Flush)(const uint8_t *frame, const uint8_t *shadow);
+    // most data bytes in one bus transfer. Longer updates are split
+    uint8_t maxBurst;
+} CN91C4S96_Backend_st;
+
+/*!
+    * \brief CN91C4S96 backend: I2C, commands with continuation flag, auto-increment bursts.
+    * Uses HAL given to CN91C4S96Init
+    */
+extern CN91C4S96_Backend_st CN91C4S96Backend;
+
+#endif
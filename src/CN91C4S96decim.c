@@ -0,0 +1,104 @@
+/*******************************************************************************
+Sample decimator for CN91C4S96 driver. See CN91C4S96decim.h
+*******************************************************************************/
+
+#include "CN91C4S96decim.h"
+#include "CN91C4S96.h"
+
+static void windowReset(CN91C4S96DecimWindow_st *window)
+{
+    window->sum = 0;
+    window->count = 0;
+    // the first sample replaces both, no branch on count in CN91C4S96DecimPush
+    window->min = INT32_MAX;
+    window->max = INT32_MIN;
+}
+
+// mean rounded half away from zero
+static int32_t windowMean(const CN91C4S96DecimWindow_st *window)
+{
+    int64_t half = window->count / 2;
+    int64_t sum = (window->sum < 0) ? window->sum - half : window->sum + half;
+    return (int32_t)(sum / window->count);
+}
+
+static void decimRender(const CN91C4S96Decim_st *decim)
+{
+    int32_t value = (decim->view == CN91C4S96_DECIM_MIN)   ? decim->min
+                    : (decim->view == CN91C4S96_DECIM_MAX) ? decim->max
+                                                           : decim->mean;
+
+    CN91C4S96printFixed(value, decim->multiplier);
+    CN91C4S96DispMinMax(decim->view != CN91C4S96_DECIM_MEAN, decim->iconMode, decim->view == CN91C4S96_DECIM_MIN);
+}
+
+void CN91C4S96DecimInit(CN91C4S96Decim_st *decim, uint32_t periodTicks, uint32_t multiplier, bool iconMode)
+{
+    windowReset(&decim->bank[0]);
+    windowReset(&decim->bank[1]);
+    atomic_init(&decim->active, 0);
+    decim->periodTicks = periodTicks;
+    decim->multiplier = multiplier;
+    decim->iconMode = iconMode;
+    decim->view = CN91C4S96_DECIM_MEAN;
+    decim->windowStart = 0;
+    decim->started = false;
+    decim->mean = 0;
+    decim->min = 0;
+    decim->max = 0;
+    decim->valid = false;
+}
+
+void CN91C4S96DecimPush(CN91C4S96Decim_st *decim, int32_t sample)
+{
+    CN91C4S96DecimWindow_st *window = &decim->bank[atomic_load_explicit(&decim->active, memory_order_acquire)];
+
+    window->sum += sample;
+    window->count++;
+    if (sample < window->min)
+        window->min = sample;
+    if (sample > window->max)
+        window->max = sample;
+}
+
+bool CN91C4S96DecimUpdate(CN91C4S96Decim_st *decim, uint32_t now)
+{
+    if (!decim->started)
+    {
+        // samples pushed before the first call belong to the first window
+        decim->started = true;
+        decim->windowStart = now;
+        return false;
+    }
+    uint32_t elapsed = now - decim->windowStart;
+    if (elapsed < decim->periodTicks)
+        return false;
+    // next window starts at the last period boundary, not at the late call
+    decim->windowStart = decim->periodTicks ? now - elapsed % decim->periodTicks : now;
+
+    // producer goes on in the other bank, this one is ours until the next switch
+    uint_fast8_t closed = atomic_load_explicit(&decim->active, memory_order_relaxed);
+    atomic_store_explicit(&decim->active, closed ^ 1, memory_order_release);
+    atomic_thread_fence(memory_order_acquire);
+    CN91C4S96DecimWindow_st *window = &decim->bank[closed];
+
+    if (window->count == 0)
+        return false;
+    decim->mean = windowMean(window);
+    decim->min = window->min;
+    decim->max = window->max;
+    decim->valid = true;
+    windowReset(window);
+
+    decimRender(decim);
+    return true;
+}
+
+bool CN91C4S96DecimView(CN91C4S96Decim_st *decim, CN91C4S96_Decim_en view)
+{
+    decim->view = view;
+    if (!decim->valid)
+        return false;
+    decimRender(decim);
+    return true;
+}
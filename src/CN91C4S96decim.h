@@ -0,0 +1,100 @@
+/*******************************************************************************
+Sample decimator for CN91C4S96 driver.
+
+Between a fast sensor (50-100 Hz) and the display, which changes about once
+a second. The sensor side only accumulates: a sample is an integer add and
+two compares into the current window, no division and no display work.
+At the display rate the window is closed, its mean, min and max are kept
+and the value of the selected view is printed with CN91C4S96printFixed,
+with the MIN or MAX icon for the extreme views.
+
+    static CN91C4S96Decim_st flow;
+    CN91C4S96DecimInit(&flow, 1000, 1000, false); // 1 s windows, 3 decimals, EN icons
+
+    // sensor ISR, 100 Hz, litres per hour * 1000
+    CN91C4S96DecimPush(&flow, sample);
+
+    // main loop
+    if (CN91C4S96DecimUpdate(&flow, GetTick()))
+        CN91C4S96DispWrite();
+    // button
+    if (CN91C4S96DecimView(&flow, CN91C4S96_DECIM_MAX))
+        CN91C4S96DispWrite();
+
+One producer pushes samples: an ISR, or a task which the caller of
+CN91C4S96DecimUpdate never preempts. The window is closed by switching the
+producer to the other one of two banks, so pushes never wait or get lost.
+*******************************************************************************/
+
+#ifndef CN91C4S96DECIM_H_
+#define CN91C4S96DECIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "CN91C4S96atomic.h"
+
+typedef enum
+{
+    CN91C4S96_DECIM_MEAN = 0, // mean of the window, MIN/MAX icons off
+    CN91C4S96_DECIM_MIN,      // lowest sample of the window, MIN icon
+    CN91C4S96_DECIM_MAX,      // highest sample of the window, MAX icon
+} CN91C4S96_Decim_en;
+
+typedef struct
+{
+    int64_t sum;
+    uint32_t count;
+    int32_t min;
+    int32_t max;
+} CN91C4S96DecimWindow_st;
+
+typedef struct
+{
+    CN91C4S96DecimWindow_st bank[2];
+    CN91C4S96_atomic_u8 active; // bank which the producer fills
+    uint32_t periodTicks;       // window length, the display rate
+    uint32_t multiplier;        // of CN91C4S96printFixed, samples are values * multiplier
+    bool iconMode;              // true for russian MIN/MAX icons, see CN91C4S96DispMinMax
+    CN91C4S96_Decim_en view;
+    uint32_t windowStart;       // on the grid of periodTicks from the first update
+    bool started;
+    // last closed window with samples
+    int32_t mean;
+    int32_t min;
+    int32_t max;
+    bool valid;
+} CN91C4S96Decim_st;
+
+/*!
+    * \brief init decimator, mean view. Call before the producer starts
+    *
+    * \param periodTicks window length in the ticks of CN91C4S96DecimUpdate
+    * \param multiplier printFixed multiplier of samples, 1 for integers
+    * \param iconMode true for russian MIN/MAX icons
+    */
+void CN91C4S96DecimInit(CN91C4S96Decim_st *decim, uint32_t periodTicks, uint32_t multiplier, bool iconMode);
+
+/*!
+    * \brief add one sample to the current window. O(1), for ISRs
+    */
+void CN91C4S96DecimPush(CN91C4S96Decim_st *decim, int32_t sample);
+
+/*!
+    * \brief close the window when its period is over and print the selected view of it.
+    * A window without samples keeps the previous value on the glass. Windows stay on the period
+    * grid, so a late call doesn't slow down the display rate; periods missed as a whole are merged
+    * into the closed window
+    *
+    * \param now current time in ticks
+    * \return true if Buffer was changed
+    */
+bool CN91C4S96DecimUpdate(CN91C4S96Decim_st *decim, uint32_t now);
+
+/*!
+    * \brief select what is shown, printed at once from the last closed window
+    *
+    * \return true if Buffer was changed
+    */
+bool CN91C4S96DecimView(CN91C4S96Decim_st *decim, CN91C4S96_Decim_en view);
+
+#endif
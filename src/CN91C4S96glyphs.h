@@ -0,0 +1,38 @@
+/*******************************************************************************
+Glyph set of CN91C4S96printStr.
+
+printStr takes UTF-8 text. Every character takes one digit and is shown by
+the glyph from a table made of a text map (see extras/glyphs.map) by
+tools/glyphgen.py:
+
+    python3 tools/glyphgen.py extras/glyphs.map src/CN91C4S96glyphs_default.h
+
+ASCII characters are looked up in a dense table by code. Other code points
+(cyrillic, degree sign, ...) are looked up in a perfect hash table: one
+multiplication, one load and one compare, the same for known and unknown
+characters. Unknown characters and invalid UTF-8 are shown as blank.
+
+Another set is chosen at compile time with CN91C4S96_GLYPHS_HEADER, for
+example -DCN91C4S96_GLYPHS_HEADER='"CN91C4S96glyphs_xyz.h"'. The hash
+table is left out with CN91C4S96_USE_LETTERS off.
+*******************************************************************************/
+
+#ifndef CN91C4S96GLYPHS_H_
+#define CN91C4S96GLYPHS_H_
+
+#ifndef CN91C4S96_GLYPHS_HEADER
+#define CN91C4S96_GLYPHS_HEADER "CN91C4S96glyphs_default.h"
+#endif
+#include CN91C4S96_GLYPHS_HEADER
+
+// slot of code point CP in CN91C4S96_GLYPHS_HASH
+#define CN91C4S96_GLYPH_HASH(CP) ((uint16_t)((CP)*CN91C4S96_GLYPHS_HASH_MULT) >> (16 - CN91C4S96_GLYPHS_HASH_BITS))
+
+// lowercase cyrillic is shown by the uppercase glyph. The same folding in CN91C4S96.c, CN91C4S96text.hpp and
+// tools/textgen.py, which reads it from here
+#define CN91C4S96_CYRILLIC_LOWER_FIRST 0x430 // а..я are А..Я + 0x20
+#define CN91C4S96_CYRILLIC_CASE_COUNT 0x20
+#define CN91C4S96_CYRILLIC_YO_LOWER 0x451 // ё is Ё + 0x50
+#define CN91C4S96_CYRILLIC_YO_DELTA 0x50
+
+#endif
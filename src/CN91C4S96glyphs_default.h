@@ -0,0 +1,43 @@
+/*******************************************************************************
+Glyph tables of CN91C4S96printStr, see CN91C4S96glyphs.h
+
+Generated by tools/glyphgen.py from glyphs.map, don't edit.
+*******************************************************************************/
+
+#ifndef CN91C4S96GLYPHS_DEFAULT_H_
+#define CN91C4S96GLYPHS_DEFAULT_H_
+
+// codes 0x20..0x3f
+#define CN91C4S96_GLYPHS_ASCII \
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, \
+    0x7d, 0x60, 0x3e, 0x7a, 0x63, 0x5b, 0x5f, 0x70, 0x7f, 0x7b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+
+// codes 0x40..0x7f
+#define CN91C4S96_GLYPHS_ASCII_LETTERS \
+    0x00, 0x77, 0x4f, 0x1d, 0x6e, 0x1f, 0x17, 0x5d, 0x47, 0x05, 0x68, 0x27, 0x0d, 0x54, 0x75, 0x4e, \
+    0x37, 0x73, 0x06, 0x59, 0x0f, 0x6d, 0x23, 0x29, 0x67, 0x6b, 0x3c, 0x00, 0x00, 0x00, 0x00, 0x08, \
+    0x00, 0x77, 0x4f, 0x1d, 0x6e, 0x1f, 0x17, 0x5d, 0x47, 0x05, 0x68, 0x27, 0x0d, 0x54, 0x75, 0x4e, \
+    0x37, 0x73, 0x06, 0x59, 0x0f, 0x6d, 0x23, 0x29, 0x67, 0x6b, 0x3c, 0x00, 0x00, 0x00, 0x00, 0x00
+
+// other code points: slot ((uint16_t)(cp * MULT) >> (16 - BITS)) holds {cp, glyph}
+#define CN91C4S96_GLYPHS_HASH_MULT 0x03eb
+#define CN91C4S96_GLYPHS_HASH_BITS 6
+#define CN91C4S96_GLYPHS_HASH \
+    {0x0416, 0x67}, {0x0417, 0x7a}, {0x0418, 0x6d}, {0x0419, 0x6d}, \
+    {0x041a, 0x27}, {0x041b, 0x75}, {0x041c, 0x54}, {0x041d, 0x67}, \
+    {0x041e, 0x7d}, {0x041f, 0x75}, {0x0420, 0x37}, {0x0421, 0x1d}, \
+    {0x0422, 0x0f}, {0x0423, 0x6b}, {0x0424, 0x73}, {0x0425, 0x67}, \
+    {0x0426, 0x6d}, {0x0427, 0x63}, {0x0428, 0x6d}, {0x0429, 0x6d}, \
+    {0x042a, 0x4f}, {0x042b, 0x4f}, {0x042c, 0x4f}, {0x042d, 0x7a}, \
+    {0x042e, 0x7d}, {0x042f, 0x73}, {0x0000, 0x00}, {0x0000, 0x00}, \
+    {0x0000, 0x00}, {0x0000, 0x00}, {0x0000, 0x00}, {0x2212, 0x02}, \
+    {0x0000, 0x00}, {0x0000, 0x00}, {0x0000, 0x00}, {0x0000, 0x00}, \
+    {0x0000, 0x00}, {0x0000, 0x00}, {0x0000, 0x00}, {0x0000, 0x00}, \
+    {0x0000, 0x00}, {0x0000, 0x00}, {0x2013, 0x02}, {0x0401, 0x1f}, \
+    {0x00b0, 0x33}, {0x0000, 0x00}, {0x0000, 0x00}, {0x0000, 0x00}, \
+    {0x0000, 0x00}, {0x0000, 0x00}, {0x0000, 0x00}, {0x0000, 0x00}, \
+    {0x0000, 0x00}, {0x0000, 0x00}, {0x0000, 0x00}, {0x0000, 0x00}, \
+    {0x0000, 0x00}, {0x0000, 0x00}, {0x0410, 0x77}, {0x0411, 0x5f}, \
+    {0x0412, 0x7f}, {0x0413, 0x15}, {0x0414, 0x6e}, {0x0415, 0x1f}
+
+#endif
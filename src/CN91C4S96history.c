@@ -0,0 +1,156 @@
+/*******************************************************************************
+Frame history recorder for CN91C4S96 driver. See CN91C4S96history.h for format.
+*******************************************************************************/
+
+#include "CN91C4S96history.h"
+#include "CN91C4S96.h"
+#include <string.h>
+
+#if HISTORY_FRAME_SIZE != DATA_SIZE
+#error "HISTORY_FRAME_SIZE must be DATA_SIZE"
+#endif
+
+// see CN91C4S96.c
+void commitAttach(void (*hook)(const uint8_t *frame));
+void commitDetach(void (*hook)(const uint8_t *frame));
+
+static uint8_t *histBuf = 0;
+static size_t histCap = 0;
+static size_t histHead = 0; // oldest record
+static size_t histLen = 0;  // bytes of records in the ring
+static uint32_t histCount = 0;
+static uint32_t histFolded = 0;
+static uint8_t histBase[DATA_SIZE]; // frame before the oldest record
+static uint8_t histLast[DATA_SIZE]; // frame after the newest record
+
+static uint8_t histAt(size_t i)
+{
+    return histBuf[(histHead + i) % histCap];
+}
+
+// XOR one record starting at ring offset `i` into frame, returns its length
+static size_t histApply(size_t i, uint8_t *frame)
+{
+    size_t start = i;
+    uint8_t pos = 0;
+
+    for (;;)
+    {
+        uint8_t token = histAt(i++);
+        if (token == HISTORY_END)
+            break;
+        pos += HISTORY_SKIP(token);
+        for (uint8_t n = 0; n < HISTORY_COUNT(token) && pos < DATA_SIZE; n++)
+        {
+            frame[pos++] ^= histAt(i++);
+        }
+    }
+    return i - start;
+}
+
+static size_t histEncode(const uint8_t *frame, uint8_t *rec)
+{
+    size_t len = 0;
+    uint8_t pos = 0;
+
+    while (pos < DATA_SIZE)
+    {
+        uint8_t skip = 0;
+        while (pos < DATA_SIZE && frame[pos] == histLast[pos])
+        {
+            pos++;
+            skip++;
+        }
+        if (pos == DATA_SIZE)
+            break;
+
+        // skip can't be 16 here: the changed byte is inside the frame
+        size_t token = len++;
+        uint8_t count = 0;
+        while (pos < DATA_SIZE && frame[pos] != histLast[pos] && count < 0x0f)
+        {
+            rec[len++] = frame[pos] ^ histLast[pos];
+            pos++;
+            count++;
+        }
+        rec[token] = HISTORY_TOKEN(skip, count);
+    }
+    rec[len++] = HISTORY_END;
+    return len;
+}
+
+static void histCommit(const uint8_t *frame)
+{
+    uint8_t rec[HISTORY_RECORD_MAX];
+
+    if (memcmp(frame, histLast, DATA_SIZE) == 0)
+        return;
+
+    size_t len = histEncode(frame, rec);
+    // free room by folding the oldest records into the base frame
+    while (histCap - histLen < len)
+    {
+        size_t old = histApply(0, histBase);
+        histHead = (histHead + old) % histCap;
+        histLen -= old;
+        histCount--;
+        histFolded++;
+    }
+
+    for (size_t i = 0; i < len; i++)
+    {
+        histBuf[(histHead + histLen + i) % histCap] = rec[i];
+    }
+    histLen += len;
+    histCount++;
+    memcpy(histLast, frame, DATA_SIZE);
+}
+
+void CN91C4S96HistoryStart(uint8_t *buf, size_t size)
+{
+    if (!buf || size < HISTORY_RECORD_MAX)
+        return;
+
+    histBuf = buf;
+    histCap = size;
+    histHead = 0;
+    histLen = 0;
+    histCount = 0;
+    histFolded = 0;
+    memset(histBase, 0, sizeof(histBase));
+    memset(histLast, 0, sizeof(histLast));
+    commitAttach(histCommit);
+}
+
+void CN91C4S96HistoryStop(void)
+{
+    commitDetach(histCommit);
+}
+
+uint32_t CN91C4S96HistoryCount(void)
+{
+    return histCount;
+}
+
+size_t CN91C4S96HistoryDump(uint8_t *out, size_t size)
+{
+    size_t total = HISTORY_HEADER_SIZE + DATA_SIZE + histLen;
+
+    if (size < total)
+        return 0;
+
+    out[0] = HISTORY_MAGIC0;
+    out[1] = HISTORY_MAGIC1;
+    out[2] = HISTORY_MAGIC2;
+    out[3] = HISTORY_VERSION;
+    out[4] = (uint8_t)histFolded;
+    out[5] = (uint8_t)(histFolded >> 8);
+    out[6] = (uint8_t)(histFolded >> 16);
+    out[7] = (uint8_t)(histFolded >> 24);
+    memcpy(out + HISTORY_HEADER_SIZE, histBase, DATA_SIZE);
+    for (size_t i = 0; i < histLen; i++)
+    {
+        out[HISTORY_HEADER_SIZE + DATA_SIZE + i] = histAt(i);
+    }
+    return total;
+}
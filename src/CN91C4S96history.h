@@ -0,0 +1,64 @@
+/*******************************************************************************
+Frame history recorder for CN91C4S96 driver.
+
+Keeps the last committed frames (as sent to the display by CN91C4S96DispWrite
+and friends, with layers composed) in a caller-provided ring buffer. Every
+frame is stored as XOR against the previous one with zero runs skipped, so a
+changed digit costs 3 bytes. When the ring is full the oldest frames are
+folded into the base frame. Frames equal to the previous one are not stored.
+
+Record: tokens, every token is one byte skip:4 | count:4 followed by `count`
+XOR bytes, placed after `skip` unchanged bytes. Token 0x00 ends the record.
+
+Dump format (CN91C4S96HistoryDump, decoded by tools/history_main.c):
+    header: 'C' 'N' 'H' version folded[4]  - folded: frames merged into base, little endian
+    base[DATA_SIZE]                          - frame before the first record
+    records
+*******************************************************************************/
+
+#ifndef CN91C4S96HISTORY_H_
+#define CN91C4S96HISTORY_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define HISTORY_MAGIC0 'C'
+#define HISTORY_MAGIC1 'N'
+#define HISTORY_MAGIC2 'H'
+#define HISTORY_VERSION 1
+#define HISTORY_HEADER_SIZE 8
+#define HISTORY_FRAME_SIZE 16 // DATA_SIZE
+
+#define HISTORY_END 0x00
+#define HISTORY_TOKEN(SKIP, COUNT) ((uint8_t)(((SKIP) << 4) | (COUNT)))
+#define HISTORY_SKIP(TOKEN) ((TOKEN) >> 4)
+#define HISTORY_COUNT(TOKEN) ((TOKEN)&0x0f)
+#define HISTORY_RECORD_MAX (HISTORY_FRAME_SIZE + 3) // longest record: all bytes changed, two tokens and end
+
+/**
+     * @brief Start recording every frame written to the display. Mirror and trace started before
+     * or after keep getting frames
+     *
+     * @param buf - ring storage, at least HISTORY_RECORD_MAX bytes
+     * @param size - storage size
+     */
+void CN91C4S96HistoryStart(uint8_t *buf, size_t size);
+
+/**
+     * @brief Stop recording. Recorded frames are kept, mirror and trace are not affected
+     */
+void CN91C4S96HistoryStop(void);
+
+/**
+     * @brief Number of frames which can be rebuilt from the ring
+     */
+uint32_t CN91C4S96HistoryCount(void);
+
+/**
+     * @brief Copy history in dump format into `out`
+     *
+     * @return bytes written, 0 if `size` is too small
+     */
+size_t CN91C4S96HistoryDump(uint8_t *out, size_t size);
+
+#endif
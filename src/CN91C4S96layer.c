@@ -0,0 +1,101 @@
+/*******************************************************************************
+Layered frame composition for CN91C4S96 driver. See CN91C4S96layer.h
+*******************************************************************************/
+
+#include "CN91C4S96layer.h"
+#include "CN91C4S96.h"
+#include <string.h>
+
+#define OVERLAYS (CN91C4S96_LAYER_COUNT - 1) // layers above the base page
+#define DIGIT_FGE 0x70
+#define DIGIT_ABCD 0x0f
+
+typedef struct
+{
+    uint8_t frame[DATA_SIZE];
+    uint8_t own[DATA_SIZE];
+    bool shown;
+} Layer_st;
+
+extern uint8_t BufferSend[];
+extern uint8_t *Buffer;
+extern const uint8_t *(*CN91C4S96_compose)(const uint8_t *base);
+
+static Layer_st layers[OVERLAYS]; // in priority order, the last one is on top
+static uint8_t composed[DATA_SIZE];
+
+static Layer_st *layerGet(CN91C4S96_Layer_en layer)
+{
+    if (layer <= CN91C4S96_LAYER_BASE || layer >= CN91C4S96_LAYER_COUNT)
+        return NULL;
+    return &layers[layer - 1];
+}
+
+static const uint8_t *layerCompose(const uint8_t *base)
+{
+    memcpy(composed, base, DATA_SIZE);
+    for (uint8_t n = 0; n < OVERLAYS; n++)
+    {
+        const Layer_st *l = &layers[n];
+        if (!l->shown)
+            continue;
+        for (uint8_t i = 0; i < DATA_SIZE; i++)
+        {
+            composed[i] = (composed[i] & ~l->own[i]) | (l->frame[i] & l->own[i]);
+        }
+    }
+    return composed;
+}
+
+void CN91C4S96LayerSelect(CN91C4S96_Layer_en layer)
+{
+    Layer_st *l = layerGet(layer);
+    Buffer = l ? l->frame : BufferSend + SYS_SIZE;
+}
+
+void CN91C4S96LayerShow(CN91C4S96_Layer_en layer, bool show)
+{
+    Layer_st *l = layerGet(layer);
+    if (!l)
+        return;
+    l->shown = show;
+    CN91C4S96_compose = layerCompose;
+}
+
+void CN91C4S96LayerOwn(CN91C4S96_Layer_en layer, uint8_t pos, uint8_t mask)
+{
+    Layer_st *l = layerGet(layer);
+    if (!l || pos >= DATA_SIZE)
+        return;
+    l->own[pos] |= mask;
+}
+
+void CN91C4S96LayerOwnIcon(CN91C4S96_Layer_en layer, CN91C4S96_Icon_en icon)
+{
+    if (icon >= ICON_COUNT)
+        return;
+    CN91C4S96LayerOwn(layer, CN91C4S96Layout.icons[icon].pos, CN91C4S96Layout.icons[icon].seg);
+}
+
+void CN91C4S96LayerOwnDigits(CN91C4S96_Layer_en layer)
+{
+    for (uint8_t i = 0; i < DISPLAY_SIZE; i++)
+    {
+        CN91C4S96LayerOwn(layer, CN91C4S96Layout.digitFGE[i], DIGIT_FGE);
+        CN91C4S96LayerOwn(layer, CN91C4S96Layout.digitABCD[i], DIGIT_ABCD);
+    }
+    for (uint8_t p = 1; p <= CN91C4S96_LAYOUT_DOTS; p++)
+    {
+        CN91C4S96LayerOwn(layer, CN91C4S96Layout.dot[p].pos, CN91C4S96Layout.dot[p].seg);
+    }
+    CN91C4S96LayerOwn(layer, CN91C4S96Layout.minus.pos, CN91C4S96Layout.minus.seg);
+}
+
+void CN91C4S96LayerRelease(CN91C4S96_Layer_en layer)
+{
+    Layer_st *l = layerGet(layer);
+    if (!l)
+        return;
+    memset(l->frame, 0, sizeof(l->frame));
+    memset(l->own, 0, sizeof(l->own));
+}
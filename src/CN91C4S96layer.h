@@ -0,0 +1,71 @@
+/*******************************************************************************
+Layered frame composition for CN91C4S96 driver.
+
+The frame is composed of three layers, a higher one wins:
+
+    CN91C4S96_LAYER_BASE   - the usual Buffer: numbers, units, page content
+    CN91C4S96_LAYER_STATUS - battery, signal, radio and other status icons
+    CN91C4S96_LAYER_ALARM  - warnings which must stay visible over everything
+
+STATUS and ALARM have their own frame and a mask of owned bits. Only owned
+bits of a shown layer cover the layers below, all other bits come from
+below. Print, icon and animation functions draw into the selected layer,
+so every subsystem keeps its own bits and nobody overwrites them:
+
+    CN91C4S96LayerOwnIcon(CN91C4S96_LAYER_ALARM, ICON_WARN);
+    CN91C4S96LayerSelect(CN91C4S96_LAYER_ALARM);
+    CN91C4S96DispWarn(true);
+    CN91C4S96LayerSelect(CN91C4S96_LAYER_BASE);
+    CN91C4S96LayerShow(CN91C4S96_LAYER_ALARM, true);
+
+Layers are composed at CN91C4S96DispWrite with one AND-NOT and one OR per
+byte and layer, then only bytes which differ from display RAM are sent.
+Date and time keep their redraw cache for one frame, use them in one layer.
+*******************************************************************************/
+
+#ifndef CN91C4S96LAYER_H_
+#define CN91C4S96LAYER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "CN91C4S96layout.h"
+
+typedef enum
+{
+    CN91C4S96_LAYER_BASE = 0,
+    CN91C4S96_LAYER_STATUS,
+    CN91C4S96_LAYER_ALARM,
+    CN91C4S96_LAYER_COUNT
+} CN91C4S96_Layer_en;
+
+/*!
+    * \brief select layer for the following print, icon and animation calls
+    */
+void CN91C4S96LayerSelect(CN91C4S96_Layer_en layer);
+
+/*!
+    * \brief show or hide layer. Hidden layer keeps its content and owned bits
+    */
+void CN91C4S96LayerShow(CN91C4S96_Layer_en layer, bool show);
+
+/*!
+    * \brief add bits of one Buffer byte to the bits owned by layer
+    */
+void CN91C4S96LayerOwn(CN91C4S96_Layer_en layer, uint8_t pos, uint8_t mask);
+
+/*!
+    * \brief add icon of the selected glass to the bits owned by layer
+    */
+void CN91C4S96LayerOwnIcon(CN91C4S96_Layer_en layer, CN91C4S96_Icon_en icon);
+
+/*!
+    * \brief add all digits, dots and minus to the bits owned by layer, e.g. for an alarm text
+    */
+void CN91C4S96LayerOwnDigits(CN91C4S96_Layer_en layer);
+
+/*!
+    * \brief drop all owned bits and clear content of layer
+    */
+void CN91C4S96LayerRelease(CN91C4S96_Layer_en layer);
+
+#endif
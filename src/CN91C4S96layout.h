@@ -0,0 +1,125 @@
+/*******************************************************************************
+Glass layout profiles of the CN91C4S96 driver.
+
+Every glass variant has its own segment map: which frame bytes hold each
+digit, which bits are the dots, the minus and the icons. The map is written
+as text (see extras/pdc6x1.map) and converted by tools/layoutgen.py into a
+header with plain constants:
+
+    python3 tools/layoutgen.py extras/pdc6x1.map src/CN91C4S96layout_pdc6x1.h
+
+The header is chosen at compile time with CN91C4S96_LAYOUT_HEADER, for
+example -DCN91C4S96_LAYOUT_HEADER='"CN91C4S96layout_xyz.h"'. The driver
+keeps the profile in a const table and indexes it with
+constants, so the compiler folds icon positions into the same immediates as
+the old defines. Nothing is parsed at run time.
+
+Digit segments are split the same way on every glass: F, G, E are bits
+4..6 of one byte, A, B, C, D are bits 0..3 of another one.
+*******************************************************************************/
+
+#ifndef CN91C4S96LAYOUT_H_
+#define CN91C4S96LAYOUT_H_
+
+#include <stdint.h>
+
+#ifndef CN91C4S96_LAYOUT_HEADER
+#define CN91C4S96_LAYOUT_HEADER "CN91C4S96layout_pdc6x1.h"
+#endif
+#include CN91C4S96_LAYOUT_HEADER
+
+// all icons known to the driver. An icon which a glass doesn't have is {0, 0} in its profile
+#define CN91C4S96_ICONS(X) \
+    X(SN)                  \
+    X(WARN)                \
+    X(MAGNET)              \
+    X(LEFT)                \
+    X(RIGHT)               \
+    X(NOWATER)             \
+    X(CRC)                 \
+    X(DELTA)               \
+    X(T)                   \
+    X(T1)                  \
+    X(T2)                  \
+    X(NBFI)                \
+    X(NBIOT)               \
+    X(SIG1)                \
+    X(SIG2)                \
+    X(SIG3)                \
+    X(BAT1)                \
+    X(BAT2)                \
+    X(BAT3)                \
+    X(BAT4)                \
+    X(SP_RU)               \
+    X(SP_EN)               \
+    X(RP_RU)               \
+    X(RP_EN)               \
+    X(DEGREE)              \
+    X(GCAL)                \
+    X(GCAL_H)              \
+    X(GJ)                  \
+    X(GJ_H)                \
+    X(KW)                  \
+    X(MW)                  \
+    X(W)                   \
+    X(WH)                  \
+    X(GAL)                 \
+    X(GAL_PM)              \
+    X(M3)                  \
+    X(M3_H)                \
+    X(M3_H_EN)             \
+    X(FT3)                 \
+    X(FT3_PM)              \
+    X(MMBTU)               \
+    X(GALLONS)             \
+    X(US)                  \
+    X(MIN_RU)              \
+    X(MAX_RU)              \
+    X(MIN_EN)              \
+    X(MAX_EN)              \
+    X(BURST_RU)            \
+    X(BURST_EN)            \
+    X(LEAK_RU)             \
+    X(LEAK_EN)             \
+    X(REV_RU)              \
+    X(REV_EN)              \
+    X(FROST)               \
+    X(Q)                   \
+    X(VER_RU)              \
+    X(VER_EN)              \
+    X(POV)
+
+#define CN91C4S96_ICON_ENUM(NAME) ICON_##NAME,
+
+typedef enum
+{
+    CN91C4S96_ICONS(CN91C4S96_ICON_ENUM)
+    ICON_COUNT
+} CN91C4S96_Icon_en;
+
+typedef struct
+{
+    uint8_t pos; // frame byte
+    uint8_t seg; // bit mask in the byte, 0 if glass has no such segment
+} CN91C4S96_Seg_st;
+
+typedef struct
+{
+    uint8_t digitFGE[CN91C4S96_LAYOUT_DIGITS];       // byte with F, G, E of each digit, leftmost digit first
+    uint8_t digitABCD[CN91C4S96_LAYOUT_DIGITS];      // byte with A, B, C, D of each digit
+    CN91C4S96_Seg_st dot[CN91C4S96_LAYOUT_DOTS + 1]; // dot[p] separates the last p digits, dot[0] is unused
+    CN91C4S96_Seg_st minus;                          // minus in front of the whole digit row
+    CN91C4S96_Seg_st icons[ICON_COUNT];
+} CN91C4S96_Layout_st;
+
+#define CN91C4S96_ICON_INIT(NAME) {CN91C4S96_LAYOUT_ICON_##NAME},
+
+// initializer of CN91C4S96_Layout_st for the selected glass
+#define CN91C4S96_LAYOUT_INIT                                                                                 \
+    {CN91C4S96_LAYOUT_DIGIT_FGE, CN91C4S96_LAYOUT_DIGIT_ABCD, CN91C4S96_LAYOUT_DOT, {CN91C4S96_LAYOUT_MINUS}, \
+     {CN91C4S96_ICONS(CN91C4S96_ICON_INIT)}}
+
+// profile of the selected glass, defined in CN91C4S96.c
+extern const CN91C4S96_Layout_st CN91C4S96Layout;
+
+#endif
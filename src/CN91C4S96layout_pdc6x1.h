@@ -0,0 +1,81 @@
+/*******************************************************************************
+pdc6x1 glass layout profile, see CN91C4S96layout.h
+
+Generated by tools/layoutgen.py from pdc6x1.map, don't edit.
+*******************************************************************************/
+
+#ifndef CN91C4S96LAYOUT_PDC6X1_H_
+#define CN91C4S96LAYOUT_PDC6X1_H_
+
+#define CN91C4S96_LAYOUT_NAME "pdc6x1"
+#define CN91C4S96_LAYOUT_DIGITS 9
+#define CN91C4S96_LAYOUT_DOTS 5
+#define CN91C4S96_LAYOUT_MAX_NUM 999999999
+
+#define CN91C4S96_LAYOUT_DIGIT_FGE {14, 13, 12, 11, 10, 9, 8, 7, 6}
+#define CN91C4S96_LAYOUT_DIGIT_ABCD {13, 12, 11, 10, 9, 8, 7, 6, 5}
+#define CN91C4S96_LAYOUT_DOT {{0, 0x00}, {6, 0x80}, {7, 0x80}, {8, 0x80}, {9, 0x80}, {10, 0x80}}
+#define CN91C4S96_LAYOUT_MINUS 13, 0x80
+// digit and dot bits of every byte, the part of the frame written by text
+#define CN91C4S96_LAYOUT_TEXT_MASK {0x00, 0x00, 0x00, 0x00, 0x00, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7f, 0x7f, 0x7f, 0x70, 0x00}
+
+#define CN91C4S96_LAYOUT_ICON_SN 0, 0x40
+#define CN91C4S96_LAYOUT_ICON_WARN 0, 0x80
+#define CN91C4S96_LAYOUT_ICON_MAGNET 0, 0x08
+#define CN91C4S96_LAYOUT_ICON_LEFT 1, 0x80
+#define CN91C4S96_LAYOUT_ICON_RIGHT 2, 0x80
+#define CN91C4S96_LAYOUT_ICON_NOWATER 1, 0x08
+#define CN91C4S96_LAYOUT_ICON_CRC 0, 0x20
+#define CN91C4S96_LAYOUT_ICON_DELTA 0, 0x10
+#define CN91C4S96_LAYOUT_ICON_T 0, 0x02
+#define CN91C4S96_LAYOUT_ICON_T1 0, 0x04
+#define CN91C4S96_LAYOUT_ICON_T2 1, 0x40
+#define CN91C4S96_LAYOUT_ICON_NBFI 2, 0x08
+#define CN91C4S96_LAYOUT_ICON_NBIOT 3, 0x80
+#define CN91C4S96_LAYOUT_ICON_SIG1 2, 0x40
+#define CN91C4S96_LAYOUT_ICON_SIG2 2, 0x04
+#define CN91C4S96_LAYOUT_ICON_SIG3 3, 0x40
+#define CN91C4S96_LAYOUT_ICON_BAT1 3, 0x10
+#define CN91C4S96_LAYOUT_ICON_BAT2 2, 0x01
+#define CN91C4S96_LAYOUT_ICON_BAT3 2, 0x02
+#define CN91C4S96_LAYOUT_ICON_BAT4 3, 0x20
+#define CN91C4S96_LAYOUT_ICON_SP_RU 4, 0x80
+#define CN91C4S96_LAYOUT_ICON_SP_EN 3, 0x10
+#define CN91C4S96_LAYOUT_ICON_RP_RU 4, 0x40
+#define CN91C4S96_LAYOUT_ICON_RP_EN 3, 0x20
+#define CN91C4S96_LAYOUT_ICON_DEGREE 1, 0x20
+#define CN91C4S96_LAYOUT_ICON_GCAL 3, 0x02
+#define CN91C4S96_LAYOUT_ICON_GCAL_H 4, 0x20
+#define CN91C4S96_LAYOUT_ICON_GJ 1, 0x10
+#define CN91C4S96_LAYOUT_ICON_GJ_H 3, 0x01
+#define CN91C4S96_LAYOUT_ICON_KW 5, 0x10
+#define CN91C4S96_LAYOUT_ICON_MW 5, 0x20
+#define CN91C4S96_LAYOUT_ICON_W 4, 0x10
+#define CN91C4S96_LAYOUT_ICON_WH 4, 0x01
+#define CN91C4S96_LAYOUT_ICON_GAL 5, 0x40
+#define CN91C4S96_LAYOUT_ICON_GAL_PM 4, 0x02
+#define CN91C4S96_LAYOUT_ICON_M3 5, 0x80
+#define CN91C4S96_LAYOUT_ICON_M3_H 4, 0x04
+#define CN91C4S96_LAYOUT_ICON_M3_H_EN 4, 0x08
+#define CN91C4S96_LAYOUT_ICON_FT3 1, 0x02
+#define CN91C4S96_LAYOUT_ICON_FT3_PM 1, 0x01
+#define CN91C4S96_LAYOUT_ICON_MMBTU 1, 0x04
+#define CN91C4S96_LAYOUT_ICON_GALLONS 2, 0x10
+#define CN91C4S96_LAYOUT_ICON_US 2, 0x20
+#define CN91C4S96_LAYOUT_ICON_MIN_RU 12, 0x80
+#define CN91C4S96_LAYOUT_ICON_MAX_RU 14, 0x08
+#define CN91C4S96_LAYOUT_ICON_MIN_EN 11, 0x80
+#define CN91C4S96_LAYOUT_ICON_MAX_EN 14, 0x80
+#define CN91C4S96_LAYOUT_ICON_BURST_RU 15, 0x08
+#define CN91C4S96_LAYOUT_ICON_BURST_EN 15, 0x40
+#define CN91C4S96_LAYOUT_ICON_LEAK_RU 15, 0x20
+#define CN91C4S96_LAYOUT_ICON_LEAK_EN 15, 0x04
+#define CN91C4S96_LAYOUT_ICON_REV_RU 15, 0x02
+#define CN91C4S96_LAYOUT_ICON_REV_EN 15, 0x01
+#define CN91C4S96_LAYOUT_ICON_FROST 15, 0x80
+#define CN91C4S96_LAYOUT_ICON_Q 14, 0x04
+#define CN91C4S96_LAYOUT_ICON_VER_RU 14, 0x01
+#define CN91C4S96_LAYOUT_ICON_VER_EN 14, 0x02
+#define CN91C4S96_LAYOUT_ICON_POV 15, 0x10
+
+#endif
@@ -0,0 +1,105 @@
+/*******************************************************************************
+Remote mirroring stream encoder for CN91C4S96 driver. See CN91C4S96mirror.h
+*******************************************************************************/
+
+#include "CN91C4S96mirror.h"
+#include "CN91C4S96.h"
+#include <string.h>
+
+#if MIRROR_FRAME_SIZE != DATA_SIZE
+#error "MIRROR_FRAME_SIZE must be DATA_SIZE"
+#endif
+
+#define MASK_BYTES 2
+
+extern uint8_t BufferSendOld[];
+// see CN91C4S96.c
+void commitAttach(void (*hook)(const uint8_t *frame));
+void commitDetach(void (*hook)(const uint8_t *frame));
+
+static void (*mirrorEmit)(const uint8_t *msg, size_t len) = NULL;
+static uint16_t mirrorKeyEvery = 0;
+static uint16_t mirrorDeltas = 0;
+static uint8_t mirrorSeq = 0;
+static bool mirrorKeyNeeded = true;
+static uint8_t mirrorLast[DATA_SIZE]; // frame the receiver has
+
+static void mirrorSend(const uint8_t *frame)
+{
+    uint8_t msg[MIRROR_MSG_MAX];
+    uint16_t mask = 0;
+    uint8_t changed = 0;
+    size_t len = 1;
+
+    for (uint8_t i = 0; i < DATA_SIZE; i++)
+    {
+        if (frame[i] != mirrorLast[i])
+        {
+            mask |= 1 << i;
+            changed++;
+        }
+    }
+    if (changed == 0 && !mirrorKeyNeeded)
+        return;
+
+    msg[0] = mirrorSeq & MIRROR_SEQ;
+    // delta which isn't shorter than keyframe is sent as keyframe
+    if (mirrorKeyNeeded || MASK_BYTES + changed >= DATA_SIZE)
+    {
+        msg[0] |= MIRROR_KEY;
+        memcpy(msg + 1, frame, DATA_SIZE);
+        len += DATA_SIZE;
+        mirrorKeyNeeded = false;
+        mirrorDeltas = 0;
+    }
+    else
+    {
+        // pairs cost 2 bytes per change, mask form MASK_BYTES + 1 per change
+        bool pairs = 2 * changed <= MASK_BYTES + changed;
+        if (!pairs)
+        {
+            msg[0] |= MIRROR_MASK;
+            msg[len++] = (uint8_t)mask;
+            msg[len++] = (uint8_t)(mask >> 8);
+        }
+        for (uint8_t i = 0; i < DATA_SIZE; i++)
+        {
+            if (!(mask & (1 << i)))
+                continue;
+            if (pairs)
+                msg[len++] = i;
+            msg[len++] = frame[i];
+        }
+        if (mirrorKeyEvery && ++mirrorDeltas >= mirrorKeyEvery)
+            mirrorKeyNeeded = true;
+    }
+
+    mirrorEmit(msg, len);
+    mirrorSeq++;
+    memcpy(mirrorLast, frame, DATA_SIZE);
+}
+
+void CN91C4S96MirrorStart(void (*emit)(const uint8_t *msg, size_t len), uint16_t keyEvery)
+{
+    if (!emit)
+        return;
+
+    mirrorEmit = emit;
+    mirrorKeyEvery = keyEvery;
+    mirrorKeyNeeded = true;
+    mirrorSeq = 0;
+    commitAttach(mirrorSend);
+}
+
+void CN91C4S96MirrorStop(void)
+{
+    commitDetach(mirrorSend);
+    mirrorEmit = NULL;
+}
+
+void CN91C4S96MirrorKeyframe(void)
+{
+    mirrorKeyNeeded = true;
+    if (mirrorEmit)
+        mirrorSend(BufferSendOld + SYS_SIZE); // frame which is on the display now
+}
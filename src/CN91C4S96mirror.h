@@ -0,0 +1,50 @@
+/*******************************************************************************
+Remote mirroring stream encoder for CN91C4S96 driver.
+
+Emits a message for every frame sent to the display which differs from the
+previous one, so a server can show the same picture. Messages are given to
+the caller's emit function, which puts them into telemetry packets; message
+length must be kept by the transport.
+
+Message: header byte, then
+    keyframe:  DATA_SIZE frame bytes
+    pairs:     index, value - for every changed byte
+    mask:      changed byte bitmask[2] (bit n - byte n, little endian), values
+header: bit 7 - keyframe, bit 6 - mask form, bits 5..0 - sequence number.
+The shorter of pairs and mask form is used: one changed byte costs 3 bytes.
+A receiver which sees a sequence gap ignores deltas until the next keyframe.
+
+Host decoder: tools/mirror_main.c
+*******************************************************************************/
+
+#ifndef CN91C4S96MIRROR_H_
+#define CN91C4S96MIRROR_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define MIRROR_FRAME_SIZE 16 // DATA_SIZE
+#define MIRROR_KEY 0x80
+#define MIRROR_MASK 0x40
+#define MIRROR_SEQ 0x3f
+#define MIRROR_MSG_MAX (1 + MIRROR_FRAME_SIZE)
+
+/**
+     * @brief Start mirroring. The first frame is sent as keyframe
+     *
+     * @param emit - gets every message, called from CN91C4S96DispWrite
+     * @param keyEvery - send a keyframe after this many deltas. 0 - only on request
+     */
+void CN91C4S96MirrorStart(void (*emit)(const uint8_t *msg, size_t len), uint16_t keyEvery);
+
+/**
+     * @brief Stop mirroring. History and trace started after or before keep getting frames
+     */
+void CN91C4S96MirrorStop(void);
+
+/**
+     * @brief Send the current frame as keyframe now, e.g. when server asks for it
+     */
+void CN91C4S96MirrorKeyframe(void);
+
+#endif
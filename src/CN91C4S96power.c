@@ -0,0 +1,113 @@
+/*******************************************************************************
+Idle power policy for CN91C4S96 driver. See CN91C4S96power.h
+*******************************************************************************/
+
+#include "CN91C4S96power.h"
+#include "CN91C4S96.h"
+
+#define STAGE_BIT(STAGE) (1 << (STAGE))
+#define SAVE_STATE_MASK 0x0f // CN91C4S96PowerSave: stage in low nibble, STAGE_BIT of applied stages in high one
+#define SAVE_APPLIED_SHIFT 4
+
+extern CN91C4S96_Backend_st *CN91C4S96_backend;
+
+// commands which enter DIM, OFF and SLEEP
+static const CN91C4S96_Ctrl_en stageCmd[] = {CTRL_LOW_POWER, CTRL_ALL_OFF, CTRL_DISABLE};
+
+static CN91C4S96PowerCfg_st powerCfg = {0, 0, 0};
+static CN91C4S96_Power_en powerState = CN91C4S96_POWER_ACTIVE;
+static uint8_t powerApplied = 0; // STAGE_BIT of stages whose command was accepted by backend
+static uint32_t lastActivity = 0;
+
+// drive mode of ACTIVE. Full power only when a DIM stage saves current later, else the low power mode
+// CTRL_INIT starts CN91C4S96 in
+static CN91C4S96_Ctrl_en activeCmd(void)
+{
+    return powerCfg.dimTicks ? CTRL_FULL_POWER : CTRL_LOW_POWER;
+}
+
+static uint32_t stageTicks(CN91C4S96_Power_en stage)
+{
+    switch (stage)
+    {
+    case CN91C4S96_POWER_DIM:
+        return powerCfg.dimTicks;
+    case CN91C4S96_POWER_OFF:
+        return powerCfg.offTicks;
+    case CN91C4S96_POWER_SLEEP:
+        return powerCfg.sleepTicks;
+    default:
+        return 0;
+    }
+}
+
+void CN91C4S96PowerInit(const CN91C4S96PowerCfg_st *cfg, uint32_t now)
+{
+    powerCfg = *cfg;
+    powerState = CN91C4S96_POWER_ACTIVE;
+    powerApplied = 0;
+    lastActivity = now;
+    CN91C4S96_backend->Command(activeCmd());
+}
+
+void CN91C4S96PowerActivity(uint32_t now)
+{
+    lastActivity = now;
+    if (powerState == CN91C4S96_POWER_ACTIVE)
+        return;
+
+    // undo in reverse order, only what was sent
+    if (powerApplied & STAGE_BIT(CN91C4S96_POWER_SLEEP))
+    {
+        // drive mode commands enable controller too, full init only where there is no such command
+        if (!CN91C4S96_backend->Command(activeCmd()))
+            CN91C4S96_backend->Command(CTRL_INIT);
+    }
+    else if (powerApplied & STAGE_BIT(CN91C4S96_POWER_DIM))
+    {
+        CN91C4S96_backend->Command(CTRL_FULL_POWER);
+    }
+    if (powerApplied & STAGE_BIT(CN91C4S96_POWER_OFF))
+        CN91C4S96_backend->Command(CTRL_SHOW_DATA);
+
+    powerState = CN91C4S96_POWER_ACTIVE;
+    powerApplied = 0;
+}
+
+CN91C4S96_Power_en CN91C4S96PowerTick(uint32_t now)
+{
+    uint32_t idle = now - lastActivity;
+
+    for (uint8_t stage = powerState + 1; stage <= CN91C4S96_POWER_SLEEP; stage++)
+    {
+        uint32_t ticks = stageTicks(stage);
+        if (ticks == 0)
+            continue;
+        if (idle < ticks)
+            break;
+        if (CN91C4S96_backend->Command(stageCmd[stage - 1]))
+            powerApplied |= STAGE_BIT(stage);
+        powerState = stage;
+    }
+    return powerState;
+}
+
+CN91C4S96_Power_en CN91C4S96PowerState(void)
+{
+    return powerState;
+}
+
+uint8_t CN91C4S96PowerSave(void)
+{
+    return (uint8_t)(powerState | (powerApplied << SAVE_APPLIED_SHIFT));
+}
+
+void CN91C4S96PowerResume(const CN91C4S96PowerCfg_st *cfg, uint32_t now, uint8_t saved)
+{
+    uint8_t state = saved & SAVE_STATE_MASK;
+
+    powerCfg = *cfg;
+    powerState = (state <= CN91C4S96_POWER_SLEEP) ? state : CN91C4S96_POWER_ACTIVE;
+    powerApplied = (powerState == CN91C4S96_POWER_ACTIVE) ? 0 : saved >> SAVE_APPLIED_SHIFT;
+    lastActivity = now;
+}
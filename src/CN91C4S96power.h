@@ -0,0 +1,81 @@
+/*******************************************************************************
+Idle power policy for CN91C4S96 driver.
+
+After the last activity (button press, new data to show) the display goes
+through stages, every stage after its own idle time:
+
+    ACTIVE - drive mode of CTRL_INIT, low power on CN91C4S96. Full drive power
+             if a DIM stage is configured, which costs current while active
+    DIM    - low power drive, segments stay visible
+    OFF    - all segments off, controller keeps running
+    SLEEP  - controller disabled
+
+A stage with zero time is skipped, as well as a stage which the backend has
+no command for. Activity wakes the display by undoing only the commands which
+were sent. Nothing else is sent: display RAM is kept while dark, SLEEP (see
+CTRL_DISABLE) included, so the frame is neither formatted nor written again.
+
+Print functions and CN91C4S96DispWrite may be used in any stage, the frame
+written last appears on wake. Time is given by the caller in any ticks.
+*******************************************************************************/
+
+#ifndef CN91C4S96POWER_H_
+#define CN91C4S96POWER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum
+{
+    CN91C4S96_POWER_ACTIVE = 0,
+    CN91C4S96_POWER_DIM,
+    CN91C4S96_POWER_OFF,
+    CN91C4S96_POWER_SLEEP,
+} CN91C4S96_Power_en;
+
+typedef struct
+{
+    uint32_t dimTicks;   // idle time before low power drive. 0 - stage is not used, ACTIVE stays in low power
+    uint32_t offTicks;   // idle time before segments off. 0 - stage is not used
+    uint32_t sleepTicks; // idle time before controller disable. 0 - stage is not used
+} CN91C4S96PowerCfg_st;
+
+/*!
+    * \brief start policy: display goes to the ACTIVE drive mode, idle time starts from `now`.
+    * Without a DIM stage it is the low power mode of CTRL_INIT, the controller never leaves it
+    *
+    * \param cfg idle times, copied
+    */
+void CN91C4S96PowerInit(const CN91C4S96PowerCfg_st *cfg, uint32_t now);
+
+/*!
+    * \brief activity: wake display if it is dimmed or dark and start idle time again
+    */
+void CN91C4S96PowerActivity(uint32_t now);
+
+/*!
+    * \brief go to the next stages when their idle time is over. Call it periodically
+    *
+    * \return stage after the call
+    */
+CN91C4S96_Power_en CN91C4S96PowerTick(uint32_t now);
+
+/*!
+    * \brief current stage
+    */
+CN91C4S96_Power_en CN91C4S96PowerState(void);
+
+/*!
+    * \brief stage and sent commands, to be kept over MCU standby together with the CN91C4S96Save block
+    */
+uint8_t CN91C4S96PowerSave(void);
+
+/*!
+    * \brief start policy after MCU standby instead of CN91C4S96PowerInit. Nothing is sent,
+    * the display stays in the saved stage until activity or the next stage
+    *
+    * \param saved value of CN91C4S96PowerSave
+    */
+void CN91C4S96PowerResume(const CN91C4S96PowerCfg_st *cfg, uint32_t now, uint8_t saved);
+
+#endif
@@ -0,0 +1,165 @@
+/*******************************************************************************
+RTOS adapter for CN91C4S96 driver. See CN91C4S96rtos.h
+*******************************************************************************/
+
+#include "CN91C4S96rtos.h"
+#include "CN91C4S96.h"
+
+typedef struct
+{
+    int32_t value;
+    uint8_t precision;
+    bool pending;
+} Field_st;
+
+extern uint8_t *Buffer;
+// set decimal separator, see CN91C4S96.c
+void decimalSeparator(uint8_t dpPosition);
+
+static CN91C4S96Queue_st *queues = NULL;
+static void (*rtosNotify)(void) = NULL;
+
+// latest values of this pass, rendered once
+static Field_st fields[CN91C4S96_FIELD_COUNT];
+static int16_t pendingBattery = -1;
+static int16_t pendingSignal = -1;
+
+void CN91C4S96QueueInit(CN91C4S96Queue_st *q, CN91C4S96Msg_st *items, uint8_t size)
+{
+    q->items = items;
+    q->size = size;
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    q->next = NULL;
+}
+
+void CN91C4S96QueueAttach(CN91C4S96Queue_st *q)
+{
+    q->next = queues;
+    queues = q;
+}
+
+void CN91C4S96RtosNotify(void (*notify)(void))
+{
+    rtosNotify = notify;
+}
+
+bool CN91C4S96Post(CN91C4S96Queue_st *q, const CN91C4S96Msg_st *msg)
+{
+    uint_fast8_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    uint_fast8_t next = (head + 1 == q->size) ? 0 : head + 1;
+
+    if (next == atomic_load_explicit(&q->tail, memory_order_acquire))
+        return false;
+
+    q->items[head] = *msg;
+    // message is complete before display task sees the new head
+    atomic_store_explicit(&q->head, next, memory_order_release);
+
+    if (rtosNotify)
+        rtosNotify();
+    return true;
+}
+
+bool CN91C4S96PostNum(CN91C4S96Queue_st *q, CN91C4S96_Field_en field, int32_t value, uint8_t precision)
+{
+    CN91C4S96Msg_st msg = {CN91C4S96_MSG_NUM, field, precision, value};
+    return CN91C4S96Post(q, &msg);
+}
+
+bool CN91C4S96PostIcon(CN91C4S96Queue_st *q, CN91C4S96_Icon_en icon, bool on)
+{
+    CN91C4S96Msg_st msg = {CN91C4S96_MSG_ICON, icon, on, 0};
+    return CN91C4S96Post(q, &msg);
+}
+
+bool CN91C4S96PostMask(CN91C4S96Queue_st *q, uint8_t pos, uint8_t mask, uint8_t bits)
+{
+    CN91C4S96Msg_st msg = {CN91C4S96_MSG_MASK, pos, mask, bits};
+    return CN91C4S96Post(q, &msg);
+}
+
+bool CN91C4S96PostBattery(CN91C4S96Queue_st *q, uint8_t percents)
+{
+    CN91C4S96Msg_st msg = {CN91C4S96_MSG_BATTERY, 0, 0, percents};
+    return CN91C4S96Post(q, &msg);
+}
+
+bool CN91C4S96PostSignal(CN91C4S96Queue_st *q, uint8_t percents)
+{
+    CN91C4S96Msg_st msg = {CN91C4S96_MSG_SIGNAL, 0, 0, percents};
+    return CN91C4S96Post(q, &msg);
+}
+
+static void msgApply(const CN91C4S96Msg_st *msg)
+{
+    switch (msg->type)
+    {
+    case CN91C4S96_MSG_NUM:
+        if (msg->id < CN91C4S96_FIELD_COUNT)
+        {
+            fields[msg->id].value = msg->value;
+            fields[msg->id].precision = msg->arg;
+            fields[msg->id].pending = true;
+        }
+        break;
+    case CN91C4S96_MSG_ICON:
+        if (msg->id < ICON_COUNT)
+        {
+            const CN91C4S96_Seg_st *icon = &CN91C4S96Layout.icons[msg->id];
+            Buffer[icon->pos] = msg->arg ? (Buffer[icon->pos] | icon->seg) : (Buffer[icon->pos] & ~icon->seg);
+        }
+        break;
+    case CN91C4S96_MSG_MASK:
+        if (msg->id < DATA_SIZE)
+            Buffer[msg->id] = (Buffer[msg->id] & ~msg->arg) | ((uint8_t)msg->value & msg->arg);
+        break;
+    case CN91C4S96_MSG_BATTERY:
+        pendingBattery = (uint8_t)msg->value;
+        break;
+    case CN91C4S96_MSG_SIGNAL:
+        pendingSignal = (uint8_t)msg->value;
+        break;
+    }
+}
+
+bool CN91C4S96DisplayProcess(void)
+{
+    bool applied = false;
+
+    for (CN91C4S96Queue_st *q = queues; q; q = q->next)
+    {
+        uint_fast8_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+        uint_fast8_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+
+        while (tail != head)
+        {
+            msgApply(&q->items[tail]);
+            tail = (tail + 1 == q->size) ? 0 : tail + 1;
+            applied = true;
+        }
+        // slots are free for the producer only after they are read
+        atomic_store_explicit(&q->tail, tail, memory_order_release);
+    }
+
+    if (!applied)
+        return false;
+
+    for (uint8_t i = 0; i < CN91C4S96_FIELD_COUNT; i++)
+    {
+        if (!fields[i].pending)
+            continue;
+        CN91C4S96printNum(fields[i].value, fields[i].precision);
+        decimalSeparator(fields[i].precision);
+        fields[i].pending = false;
+    }
+    if (pendingBattery >= 0)
+        CN91C4S96batteryLevel((uint8_t)pendingBattery);
+    if (pendingSignal >= 0)
+        CN91C4S96SignalLevel((uint8_t)pendingSignal);
+    pendingBattery = -1;
+    pendingSignal = -1;
+
+    CN91C4S96DispWrite();
+    return true;
+}
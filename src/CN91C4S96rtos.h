@@ -0,0 +1,108 @@
+/*******************************************************************************
+RTOS adapter for CN91C4S96 driver.
+
+Only one task, the display task, calls the driver. Other tasks and ISRs post
+compact update messages into their own queues and never block: a queue has
+one producer and one consumer, so it needs only atomic loads and stores, no
+locks and no compare-and-swap (works on Cortex-M0 as well).
+
+The display task drains all queues, merges the messages (only the last
+number of a field is rendered) and sends the changed bytes in one write.
+The I2C bus and its WaitI2C are used by the display task only.
+
+    static CN91C4S96Msg_st meterItems[8];
+    static CN91C4S96Queue_st meterQueue;
+
+    CN91C4S96QueueInit(&meterQueue, meterItems, 8);  // before tasks start
+    CN91C4S96QueueAttach(&meterQueue);
+    CN91C4S96RtosNotify(displayWake);                // e.g. xTaskNotifyGive(displayTask)
+
+    // meter task
+    CN91C4S96PostNum(&meterQueue, CN91C4S96_FIELD_MAIN, volume, 3);
+
+    // display task
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        CN91C4S96DisplayProcess();
+    }
+*******************************************************************************/
+
+#ifndef CN91C4S96RTOS_H_
+#define CN91C4S96RTOS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "CN91C4S96atomic.h"
+#include "CN91C4S96layout.h"
+
+typedef enum
+{
+    CN91C4S96_MSG_NUM = 0, // value with `arg` digits after the dot into field `id`
+    CN91C4S96_MSG_ICON,    // icon `id` (CN91C4S96_Icon_en) on if `arg` is not 0
+    CN91C4S96_MSG_MASK,    // Buffer byte `id`: bits `arg` are set to `value`
+    CN91C4S96_MSG_BATTERY, // battery level in percents
+    CN91C4S96_MSG_SIGNAL,  // signal level in percents
+} CN91C4S96_Msg_en;
+
+typedef enum
+{
+    CN91C4S96_FIELD_MAIN = 0, // whole digit row
+    CN91C4S96_FIELD_COUNT
+} CN91C4S96_Field_en;
+
+typedef struct
+{
+    uint8_t type; // CN91C4S96_Msg_en
+    uint8_t id;
+    uint8_t arg;
+    int32_t value;
+} CN91C4S96Msg_st;
+
+typedef struct CN91C4S96Queue_st
+{
+    CN91C4S96Msg_st *items;
+    uint8_t size;
+    CN91C4S96_atomic_u8 head; // written by producer
+    CN91C4S96_atomic_u8 tail; // written by display task
+    struct CN91C4S96Queue_st *next;
+} CN91C4S96Queue_st;
+
+/*!
+    * \brief init queue of one producer
+    *
+    * \param items storage, holds size - 1 messages
+    */
+void CN91C4S96QueueInit(CN91C4S96Queue_st *q, CN91C4S96Msg_st *items, uint8_t size);
+
+/*!
+    * \brief add queue to the ones drained by display task. Call before the producer and display tasks start
+    */
+void CN91C4S96QueueAttach(CN91C4S96Queue_st *q);
+
+/*!
+    * \brief function called after every post, e.g. to notify display task. Must not block
+    */
+void CN91C4S96RtosNotify(void (*notify)(void));
+
+/*!
+    * \brief post message from the producer of queue. Never blocks
+    *
+    * \return false if queue is full, message is dropped
+    */
+bool CN91C4S96Post(CN91C4S96Queue_st *q, const CN91C4S96Msg_st *msg);
+
+bool CN91C4S96PostNum(CN91C4S96Queue_st *q, CN91C4S96_Field_en field, int32_t value, uint8_t precision);
+bool CN91C4S96PostIcon(CN91C4S96Queue_st *q, CN91C4S96_Icon_en icon, bool on);
+bool CN91C4S96PostMask(CN91C4S96Queue_st *q, uint8_t pos, uint8_t mask, uint8_t bits);
+bool CN91C4S96PostBattery(CN91C4S96Queue_st *q, uint8_t percents);
+bool CN91C4S96PostSignal(CN91C4S96Queue_st *q, uint8_t percents);
+
+/*!
+    * \brief display task: apply all posted messages and write changed bytes to display
+    *
+    * \return true if any message was applied
+    */
+bool CN91C4S96DisplayProcess(void);
+
+#endif
@@ -0,0 +1,148 @@
+/*******************************************************************************
+Segment self-test for CN91C4S96 driver. See CN91C4S96selftest.h
+*******************************************************************************/
+
+#include "CN91C4S96selftest.h"
+#include "CN91C4S96.h"
+#include <string.h>
+
+#define BITS_PER_BYTE 8
+#define SEGMENT_NONE (-1)
+#define DIGIT_FGE_SEGS 0x70
+#define DIGIT_ABCD_SEGS 0x0f
+
+extern CN91C4S96_Backend_st *CN91C4S96_backend;
+// frame which was sent last, see CN91C4S96.c
+extern uint8_t BufferSendOld[DISPLAY_BUFFER_SIZE];
+
+static CN91C4S96_Test_en testPhase = CN91C4S96_TEST_IDLE;
+static uint8_t testMask[DATA_SIZE];
+static uint8_t testRam[DATA_SIZE]; // what display RAM holds now
+static bool testDark = false;      // LCDON/LCDOFF command is active, RAM is not shown
+static int16_t testSegment = SEGMENT_NONE;
+
+// segments which the glass has, from the layout profile
+static void glassMask(uint8_t *mask)
+{
+    memset(mask, 0, DATA_SIZE);
+    for (uint8_t i = 0; i < DISPLAY_SIZE; i++)
+    {
+        mask[CN91C4S96Layout.digitFGE[i]] |= DIGIT_FGE_SEGS;
+        mask[CN91C4S96Layout.digitABCD[i]] |= DIGIT_ABCD_SEGS;
+    }
+    for (uint8_t i = 1; i <= CN91C4S96_LAYOUT_DOTS; i++)
+    {
+        mask[CN91C4S96Layout.dot[i].pos] |= CN91C4S96Layout.dot[i].seg;
+    }
+    mask[CN91C4S96Layout.minus.pos] |= CN91C4S96Layout.minus.seg;
+    for (uint8_t i = 0; i < ICON_COUNT; i++)
+    {
+        mask[CN91C4S96Layout.icons[i].pos] |= CN91C4S96Layout.icons[i].seg;
+    }
+}
+
+// send only the bytes of RAM which differ from frame
+static void ramWrite(const uint8_t *frame)
+{
+    CN91C4S96_backend->Flush(frame, testRam);
+    memcpy(testRam, frame, DATA_SIZE);
+}
+
+// all segments on or off by command, or by RAM content where there is no command
+static void allSegments(CN91C4S96_Ctrl_en cmd, uint8_t fill)
+{
+    uint8_t frame[DATA_SIZE];
+
+    if (CN91C4S96_backend->Command(cmd))
+    {
+        testDark = true;
+        return;
+    }
+    memset(frame, fill, DATA_SIZE);
+    ramWrite(frame);
+    if (testDark)
+    {
+        CN91C4S96_backend->Command(CTRL_SHOW_DATA);
+        testDark = false;
+    }
+}
+
+// light the next bit of mask after the current one. Returns false after the last one
+static bool walkNext(void)
+{
+    uint8_t frame[DATA_SIZE] = {0};
+
+    for (int16_t bit = testSegment + 1; bit < DATA_SIZE * BITS_PER_BYTE; bit++)
+    {
+        uint8_t pos = bit / BITS_PER_BYTE;
+        uint8_t seg = 0x80 >> (bit % BITS_PER_BYTE);
+
+        if (!(testMask[pos] & seg))
+            continue;
+        frame[pos] = seg;
+        // written while RAM is not shown, then the one segment appears alone
+        ramWrite(frame);
+        if (testDark)
+        {
+            CN91C4S96_backend->Command(CTRL_SHOW_DATA);
+            testDark = false;
+        }
+        testSegment = bit;
+        return true;
+    }
+    return false;
+}
+
+void CN91C4S96SelfTestStart(const uint8_t *mask)
+{
+    if (mask)
+        memcpy(testMask, mask, DATA_SIZE);
+    else
+        glassMask(testMask);
+
+    // display RAM holds the last written frame
+    memcpy(testRam, BufferSendOld + SYS_SIZE, DATA_SIZE);
+    testDark = false;
+    testSegment = SEGMENT_NONE;
+    testPhase = CN91C4S96_TEST_ALL_ON;
+    allSegments(CTRL_ALL_ON, 0xff);
+}
+
+CN91C4S96_Test_en CN91C4S96SelfTestStep(void)
+{
+    switch (testPhase)
+    {
+    case CN91C4S96_TEST_ALL_ON:
+        testPhase = CN91C4S96_TEST_ALL_OFF;
+        allSegments(CTRL_ALL_OFF, 0x00);
+        break;
+    case CN91C4S96_TEST_ALL_OFF:
+    case CN91C4S96_TEST_WALK:
+        testPhase = CN91C4S96_TEST_WALK;
+        if (!walkNext())
+            CN91C4S96SelfTestStop();
+        break;
+    default:
+        break;
+    }
+    return testPhase;
+}
+
+void CN91C4S96SelfTestStop(void)
+{
+    if (testPhase == CN91C4S96_TEST_IDLE)
+        return;
+
+    // user frame from the cache, RAM first so that nothing flashes when data is shown again
+    ramWrite(BufferSendOld + SYS_SIZE);
+    if (testDark)
+        CN91C4S96_backend->Command(CTRL_SHOW_DATA);
+    testDark = false;
+    testSegment = SEGMENT_NONE;
+    testPhase = CN91C4S96_TEST_IDLE;
+}
+
+int16_t CN91C4S96SelfTestSegment(void)
+{
+    return (testPhase == CN91C4S96_TEST_WALK) ? testSegment : SEGMENT_NONE;
+}
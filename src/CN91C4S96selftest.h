@@ -0,0 +1,62 @@
+/*******************************************************************************
+Segment self-test for CN91C4S96 driver.
+
+For production and field checks: all segments on, all segments off, then
+every segment of the glass alone, one per step. The caller advances the
+test at its own pace, e.g. from a timer or after a camera frame.
+
+All-on and all-off are controller commands (LCDON/LCDOFF), display RAM is
+not touched. A backend without such a command gets one frame write instead.
+The walk is written while the glass is dark, then every step changes one
+bit, so a step is a 1 or 2 byte write. At the end the frame of the last
+CN91C4S96DispWrite is put back from the driver cache, only its bytes which
+differ from the test pattern; nothing is formatted again.
+
+    CN91C4S96SelfTestStart(NULL);  // all segments on
+    // every 300 ms
+    if (CN91C4S96SelfTestStep() == CN91C4S96_TEST_IDLE)
+        testDone();
+
+Print functions may be used while the test runs, CN91C4S96DispWrite must
+not: the new frame is shown by the first DispWrite after the test.
+*******************************************************************************/
+
+#ifndef CN91C4S96SELFTEST_H_
+#define CN91C4S96SELFTEST_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum
+{
+    CN91C4S96_TEST_IDLE = 0, // not running, user frame is shown
+    CN91C4S96_TEST_ALL_ON,   // all segments on
+    CN91C4S96_TEST_ALL_OFF,  // all segments off
+    CN91C4S96_TEST_WALK,     // one segment on, see CN91C4S96SelfTestSegment
+} CN91C4S96_Test_en;
+
+/*!
+    * \brief start the test with all segments on
+    *
+    * \param mask DATA_SIZE bytes, frame bits to walk. NULL for every segment of the glass layout
+    */
+void CN91C4S96SelfTestStart(const uint8_t *mask);
+
+/*!
+    * \brief go to the next phase or segment. After the last segment the user frame is restored
+    *
+    * \return phase shown now
+    */
+CN91C4S96_Test_en CN91C4S96SelfTestStep(void);
+
+/*!
+    * \brief stop the test at once and restore the user frame
+    */
+void CN91C4S96SelfTestStop(void);
+
+/*!
+    * \brief segment lit in the walk phase as frame bit number: byte * 8 + bit. -1 in other phases
+    */
+int16_t CN91C4S96SelfTestSegment(void);
+
+#endif
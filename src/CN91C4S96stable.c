@@ -0,0 +1,138 @@
+/*******************************************************************************
+Value stabilization for CN91C4S96 driver. See CN91C4S96stable.h
+*******************************************************************************/
+
+#include "CN91C4S96stable.h"
+#include "CN91C4S96.h"
+
+#define SIGNAL_LEVELS 3
+#define BATTERY_LEVELS 3
+
+// same thresholds as in CN91C4S96SignalLevel and CN91C4S96batteryLevel
+static const uint8_t signalThresholds[SIGNAL_LEVELS] = {0, 30, 60};
+static const uint8_t batteryThresholds[BATTERY_LEVELS] = {25, 50, 75};
+// percents which give exactly this level in the original functions
+static const uint8_t signalLevelPercents[SIGNAL_LEVELS + 1] = {0, 1, 31, 61};
+static const uint8_t batteryLevelPercents[BATTERY_LEVELS + 1] = {0, 26, 51, 76};
+
+#define STABLE_DEFAULT_HYSTERESIS 5
+
+static CN91C4S96Hyst_st signalHyst = {signalThresholds, SIGNAL_LEVELS, STABLE_DEFAULT_HYSTERESIS, 0, 0, 0, false};
+static CN91C4S96Hyst_st batteryHyst = {batteryThresholds, BATTERY_LEVELS, STABLE_DEFAULT_HYSTERESIS, 0, 0, 0, false};
+
+void CN91C4S96DeadbandInit(CN91C4S96Deadband_st *db, int32_t deadband, uint32_t holdTicks, uint32_t settleTicks)
+{
+    db->deadband = deadband;
+    db->holdTicks = holdTicks;
+    db->settleTicks = settleTicks;
+    db->shown = 0;
+    db->changedAt = 0;
+    db->pendingSince = 0;
+    db->pending = false;
+    db->valid = false;
+}
+
+bool CN91C4S96DeadbandUpdate(CN91C4S96Deadband_st *db, int32_t value, uint32_t now, int32_t *shown)
+{
+    if (db->valid)
+    {
+        int64_t diff = (int64_t)value - db->shown;
+        bool small = (diff <= db->deadband) && (diff >= -(int64_t)db->deadband);
+
+        if (diff == 0)
+        {
+            db->pending = false;
+            return false;
+        }
+        if (small && !db->pending)
+        {
+            db->pending = true;
+            db->pendingSince = now;
+        }
+        if (now - db->changedAt < db->holdTicks)
+            return false;
+        if (small && (db->settleTicks == 0 || now - db->pendingSince < db->settleTicks))
+            return false;
+    }
+
+    db->valid = true;
+    db->pending = false;
+    db->shown = value;
+    db->changedAt = now;
+    *shown = value;
+    return true;
+}
+
+void CN91C4S96HystInit(CN91C4S96Hyst_st *hyst, const uint8_t *thresholds, uint8_t count, uint8_t hysteresis,
+                       uint32_t holdTicks)
+{
+    hyst->thresholds = thresholds;
+    hyst->count = count;
+    hyst->hysteresis = hysteresis;
+    hyst->holdTicks = holdTicks;
+    hyst->changedAt = 0;
+    hyst->level = 0;
+    hyst->valid = false;
+}
+
+bool CN91C4S96HystUpdate(CN91C4S96Hyst_st *hyst, uint8_t input, uint32_t now, uint8_t *level)
+{
+    uint8_t next = hyst->valid ? hyst->level : 0;
+    uint8_t band = hyst->valid ? hyst->hysteresis : 0;
+
+    // going up as soon as threshold is crossed
+    while (next < hyst->count && input > hyst->thresholds[next])
+        next++;
+    // going down only below the band, the band doesn't go under zero
+    while (next > 0)
+    {
+        uint8_t threshold = hyst->thresholds[next - 1];
+        uint8_t low = (threshold > band) ? threshold - band : 0;
+        if (input > low)
+            break;
+        next--;
+    }
+
+    if (hyst->valid && (next == hyst->level || now - hyst->changedAt < hyst->holdTicks))
+        return false;
+
+    hyst->valid = true;
+    hyst->level = next;
+    hyst->changedAt = now;
+    *level = next;
+    return true;
+}
+
+void CN91C4S96StableConfig(uint8_t hysteresis, uint32_t holdTicks)
+{
+    CN91C4S96HystInit(&signalHyst, signalThresholds, SIGNAL_LEVELS, hysteresis, holdTicks);
+    CN91C4S96HystInit(&batteryHyst, batteryThresholds, BATTERY_LEVELS, hysteresis, holdTicks);
+}
+
+bool CN91C4S96SignalLevelStable(uint8_t percents, uint32_t now)
+{
+    uint8_t level;
+    if (!CN91C4S96HystUpdate(&signalHyst, percents, now, &level))
+        return false;
+    CN91C4S96SignalLevel(signalLevelPercents[level]);
+    return true;
+}
+
+bool CN91C4S96batteryLevelStable(uint8_t percents, uint32_t now)
+{
+    uint8_t level;
+    if (!CN91C4S96HystUpdate(&batteryHyst, percents, now, &level))
+        return false;
+    CN91C4S96batteryLevel(batteryLevelPercents[level]);
+    return true;
+}
+
+bool CN91C4S96printFixedStable(CN91C4S96Deadband_st *db, int32_t multiplied_float, uint32_t multiplier,
+                               uint32_t now)
+{
+    int32_t shown;
+    if (!CN91C4S96DeadbandUpdate(db, multiplied_float, now, &shown))
+        return false;
+    CN91C4S96printFixed(shown, multiplier);
+    return true;
+}
@@ -0,0 +1,94 @@
+/*******************************************************************************
+Value stabilization for CN91C4S96 driver.
+
+Deadband, hysteresis and hold time between noisy inputs and the display, so
+that jitter in the last digit or around a bar threshold doesn't turn into
+display writes. Time is given by the caller in any ticks.
+*******************************************************************************/
+
+#ifndef CN91C4S96STABLE_H_
+#define CN91C4S96STABLE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct
+{
+    int32_t deadband;     // changes up to this value are not shown
+    uint32_t holdTicks;   // minimum time between two display changes
+    uint32_t settleTicks; // a small change is shown when it lasts this long. 0 - never
+    int32_t shown;
+    uint32_t changedAt;
+    uint32_t pendingSince;
+    bool pending;
+    bool valid;
+} CN91C4S96Deadband_st;
+
+typedef struct
+{
+    const uint8_t *thresholds; // rising thresholds: level n is reached when input > thresholds[n - 1]
+    uint8_t count;             // number of thresholds
+    uint8_t hysteresis;        // input has to fall this much below threshold to lower the level
+    uint32_t holdTicks;        // minimum time between two level changes
+    uint32_t changedAt;
+    uint8_t level;
+    bool valid;
+} CN91C4S96Hyst_st;
+
+/*!
+    * \brief init deadband filter of one numeric field
+    */
+void CN91C4S96DeadbandInit(CN91C4S96Deadband_st *db, int32_t deadband, uint32_t holdTicks, uint32_t settleTicks);
+
+/*!
+    * \brief pass new value through deadband filter
+    *
+    * \param now current time in ticks
+    * \param shown value to be displayed, updated only when function returns true
+    * \return true if display has to be updated
+    */
+bool CN91C4S96DeadbandUpdate(CN91C4S96Deadband_st *db, int32_t value, uint32_t now, int32_t *shown);
+
+/*!
+    * \brief init hysteresis filter of a bar indicator
+    */
+void CN91C4S96HystInit(CN91C4S96Hyst_st *hyst, const uint8_t *thresholds, uint8_t count, uint8_t hysteresis,
+                       uint32_t holdTicks);
+
+/*!
+    * \brief pass new input through hysteresis filter
+    *
+    * \param now current time in ticks
+    * \param level bar level 0..count, updated only when function returns true
+    * \return true if display has to be updated
+    */
+bool CN91C4S96HystUpdate(CN91C4S96Hyst_st *hyst, uint8_t input, uint32_t now, uint8_t *level);
+
+/*!
+    * \brief set hysteresis and hold time used by CN91C4S96SignalLevelStable and CN91C4S96batteryLevelStable
+    */
+void CN91C4S96StableConfig(uint8_t hysteresis, uint32_t holdTicks);
+
+/*!
+    * \brief same as CN91C4S96SignalLevel, but the bar changes only after input leaves the hysteresis band
+    *
+    * \return true if Buffer was changed
+    */
+bool CN91C4S96SignalLevelStable(uint8_t percents, uint32_t now);
+
+/*!
+    * \brief same as CN91C4S96batteryLevel, but the bar changes only after input leaves the hysteresis band
+    *
+    * \return true if Buffer was changed
+    */
+bool CN91C4S96batteryLevelStable(uint8_t percents, uint32_t now);
+
+/*!
+    * \brief same as CN91C4S96printFixed, but the number is redrawn only when it leaves the deadband of `db`
+    *
+    * \return true if Buffer was changed
+    */
+bool CN91C4S96printFixedStable(CN91C4S96Deadband_st *db, int32_t multiplied_float, uint32_t multiplier,
+                               uint32_t now);
+
+#endif
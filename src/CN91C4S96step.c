@@ -0,0 +1,147 @@
+/*******************************************************************************
+Step-by-step bus access for CN91C4S96 driver. See CN91C4S96step.h
+*******************************************************************************/
+
+#include "CN91C4S96step.h"
+#include <string.h>
+
+#define ENTRY_HEAD 2     // address and size before transfer data
+#define CMD_CONTINUE 0x80 // command byte flag: another command byte follows, see CN91C4S96ctrl.c
+
+#if CN91C4S96_STEP_QUEUE_SIZE < ENTRY_HEAD + SYS_SIZE + DATA_SIZE + CN91C4S96_STEP_CMD_RESERVE
+#error "CN91C4S96_STEP_QUEUE_SIZE must hold a full frame and the command reserve"
+#endif
+#if CN91C4S96_STEP_RETRY_SIZE > CN91C4S96_STEP_QUEUE_SIZE
+#error "CN91C4S96_STEP_RETRY_SIZE must fit into the queue"
+#endif
+
+static CN91C4S96_HAL_st *stepHal = 0;
+static CN91C4S96_HAL_st stepWrapHal;
+static bool (*stepBusy)(void) = 0;
+
+static uint8_t stepQueue[CN91C4S96_STEP_QUEUE_SIZE]; // entries: address, size, data[size]
+static uint16_t stepHead = 0;                        // where next entry is added
+static uint16_t stepTail = 0;                        // next entry to send
+static bool stepOverflow = false;                    // display RAM may differ from the driver shadow
+static uint8_t stepRetry[CN91C4S96_STEP_RETRY_SIZE]; // commands which didn't fit, same entries
+static uint16_t stepRetryLen = 0;
+static uint32_t stepDropped = 0;
+
+static void stepInitI2C(void)
+{
+    if (stepHal->InitI2C)
+        stepHal->InitI2C();
+}
+
+static void stepWaitI2C(void)
+{
+    // transfers are only queued here, there is nothing to wait for
+}
+
+// transfer has command bytes only: nothing follows the byte without continuation flag
+static bool stepIsCommand(const uint8_t *data, uint16_t size)
+{
+    uint16_t i = 0;
+    while (i < size && (data[i] & CMD_CONTINUE))
+        i++;
+    return i + 1 >= size;
+}
+
+static bool stepPut(uint8_t *queue, uint16_t *len, uint16_t cap, uint8_t address, const uint8_t *data,
+                    uint16_t size)
+{
+    if (size > UINT8_MAX || *len + ENTRY_HEAD + size > cap)
+        return false;
+
+    queue[*len] = address;
+    queue[*len + 1] = (uint8_t)size;
+    memcpy(queue + *len + ENTRY_HEAD, data, size);
+    *len += ENTRY_HEAD + size;
+    return true;
+}
+
+static int8_t stepWriteI2C(uint8_t address, const uint8_t *data, uint16_t size)
+{
+    if (!stepIsCommand(data, size))
+    {
+        // frame data leaves the reserve to commands and doesn't overtake commands waiting for retry
+        if (stepRetryLen ||
+            !stepPut(stepQueue, &stepHead, CN91C4S96_STEP_QUEUE_SIZE - CN91C4S96_STEP_CMD_RESERVE, address, data,
+                     size))
+        {
+            stepOverflow = true;
+            return -1;
+        }
+        return 0;
+    }
+
+    // commands keep their order: once one waits for retry, the following ones wait too
+    if (!stepRetryLen && stepPut(stepQueue, &stepHead, CN91C4S96_STEP_QUEUE_SIZE, address, data, size))
+        return 0;
+    if (stepPut(stepRetry, &stepRetryLen, CN91C4S96_STEP_RETRY_SIZE, address, data, size))
+        return 0;
+    stepDropped++;
+    return -1;
+}
+
+CN91C4S96_HAL_st *CN91C4S96StepHal(CN91C4S96_HAL_st *hal_ptr, bool (*busy)(void))
+{
+    if (!hal_ptr || !busy)
+        return hal_ptr;
+
+    stepHal = hal_ptr;
+    stepBusy = busy;
+    stepHead = 0;
+    stepTail = 0;
+    stepOverflow = false;
+    stepRetryLen = 0;
+    stepDropped = 0;
+
+    stepWrapHal.InitI2C = stepInitI2C;
+    stepWrapHal.WriteI2C = stepWriteI2C;
+    stepWrapHal.WaitI2C = stepWaitI2C;
+    return &stepWrapHal;
+}
+
+CN91C4S96_Step_en CN91C4S96StepPoll(void)
+{
+    if (!stepHal || stepBusy())
+        return CN91C4S96_STEP_BUSY;
+
+    if (stepTail == stepHead)
+    {
+        // last transfer is over, its data may be overwritten now
+        stepHead = 0;
+        stepTail = 0;
+        if (stepRetryLen)
+        {
+            // commands first, the frame which didn't fit follows them
+            memcpy(stepQueue, stepRetry, stepRetryLen);
+            stepHead = stepRetryLen;
+            stepRetryLen = 0;
+        }
+        else if (stepOverflow)
+        {
+            stepOverflow = false;
+            CN91C4S96DispRefresh();
+        }
+        if (stepTail == stepHead)
+            return CN91C4S96_STEP_IDLE;
+    }
+
+    uint8_t address = stepQueue[stepTail];
+    uint8_t size = stepQueue[stepTail + 1];
+    stepHal->WriteI2C(address, stepQueue + stepTail + ENTRY_HEAD, size);
+    stepTail += ENTRY_HEAD + size;
+    return CN91C4S96_STEP_BUSY;
+}
+
+bool CN91C4S96StepPending(void)
+{
+    return stepTail != stepHead || stepRetryLen || stepOverflow || (stepHal && stepBusy());
+}
+
+uint32_t CN91C4S96StepDropped(void)
+{
+    return stepDropped;
+}
@@ -0,0 +1,78 @@
+/*******************************************************************************
+Step-by-step (non-blocking) bus access for CN91C4S96 driver.
+
+Sits between the driver and the HAL like the trace recorder. Driver calls
+(CN91C4S96Init, CN91C4S96DispWrite, displayOn/Off, power commands, ...) do not
+wait for the bus any more: their transfers are queued and return at once.
+CN91C4S96StepPoll() moves the display forward by one bus phase: it starts the
+next queued transfer when the previous one is over and returns immediately.
+
+    CN91C4S96Init(CN91C4S96StepHal(&hal, I2C_IsBusy));
+    for (;;)
+    {
+        metrology();
+        if (newData)
+        {
+            CN91C4S96printNum(volume, 3);
+            CN91C4S96DispWrite();
+        }
+        CN91C4S96StepPoll();
+    }
+
+HAL WriteI2C must only start the transfer (interrupt or DMA), data stays valid
+until `busy` returns false. WaitI2C is not used. The last
+CN91C4S96_STEP_CMD_RESERVE bytes of the queue are kept for commands (init,
+LCDOFF, power modes), frame data doesn't use them. If frame data doesn't fit,
+the frame is sent again in full when the queue is empty. A command which
+doesn't fit waits in the retry buffer and is sent, in order, before that
+frame; only when the retry buffer is full as well the command is dropped and
+counted by CN91C4S96StepDropped().
+*******************************************************************************/
+
+#ifndef CN91C4S96STEP_H_
+#define CN91C4S96STEP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "CN91C4S96.h"
+
+#ifndef CN91C4S96_STEP_QUEUE_SIZE
+#define CN91C4S96_STEP_QUEUE_SIZE 64 // bytes: 2 per transfer + transfer data. Full frame is 20
+#endif
+#ifndef CN91C4S96_STEP_CMD_RESERVE
+#define CN91C4S96_STEP_CMD_RESERVE 8 // bytes of the queue only commands may use. Command is 3 or 4
+#endif
+#ifndef CN91C4S96_STEP_RETRY_SIZE
+#define CN91C4S96_STEP_RETRY_SIZE 16 // bytes for commands which didn't fit into the queue
+#endif
+
+typedef enum
+{
+    CN91C4S96_STEP_IDLE = 0, // nothing to send, bus is free
+    CN91C4S96_STEP_BUSY,     // transfer is in progress or was just started
+} CN91C4S96_Step_en;
+
+/**
+     * @brief Returns HAL to be passed into CN91C4S96Init instead of the original one
+     *
+     * @param hal_ptr - original HAL. InitI2C is called at once, WriteI2C from CN91C4S96StepPoll
+     * @param busy - returns true while the transfer started by WriteI2C is in progress
+     */
+CN91C4S96_HAL_st *CN91C4S96StepHal(CN91C4S96_HAL_st *hal_ptr, bool (*busy)(void));
+
+/**
+     * @brief Start the next queued transfer if the bus is free. Never waits
+     */
+CN91C4S96_Step_en CN91C4S96StepPoll(void);
+
+/**
+     * @brief true while there are queued or running transfers
+     */
+bool CN91C4S96StepPending(void);
+
+/**
+     * @brief Number of commands dropped because the queue and the retry buffer were full
+     */
+uint32_t CN91C4S96StepDropped(void);
+
+#endif
@@ -0,0 +1,134 @@
+/*******************************************************************************
+Compile time messages of CN91C4S96printText for C++14 and later.
+
+A string literal with the _cn91 suffix is encoded by the compiler into a
+CN91C4S96Text_st: the UTF-8 text is decoded, every character is looked up
+in the glyph set and placed by the layout profile of the driver build, the
+same way CN91C4S96printStr does it at run time. The message is a const
+object in flash, showing it is a masked copy of the frame bytes.
+
+    #include "CN91C4S96text.hpp"
+    using namespace cn91c4s96::literals;
+
+    static constexpr CN91C4S96Text_st msgClosed = "CLOSED"_cn91;
+    CN91C4S96printText(&msgClosed);
+
+Glyphs are taken from the whole glyph set, also with CN91C4S96_USE_LETTERS
+or CN91C4S96_USE_TEXT off: the tables are not linked into the firmware.
+A message with more characters than the glass has digits doesn't compile.
+With C++20 the literal is consteval; before, keep it in a constexpr
+variable, otherwise the compiler may encode it at run time.
+
+C code gets the same messages from tools/textgen.py.
+*******************************************************************************/
+
+#ifndef CN91C4S96TEXT_HPP_
+#define CN91C4S96TEXT_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+extern "C"
+{
+#include "CN91C4S96.h"
+}
+#include "CN91C4S96glyphs.h"
+
+#if defined(__cpp_consteval)
+#define CN91C4S96_CONSTEVAL consteval
+#else
+#define CN91C4S96_CONSTEVAL constexpr
+#endif
+
+namespace cn91c4s96
+{
+namespace detail
+{
+
+struct Glyph
+{
+    uint16_t cp;
+    uint8_t glyph;
+};
+
+// tables of CN91C4S96.c, in the glyph format of README.md
+constexpr uint8_t glyphAscii[] = {CN91C4S96_GLYPHS_ASCII, CN91C4S96_GLYPHS_ASCII_LETTERS};
+constexpr Glyph glyphHash[1 << CN91C4S96_GLYPHS_HASH_BITS] = {CN91C4S96_GLYPHS_HASH};
+constexpr uint8_t digitFGE[CN91C4S96_LAYOUT_DIGITS] = CN91C4S96_LAYOUT_DIGIT_FGE;
+constexpr uint8_t digitABCD[CN91C4S96_LAYOUT_DIGITS] = CN91C4S96_LAYOUT_DIGIT_ABCD;
+
+constexpr uint32_t UTF8_INVALID = 0xFFFFFFFF;
+constexpr uint8_t DIGIT_FGE_SEGS = 0x70;
+constexpr uint8_t DIGIT_ABCD_SEGS = 0x0f;
+
+// never defined: reached only while encoding a too long message, which is then not a constant
+void messageLongerThanDigitRow();
+
+// utf8Next of CN91C4S96.c, `pos` is moved behind the sequence
+constexpr uint32_t utf8Next(const char *str, size_t &pos)
+{
+    uint32_t cp = (uint8_t)str[pos++];
+    uint8_t extra = (cp >= 0xF0) ? 3 : (cp >= 0xE0) ? 2 : (cp >= 0xC0) ? 1 : 0;
+
+    if (cp >= 0x80)
+    {
+        cp = (extra == 0) ? UTF8_INVALID : cp & (0x3F >> extra);
+        for (; extra > 0; extra--)
+        {
+            if (((uint8_t)str[pos] & 0xC0) != 0x80)
+            {
+                cp = UTF8_INVALID;
+                break;
+            }
+            cp = (cp << 6) | ((uint8_t)str[pos++] & 0x3F);
+        }
+    }
+    return cp;
+}
+
+constexpr uint8_t glyphLookup(uint32_t cp)
+{
+    if (cp - ' ' < sizeof(glyphAscii))
+        return glyphAscii[cp - ' '];
+    // lowercase cyrillic shows the uppercase glyph
+    if (cp - CN91C4S96_CYRILLIC_LOWER_FIRST < CN91C4S96_CYRILLIC_CASE_COUNT)
+        cp -= CN91C4S96_CYRILLIC_CASE_COUNT;
+    if (cp == CN91C4S96_CYRILLIC_YO_LOWER)
+        cp -= CN91C4S96_CYRILLIC_YO_DELTA;
+    const Glyph &g = glyphHash[CN91C4S96_GLYPH_HASH(cp)];
+    return (g.cp == cp) ? g.glyph : 0;
+}
+
+constexpr CN91C4S96Text_st encode(const char *str, size_t size)
+{
+    CN91C4S96Text_st text{};
+    size_t pos = 0;
+
+    for (size_t i = 0; i < DISPLAY_SIZE && pos < size && str[pos]; i++)
+    {
+        uint8_t glyph = glyphLookup(utf8Next(str, pos));
+        text.frame[digitFGE[i]] |= DIGIT_FGE_SEGS & (glyph << 4);
+        text.frame[digitABCD[i]] |= DIGIT_ABCD_SEGS & ((glyph >> 4) | (glyph & 0x08));
+    }
+    if (pos < size && str[pos])
+        messageLongerThanDigitRow();
+    return text;
+}
+
+} // namespace detail
+
+namespace literals
+{
+
+/**
+     * @brief Message for CN91C4S96printText: "ERR 05"_cn91
+     */
+CN91C4S96_CONSTEVAL CN91C4S96Text_st operator""_cn91(const char *str, size_t size)
+{
+    return detail::encode(str, size);
+}
+
+} // namespace literals
+} // namespace cn91c4s96
+
+#endif
@@ -0,0 +1,37 @@
+/*******************************************************************************
+Messages of CN91C4S96printText for the pdc6x1 layout, see CN91C4S96.h
+
+Generated by tools/textgen.py from messages.map, glyphs.map, pdc6x1.map, don't edit.
+*******************************************************************************/
+
+#ifndef CN91C4S96TEXT_MESSAGES_H_
+#define CN91C4S96TEXT_MESSAGES_H_
+
+#include "CN91C4S96.h"
+
+#ifndef CN91C4S96LAYOUT_PDC6X1_H_
+#error "messages are made for the pdc6x1 layout, run tools/textgen.py with the map of the glass"
+#endif
+
+// "ERR 05"
+#define CN91C4S96_TEXT_ERR05 {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0d, 0x3f, 0x50, 0x00, 0x60, 0x69, 0x70, 0x00}}
+
+// "CLOSED"
+#define CN91C4S96_TEXT_CLOSED {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0e, 0x69, 0x7d, 0x1c, 0x68, 0x59, 0x50, 0x00}}
+
+// "OPEN"
+#define CN91C4S96_TEXT_OPEN {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0x59, 0x73, 0x7c, 0x60, 0x00}}
+
+// "LEAK"
+#define CN91C4S96_TEXT_LEAK {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x77, 0x79, 0x78, 0x50, 0x00}}
+
+// "SN   "
+#define CN91C4S96_TEXT_SN {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0x5d, 0x10, 0x00}}
+
+// "donE"
+#define CN91C4S96_TEXT_DONE {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0x77, 0x5c, 0x6e, 0x60, 0x00}}
+
+// "ОШИБКА"
+#define CN91C4S96_TEXT_ERROR_RU {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0x72, 0x7d, 0x7e, 0x5e, 0x5f, 0x50, 0x00}}
+
+#endif
@@ -0,0 +1,131 @@
+/*******************************************************************************
+I2C trace recorder for CN91C4S96 driver. See CN91C4S96trace.h for format.
+*******************************************************************************/
+
+#include "CN91C4S96trace.h"
+#include <string.h>
+
+static CN91C4S96_HAL_st *traceHal = 0;
+static CN91C4S96_HAL_st traceWrapHal;
+static uint8_t *traceBuf = 0;
+static size_t traceCap = 0;
+static size_t traceLen = 0;
+static uint32_t traceDropped = 0;
+static uint32_t traceLastTick = 0;
+static uint32_t (*traceGetTick)(void) = 0;
+static bool traceOn = false;
+
+// see CN91C4S96.c
+void commitAttach(void (*hook)(const uint8_t *frame));
+void commitDetach(void (*hook)(const uint8_t *frame));
+
+static size_t traceVarint(uint8_t *out, uint32_t v)
+{
+    size_t n = 0;
+    while (v >= 0x80)
+    {
+        out[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+static void traceInitI2C(void)
+{
+    if (traceHal->InitI2C)
+        traceHal->InitI2C();
+}
+
+static void traceWaitI2C(void)
+{
+    if (traceHal->WaitI2C)
+        traceHal->WaitI2C();
+}
+
+static void traceRecord(uint8_t address, const uint8_t *data, uint16_t size)
+{
+    uint8_t head[2 * TRACE_VARINT_MAX + 1];
+    uint32_t now = traceGetTick();
+    size_t n = traceVarint(head, now - traceLastTick);
+    head[n++] = address;
+    n += traceVarint(head + n, size);
+
+    if (traceLen + n + size <= traceCap)
+    {
+        memcpy(traceBuf + traceLen, head, n);
+        if (size)
+            memcpy(traceBuf + traceLen + n, data, size);
+        traceLen += n + size;
+        traceLastTick = now;
+    }
+    else
+    {
+        traceDropped++;
+    }
+}
+
+// called by the driver after every frame write
+static void traceCommit(const uint8_t *frame)
+{
+    (void)frame;
+    if (traceOn)
+        traceRecord(TRACE_FRAME_MARK, 0, 0);
+}
+
+static int8_t traceWriteI2C(uint8_t address, const uint8_t *data, uint16_t size)
+{
+    if (traceOn)
+        traceRecord(address, data, size);
+
+    if (traceHal->WriteI2C)
+        return traceHal->WriteI2C(address, data, size);
+    return 0;
+}
+
+CN91C4S96_HAL_st *CN91C4S96TraceStart(CN91C4S96_HAL_st *hal_ptr, uint8_t *buf, size_t size,
+                                      uint32_t (*getTick)(void), uint32_t tickHz)
+{
+    if (!hal_ptr || !buf || !getTick || size < TRACE_HEADER_SIZE)
+        return hal_ptr;
+
+    traceHal = hal_ptr;
+    traceBuf = buf;
+    traceCap = size;
+    traceDropped = 0;
+    traceGetTick = getTick;
+    traceLastTick = getTick();
+
+    buf[0] = TRACE_MAGIC0;
+    buf[1] = TRACE_MAGIC1;
+    buf[2] = TRACE_MAGIC2;
+    buf[3] = TRACE_VERSION;
+    buf[4] = (uint8_t)tickHz;
+    buf[5] = (uint8_t)(tickHz >> 8);
+    buf[6] = (uint8_t)(tickHz >> 16);
+    buf[7] = (uint8_t)(tickHz >> 24);
+    traceLen = TRACE_HEADER_SIZE;
+
+    traceWrapHal.InitI2C = traceInitI2C;
+    traceWrapHal.WriteI2C = traceWriteI2C;
+    traceWrapHal.WaitI2C = traceWaitI2C;
+    commitAttach(traceCommit);
+    traceOn = true;
+    return &traceWrapHal;
+}
+
+void CN91C4S96TraceStop(void)
+{
+    traceOn = false;
+    commitDetach(traceCommit);
+}
+
+size_t CN91C4S96TraceSize(void)
+{
+    return traceLen;
+}
+
+uint32_t CN91C4S96TraceDropped(void)
+{
+    return traceDropped;
+}
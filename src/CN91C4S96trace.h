@@ -0,0 +1,59 @@
+/*******************************************************************************
+I2C trace recorder for CN91C4S96 driver.
+
+Sits between the driver and the HAL and stores every WriteI2C call into a
+caller-provided buffer. Works on the target and in host builds. The end of
+every frame write (DispWrite, DispRefresh, ...) is recorded as well, so the
+transfers can be grouped per frame when the trace is replayed.
+
+Trace format (all multi-byte fields are little endian):
+    header: 'C' 'N' 'T' version tick_hz[4]
+    record: varint(ticks since previous record) address varint(size) data[size]
+A record with address TRACE_FRAME_MARK and no data marks the end of a frame:
+the transfers since the previous mark carried it. Version 1 traces have no marks.
+varint is 7 bits per byte, low bits first, high bit set when more bytes follow.
+*******************************************************************************/
+
+#ifndef CN91C4S96TRACE_H_
+#define CN91C4S96TRACE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "CN91C4S96.h"
+
+#define TRACE_MAGIC0 'C'
+#define TRACE_MAGIC1 'N'
+#define TRACE_MAGIC2 'T'
+#define TRACE_VERSION 2
+#define TRACE_HEADER_SIZE 8
+#define TRACE_VARINT_MAX 5 // uint32_t needs up to 5 varint bytes
+#define TRACE_FRAME_MARK 0xff // not a 7-bit I2C address
+
+/**
+     * @brief Start recording. Returns HAL to be passed into CN91C4S96Init instead of the original one
+     *
+     * @param hal_ptr - original HAL, calls are forwarded to it. May have NULL WriteI2C for host-only traces
+     * @param buf - trace storage
+     * @param size - storage size. Records which don't fit are dropped and counted
+     * @param getTick - free running timestamp source
+     * @param tickHz - frequency of getTick
+     */
+CN91C4S96_HAL_st *CN91C4S96TraceStart(CN91C4S96_HAL_st *hal_ptr, uint8_t *buf, size_t size,
+                                      uint32_t (*getTick)(void), uint32_t tickHz);
+
+/**
+     * @brief Stop recording. Following writes are forwarded only, history and mirror are not affected
+     */
+void CN91C4S96TraceStop(void);
+
+/**
+     * @brief Number of trace bytes recorded so far, including header
+     */
+size_t CN91C4S96TraceSize(void);
+
+/**
+     * @brief Number of records which didn't fit into the buffer
+     */
+uint32_t CN91C4S96TraceDropped(void);
+
+#endif
@@ -0,0 +1,168 @@
+/*******************************************************************************
+HT1621 controller backend. See HT1621ctrl.h
+*******************************************************************************/
+
+#include "HT1621ctrl.h"
+#include "CN91C4S96.h"
+#include "main.h"
+#include <string.h>
+
+/**
+ * @brief HT1621 HARDWARE DEFINES BLOCK
+ */
+#define ID_CMD 0x04   // 0b100 command mode
+#define ID_WRITE 0x05 // 0b101 write mode
+#define ID_BITS 3
+#define ADDR_BITS 6
+#define CMD_BITS 9 // 8 command bits and one "don't care" bit
+#define NIBBLE_BITS 4
+
+#define SYS_DIS 0x00 // stop oscillator and LCD bias generator
+#define SYS_EN 0x01  // start oscillator
+#define LCD_OFF 0x02 // LCD bias generator off
+#define LCD_ON 0x03  // LCD bias generator on
+#define RC256K 0x18  // on-chip RC oscillator
+#define BIAS_1_3_4COM 0x29
+
+#define NIBBLES (DATA_SIZE * 2)
+#define TX_SIZE ((ID_BITS + ADDR_BITS + NIBBLES * NIBBLE_BITS + 7) / 8)
+
+// unchanged nibbles between two changed runs are sent too if they cost less than new transfer:
+// 3 bit ID, 6 bit address and CS toggle
+#define MERGE_GAP 2
+
+static HT1621_HAL_st *HT1621_hal = 0;
+
+static uint8_t txBuf[TX_SIZE];
+static uint16_t txBits = 0;
+
+static void htInit(void);
+static bool htCommand(CN91C4S96_Ctrl_en cmd);
+static void htFlush(const uint8_t *frame, const uint8_t *shadow);
+
+static CN91C4S96_Backend_st HT1621backend = {htInit, htCommand, htFlush, DATA_SIZE};
+
+// append `count` low bits of `value`, MSB first
+static void txPut(uint16_t value, uint8_t count)
+{
+    while (count--)
+    {
+        uint8_t bit = (value >> count) & 1;
+        if (bit)
+            txBuf[txBits / 8] |= 0x80 >> (txBits % 8);
+        txBits++;
+    }
+}
+
+static void txStart(uint8_t id)
+{
+    memset(txBuf, 0, sizeof(txBuf));
+    txBits = 0;
+    txPut(id, ID_BITS);
+}
+
+static void txSend(void)
+{
+    HT1621_hal->Cs(false);
+    HT1621_hal->SpiTx(txBuf, (txBits + 7) / 8);
+    HT1621_hal->Cs(true);
+}
+
+static void htCmd(const uint8_t *cmds, uint8_t count)
+{
+    // commands may follow one another after a single ID
+    txStart(ID_CMD);
+    for (uint8_t i = 0; i < count; i++)
+        txPut((uint16_t)cmds[i] << 1, CMD_BITS);
+    txSend();
+}
+
+static uint8_t nibble(const uint8_t *frame, uint8_t addr)
+{
+    return (addr & 1) ? (frame[addr / 2] & 0x0f) : (frame[addr / 2] >> 4);
+}
+
+static void htInit(void)
+{
+    if (HT1621_hal->InitSpi)
+        HT1621_hal->InitSpi();
+    HT1621_hal->Cs(true);
+}
+
+static bool htCommand(CN91C4S96_Ctrl_en cmd)
+{
+    static const uint8_t init[] = {BIAS_1_3_4COM, RC256K, SYS_EN, LCD_ON};
+    static const uint8_t on[] = {LCD_ON};
+    static const uint8_t off[] = {LCD_OFF};
+    static const uint8_t disable[] = {LCD_OFF, SYS_DIS};
+
+    switch (cmd)
+    {
+    case CTRL_INIT:
+        htCmd(init, sizeof(init));
+        return true;
+    case CTRL_SHOW_DATA:
+        htCmd(on, sizeof(on));
+        return true;
+    case CTRL_ALL_OFF:
+        htCmd(off, sizeof(off));
+        return true;
+    case CTRL_DISABLE:
+        htCmd(disable, sizeof(disable));
+        return true;
+    case CTRL_ALL_ON:
+    case CTRL_LOW_POWER:
+    case CTRL_FULL_POWER:
+        // no such commands in HT1621
+        return false;
+    }
+    return false;
+}
+
+static void htFlush(const uint8_t *frame, const uint8_t *shadow)
+{
+    uint8_t maxNibbles = (HT1621backend.maxBurst ? HT1621backend.maxBurst : DATA_SIZE) * 2;
+    uint8_t a = 0;
+
+    while (a < NIBBLES)
+    {
+        if (shadow && nibble(frame, a) == nibble(shadow, a))
+        {
+            a++;
+            continue;
+        }
+
+        // one write with address auto-increment over the changed nibbles and short gaps between them
+        uint8_t first = a;
+        uint8_t end = a + 1;
+        uint8_t gap = 0;
+        for (uint8_t b = a + 1; b < NIBBLES && b - first < maxNibbles; b++)
+        {
+            if (!shadow || nibble(frame, b) != nibble(shadow, b))
+            {
+                end = b + 1;
+                gap = 0;
+            }
+            else if (++gap > MERGE_GAP)
+            {
+                break;
+            }
+        }
+
+        txStart(ID_WRITE);
+        txPut(first, ADDR_BITS);
+        // D0 goes first, it is COM0 which is bit 3 of the frame nibble
+        for (uint8_t n = first; n < end; n++)
+            txPut(nibble(frame, n), NIBBLE_BITS);
+        txSend();
+        a = end;
+    }
+}
+
+CN91C4S96_Backend_st *HT1621Backend(HT1621_HAL_st *hal_ptr)
+{
+    assert_param(hal_ptr->Cs != NULL);
+    assert_param(hal_ptr->SpiTx != NULL);
+    HT1621_hal = hal_ptr;
+    return &HT1621backend;
+}
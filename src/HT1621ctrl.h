@@ -0,0 +1,35 @@
+/*******************************************************************************
+HT1621 controller backend of the CN91C4S96 driver.
+
+HT1621 is driven by CS, WR and DATA lines. Any SPI master with CPOL=LOW,
+EDGE=1, MSB first, or a bit-bang routine may be used: every transfer is
+packed into bytes, bits after the end of a command or write are ignored by
+the chip when CS goes high.
+
+The glass has to be wired SEGn to SEGn and COMn to COMn, then frames are the
+same as with CN91C4S96: byte n holds RAM addresses 2n and 2n + 1.
+*******************************************************************************/
+
+#ifndef HT1621CTRL_H_
+#define HT1621CTRL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "CN91C4S96ctrl.h"
+
+typedef struct
+{
+    void (*InitSpi)(void);                         // optional
+    void (*Cs)(bool level);                        // chip select, active low
+    void (*SpiTx)(const uint8_t *ptr, uint16_t size); // MSB first, blocking
+} HT1621_HAL_st;
+
+/*!
+    * \brief HT1621 backend: nibble addressed writes with address auto-increment
+    *
+    * \param hal_ptr bus functions, stored by pointer
+    * \return backend to be passed into CN91C4S96InitBackend
+    */
+CN91C4S96_Backend_st *HT1621Backend(HT1621_HAL_st *hal_ptr);
+
+#endif
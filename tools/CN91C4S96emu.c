@@ -0,0 +1,361 @@
+/*******************************************************************************
+Host-side model of the CN91C4S96 controller and PDC-6X1 glass.
+
+Segment positions come from the same layout profile as the driver uses,
+see src/CN91C4S96layout.h. Build with -Isrc.
+*******************************************************************************/
+
+#include "CN91C4S96emu.h"
+#include "CN91C4S96layout.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief CONTROLLER MODEL DEFINES BLOCK
+ */
+#define EMU_CMD_FLAG 0x80       // command byte, next byte is command too
+#define EMU_CMD_MASK 0x7f
+#define EMU_ADSET_MAX 0x1f      // 0b000A AAAA last command: set DRAM address
+#define EMU_MODE_MASK 0x60      // 0b010U E000 system mode set
+#define EMU_MODE_CMD 0x40
+#define EMU_MODE_ULP 0x10
+#define EMU_MODE_SYSEN 0x08
+#define EMU_PIXDATA 0x78
+#define EMU_LCDOFF 0x79
+#define EMU_LCDON 0x7A
+#define EMU_NIBBLES_PER_BYTE 2
+#define EMU_ADDR_MAX (EMU_DATA_SIZE * EMU_NIBBLES_PER_BYTE)
+
+/**
+ * @brief GLASS DEFINES BLOCK
+ */
+#define EMU_DIGITS CN91C4S96_LAYOUT_DIGITS
+#define EMU_SEG_A (1 << 0)
+#define EMU_SEG_B (1 << 1)
+#define EMU_SEG_C (1 << 2)
+#define EMU_SEG_D (1 << 3)
+#define EMU_SEG_F (1 << 4)
+#define EMU_SEG_G (1 << 5)
+#define EMU_SEG_E (1 << 6)
+#define EMU_DIGIT_FGE 0x70
+#define EMU_DIGIT_ABCD 0x0f
+
+static const CN91C4S96_Layout_st layout = CN91C4S96_LAYOUT_INIT;
+
+CN91C4S96Emu_st CN91C4S96EmuGlobal;
+
+#define EMU_ICON(NAME) {#NAME, CN91C4S96_LAYOUT_ICON_##NAME},
+
+const CN91C4S96Emu_icon_st CN91C4S96EmuIcons[] = {CN91C4S96_ICONS(EMU_ICON)};
+const size_t CN91C4S96EmuIconsCount = sizeof(CN91C4S96EmuIcons) / sizeof(CN91C4S96EmuIcons[0]);
+
+void CN91C4S96EmuReset(CN91C4S96Emu_st *emu)
+{
+    memset(emu, 0, sizeof(*emu));
+    emu->pix = EMU_PIX_DATA;
+}
+
+// apply one command byte (without the continuation flag)
+static void emuCmd(CN91C4S96Emu_st *emu, uint8_t cmd)
+{
+    if (cmd <= EMU_ADSET_MAX)
+        emu->addr = cmd;
+    else if ((cmd & EMU_MODE_MASK) == EMU_MODE_CMD)
+    {
+        emu->ulp = (cmd & EMU_MODE_ULP) != 0;
+        emu->sysen = (cmd & EMU_MODE_SYSEN) != 0;
+    }
+    else if (cmd == EMU_PIXDATA)
+        emu->pix = EMU_PIX_DATA;
+    else if (cmd == EMU_LCDOFF)
+        emu->pix = EMU_PIX_OFF;
+    else if (cmd == EMU_LCDON)
+        emu->pix = EMU_PIX_ON;
+    // drive mode, blink and contrast commands don't change what is shown
+}
+
+int8_t CN91C4S96EmuWrite(CN91C4S96Emu_st *emu, uint8_t address, const uint8_t *data, uint16_t size)
+{
+    if (address != EMU_SLAVE_ADDRESS)
+        return -1;
+
+    emu->writes++;
+
+    uint16_t i = 0;
+    // commands go first while continuation flag is set, the byte without the flag is the last command
+    while (i < size)
+    {
+        uint8_t b = data[i++];
+        emuCmd(emu, b & EMU_CMD_MASK);
+        if (!(b & EMU_CMD_FLAG))
+            break;
+    }
+    // the rest is display data, two nibble addresses per byte with auto-increment
+    for (; i < size; i++)
+    {
+        emu->dram[(emu->addr % EMU_ADDR_MAX) / EMU_NIBBLES_PER_BYTE] = data[i];
+        emu->addr = (emu->addr + EMU_NIBBLES_PER_BYTE) % EMU_ADDR_MAX;
+    }
+    return 0;
+}
+
+int8_t CN91C4S96EmuWriteI2C(uint8_t address, const uint8_t *data, uint16_t size)
+{
+    return CN91C4S96EmuWrite(&CN91C4S96EmuGlobal, address, data, size);
+}
+
+void CN91C4S96EmuVisible(const CN91C4S96Emu_st *emu, uint8_t *frame)
+{
+    if (!emu->sysen || emu->pix == EMU_PIX_OFF)
+        memset(frame, 0x00, EMU_DATA_SIZE);
+    else if (emu->pix == EMU_PIX_ON)
+        memset(frame, 0xff, EMU_DATA_SIZE);
+    else
+        memcpy(frame, emu->dram, EMU_DATA_SIZE);
+}
+
+// segments of digit i in A..G order of EMU_SEG_x bits
+static uint8_t emuDigit(const uint8_t *frame, uint8_t i)
+{
+    return (frame[layout.digitFGE[i]] & EMU_DIGIT_FGE) | (frame[layout.digitABCD[i]] & EMU_DIGIT_ABCD);
+}
+
+// dot after digit i, it separates the digits right of it
+static const CN91C4S96_Seg_st *emuDotSeg(uint8_t i)
+{
+    uint8_t p = EMU_DIGITS - 1 - i;
+    return (p >= 1 && p <= CN91C4S96_LAYOUT_DOTS) ? &layout.dot[p] : NULL;
+}
+
+static bool emuDot(const uint8_t *frame, uint8_t i)
+{
+    const CN91C4S96_Seg_st *dot = emuDotSeg(i);
+    return dot && (frame[dot->pos] & dot->seg);
+}
+
+// append formatted text, keeps counting when out of space like snprintf
+static size_t emuPut(char *out, size_t size, size_t len, const char *s)
+{
+    for (; *s; s++, len++)
+    {
+        if (len + 1 < size)
+        {
+            out[len] = *s;
+            out[len + 1] = 0;
+        }
+    }
+    return len;
+}
+
+size_t CN91C4S96EmuRenderText(const uint8_t *frame, char *out, size_t size)
+{
+    uint8_t used[EMU_DATA_SIZE] = {0};
+    size_t len = 0;
+    char cell[5];
+
+    if (size)
+        out[0] = 0;
+
+    for (uint8_t line = 0; line < 3; line++)
+    {
+        bool minus = line == 1 && (frame[layout.minus.pos] & layout.minus.seg);
+        len = emuPut(out, size, len, minus ? "-- " : "   ");
+        for (uint8_t i = 0; i < EMU_DIGITS; i++)
+        {
+            uint8_t s = emuDigit(frame, i);
+            if (line == 0)
+                snprintf(cell, sizeof(cell), " %c  ", (s & EMU_SEG_A) ? '_' : ' ');
+            else if (line == 1)
+                snprintf(cell, sizeof(cell), "%c%c%c ", (s & EMU_SEG_F) ? '|' : ' ', (s & EMU_SEG_G) ? '_' : ' ',
+                         (s & EMU_SEG_B) ? '|' : ' ');
+            else
+                snprintf(cell, sizeof(cell), "%c%c%c%c", (s & EMU_SEG_E) ? '|' : ' ', (s & EMU_SEG_D) ? '_' : ' ',
+                         (s & EMU_SEG_C) ? '|' : ' ', emuDot(frame, i) ? '.' : ' ');
+            len = emuPut(out, size, len, cell);
+        }
+        len = emuPut(out, size, len, "\n");
+    }
+
+    for (uint8_t i = 0; i < EMU_DIGITS; i++)
+    {
+        used[layout.digitFGE[i]] |= EMU_DIGIT_FGE;
+        used[layout.digitABCD[i]] |= EMU_DIGIT_ABCD;
+        const CN91C4S96_Seg_st *dot = emuDotSeg(i);
+        if (dot)
+            used[dot->pos] |= dot->seg;
+    }
+    used[layout.minus.pos] |= layout.minus.seg;
+
+    len = emuPut(out, size, len, "icons:");
+    for (size_t k = 0; k < CN91C4S96EmuIconsCount; k++)
+    {
+        const CN91C4S96Emu_icon_st *icon = &CN91C4S96EmuIcons[k];
+        used[icon->pos] |= icon->seg;
+        if (icon->seg && (frame[icon->pos] & icon->seg))
+        {
+            len = emuPut(out, size, len, " ");
+            len = emuPut(out, size, len, icon->name);
+        }
+    }
+    // bits which are lit but not described in segment map
+    for (uint8_t pos = 0; pos < EMU_DATA_SIZE; pos++)
+    {
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            if ((frame[pos] & ~used[pos]) & (1 << bit))
+            {
+                char unknown[12];
+                snprintf(unknown, sizeof(unknown), " ?%u.%u", pos, bit);
+                len = emuPut(out, size, len, unknown);
+            }
+        }
+    }
+    return emuPut(out, size, len, "\n");
+}
+
+/**
+ * @brief PNG OUTPUT BLOCK
+ */
+#define PNG_MARGIN 16
+#define PNG_T 6      // segment thickness
+#define PNG_W 26     // segment length
+#define PNG_PITCH 48 // digit cell width
+#define PNG_MINUS_W 32
+#define PNG_DIGIT_H (3 * PNG_T + 2 * PNG_W)
+#define PNG_ICON 12
+#define PNG_ICON_PITCH 16
+#define PNG_ICONS_PER_ROW 20
+#define PNG_WIDTH (2 * PNG_MARGIN + PNG_MINUS_W + EMU_DIGITS * PNG_PITCH)
+#define PNG_ICON_ROWS 3
+#define PNG_HEIGHT (3 * PNG_MARGIN + PNG_DIGIT_H + PNG_ICON_ROWS * PNG_ICON_PITCH)
+
+#define PNG_BACK 230
+#define PNG_GHOST 208
+#define PNG_LIT 24
+
+static uint8_t image[PNG_HEIGHT][PNG_WIDTH];
+
+static void pngRect(int x, int y, int w, int h, bool lit)
+{
+    for (int j = y; j < y + h; j++)
+        for (int i = x; i < x + w; i++)
+            image[j][i] = lit ? PNG_LIT : PNG_GHOST;
+}
+
+static uint32_t pngCrc(uint32_t crc, const uint8_t *p, size_t n)
+{
+    static uint32_t table[256];
+    if (!table[1])
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++)
+                c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+    }
+    crc = ~crc;
+    while (n--)
+        crc = table[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+static void pngBe32(uint8_t *p, uint32_t v)
+{
+    p[0] = v >> 24;
+    p[1] = v >> 16;
+    p[2] = v >> 8;
+    p[3] = v;
+}
+
+static void pngChunk(FILE *f, const char *type, const uint8_t *data, uint32_t len)
+{
+    uint8_t hdr[8];
+    uint8_t crc[4];
+    pngBe32(hdr, len);
+    memcpy(hdr + 4, type, 4);
+    uint32_t c = pngCrc(0, hdr + 4, 4);
+    c = pngCrc(c, data, len);
+    pngBe32(crc, c);
+    fwrite(hdr, 1, sizeof(hdr), f);
+    if (len > 0) // IEND has no data, fwrite wants a valid pointer
+        fwrite(data, 1, len, f);
+    fwrite(crc, 1, sizeof(crc), f);
+}
+
+int CN91C4S96EmuRenderPNG(const uint8_t *frame, const char *path)
+{
+    memset(image, PNG_BACK, sizeof(image));
+
+    int y0 = PNG_MARGIN;
+    pngRect(PNG_MARGIN, y0 + PNG_T + PNG_W, PNG_MINUS_W - 2 * PNG_T, PNG_T, frame[layout.minus.pos] & layout.minus.seg);
+    for (uint8_t i = 0; i < EMU_DIGITS; i++)
+    {
+        uint8_t s = emuDigit(frame, i);
+        int x0 = PNG_MARGIN + PNG_MINUS_W + i * PNG_PITCH;
+        pngRect(x0 + PNG_T, y0, PNG_W, PNG_T, s & EMU_SEG_A);
+        pngRect(x0, y0 + PNG_T, PNG_T, PNG_W, s & EMU_SEG_F);
+        pngRect(x0 + PNG_T + PNG_W, y0 + PNG_T, PNG_T, PNG_W, s & EMU_SEG_B);
+        pngRect(x0 + PNG_T, y0 + PNG_T + PNG_W, PNG_W, PNG_T, s & EMU_SEG_G);
+        pngRect(x0, y0 + 2 * PNG_T + PNG_W, PNG_T, PNG_W, s & EMU_SEG_E);
+        pngRect(x0 + PNG_T + PNG_W, y0 + 2 * PNG_T + PNG_W, PNG_T, PNG_W, s & EMU_SEG_C);
+        pngRect(x0 + PNG_T, y0 + 2 * PNG_T + 2 * PNG_W, PNG_W, PNG_T, s & EMU_SEG_D);
+        if (emuDotSeg(i))
+            pngRect(x0 + 2 * PNG_T + PNG_W + 1, y0 + PNG_DIGIT_H - PNG_T, PNG_T, PNG_T, emuDot(frame, i));
+    }
+    // icons in CN91C4S96_ICONS order, the ones missing on the glass stay blank
+    for (size_t k = 0; k < CN91C4S96EmuIconsCount; k++)
+    {
+        const CN91C4S96Emu_icon_st *icon = &CN91C4S96EmuIcons[k];
+        int x = PNG_MARGIN + (k % PNG_ICONS_PER_ROW) * PNG_ICON_PITCH;
+        int y = 2 * PNG_MARGIN + PNG_DIGIT_H + (k / PNG_ICONS_PER_ROW) * PNG_ICON_PITCH;
+        if (icon->seg)
+            pngRect(x, y, PNG_ICON, PNG_ICON, frame[icon->pos] & icon->seg);
+    }
+
+    // zlib stream of stored deflate blocks, one block per scanline
+    static uint8_t idat[2 + PNG_HEIGHT * (5 + 1 + PNG_WIDTH) + 4];
+    size_t n = 0;
+    uint32_t a = 1, b = 0;
+    idat[n++] = 0x78;
+    idat[n++] = 0x01;
+    for (int y = 0; y < PNG_HEIGHT; y++)
+    {
+        uint16_t len = PNG_WIDTH + 1;
+        idat[n++] = (y == PNG_HEIGHT - 1) ? 1 : 0;
+        idat[n++] = len & 0xff;
+        idat[n++] = len >> 8;
+        idat[n++] = ~len & 0xff;
+        idat[n++] = (~len >> 8) & 0xff;
+        idat[n++] = 0; // filter: none
+        memcpy(&idat[n], image[y], PNG_WIDTH);
+        n += PNG_WIDTH;
+        for (size_t i = n - len; i < n; i++)
+        {
+            a = (a + idat[i]) % 65521;
+            b = (b + a) % 65521;
+        }
+    }
+    pngBe32(&idat[n], (b << 16) | a);
+    n += 4;
+
+    FILE *f = fopen(path, "wb");
+    if (!f)
+        return -1;
+
+    static const uint8_t signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    uint8_t ihdr[13];
+    pngBe32(ihdr, PNG_WIDTH);
+    pngBe32(ihdr + 4, PNG_HEIGHT);
+    ihdr[8] = 8;  // bit depth
+    ihdr[9] = 0;  // grayscale
+    ihdr[10] = 0; // deflate
+    ihdr[11] = 0; // adaptive filtering
+    ihdr[12] = 0; // no interlace
+    fwrite(signature, 1, sizeof(signature), f);
+    pngChunk(f, "IHDR", ihdr, sizeof(ihdr));
+    pngChunk(f, "IDAT", idat, n);
+    pngChunk(f, "IEND", NULL, 0);
+    return fclose(f) == 0 ? 0 : -1;
+}
@@ -0,0 +1,85 @@
+/*******************************************************************************
+Host-side model of the CN91C4S96 controller and PDC-6X1 glass.
+
+Feeds on the same bytes the driver passes to WriteI2C and keeps the
+controller DRAM, so frames can be rendered to text or PNG without hardware.
+*******************************************************************************/
+
+#ifndef CN91C4S96EMU_H_
+#define CN91C4S96EMU_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define EMU_DATA_SIZE 16 // bytes of controller DRAM used by the glass
+#define EMU_SLAVE_ADDRESS 0x7C
+
+typedef enum
+{
+    EMU_PIX_DATA = 0, // segments follow DRAM
+    EMU_PIX_OFF,      // LCDOFF: all segments off
+    EMU_PIX_ON,       // LCDON: all segments on
+} CN91C4S96Emu_pix_en;
+
+typedef struct
+{
+    uint8_t dram[EMU_DATA_SIZE];
+    uint8_t addr; // nibble address for the next data byte
+    bool sysen;
+    bool ulp;
+    CN91C4S96Emu_pix_en pix;
+    uint32_t writes; // number of WriteI2C calls seen
+} CN91C4S96Emu_st;
+
+typedef struct
+{
+    const char *name;
+    uint8_t pos;
+    uint8_t seg;
+} CN91C4S96Emu_icon_st;
+
+/*!
+    * \brief segment map of the glass: every icon with its Buffer byte and bit, seg is 0 if glass has no such icon
+    */
+extern const CN91C4S96Emu_icon_st CN91C4S96EmuIcons[];
+extern const size_t CN91C4S96EmuIconsCount;
+
+/*!
+    * \brief reset controller model to power-on state
+    */
+void CN91C4S96EmuReset(CN91C4S96Emu_st *emu);
+
+/*!
+    * \brief feed one I2C transfer into the controller model
+    *
+    * \return 0 on success, -1 if address doesn't belong to the controller
+    */
+int8_t CN91C4S96EmuWrite(CN91C4S96Emu_st *emu, uint8_t address, const uint8_t *data, uint16_t size);
+
+/*!
+    * \brief WriteI2C compatible function for CN91C4S96_HAL_st. Uses the global model CN91C4S96EmuGlobal
+    */
+int8_t CN91C4S96EmuWriteI2C(uint8_t address, const uint8_t *data, uint16_t size);
+extern CN91C4S96Emu_st CN91C4S96EmuGlobal;
+
+/*!
+    * \brief frame as it is seen on the glass: DRAM with LCDON/LCDOFF/SYSEN applied
+    */
+void CN91C4S96EmuVisible(const CN91C4S96Emu_st *emu, uint8_t *frame);
+
+/*!
+    * \brief render frame to text: seven-segment digits in three lines and a line of lit icon names
+    *
+    * \return number of characters written without terminating zero
+    */
+size_t CN91C4S96EmuRenderText(const uint8_t *frame, char *out, size_t size);
+
+/*!
+    * \brief render frame to grayscale PNG file
+    *
+    * \return 0 on success, -1 on file error
+    */
+int CN91C4S96EmuRenderPNG(const uint8_t *frame, const char *path);
+
+#endif
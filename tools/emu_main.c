@@ -0,0 +1,102 @@
+/*******************************************************************************
+cn91emu - render CN91C4S96 frames on the host.
+
+Build:  cc -O2 -Isrc -o cn91emu tools/emu_main.c tools/CN91C4S96emu.c
+
+Reads text lines with hex bytes from stdin (or file given as last argument).
+By default every line is a 16 byte DRAM frame. With -i every line is one
+WriteI2C transfer to the controller, as the driver sends it.
+
+Options:
+    -i          lines are I2C transfers, frame is printed after each of them
+    -p PREFIX   also write PREFIX_NNNN.png for every frame
+    -q          no text output
+*******************************************************************************/
+
+#include "CN91C4S96emu.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LINE_MAX_BYTES 256
+#define TEXT_SIZE 1024
+
+static size_t parseHex(const char *line, uint8_t *out, size_t max)
+{
+    size_t n = 0;
+    char *end;
+    while (n < max)
+    {
+        unsigned long v = strtoul(line, &end, 16);
+        if (end == line)
+            break;
+        out[n++] = (uint8_t)v;
+        line = end;
+    }
+    return n;
+}
+
+int main(int argc, char **argv)
+{
+    bool i2c = false;
+    bool quiet = false;
+    const char *prefix = NULL;
+    FILE *in = stdin;
+
+    for (int a = 1; a < argc; a++)
+    {
+        if (!strcmp(argv[a], "-i"))
+            i2c = true;
+        else if (!strcmp(argv[a], "-q"))
+            quiet = true;
+        else if (!strcmp(argv[a], "-p") && a + 1 < argc)
+            prefix = argv[++a];
+        else if (!(in = fopen(argv[a], "r")))
+        {
+            perror(argv[a]);
+            return 1;
+        }
+    }
+
+    CN91C4S96Emu_st emu;
+    CN91C4S96EmuReset(&emu);
+
+    char line[LINE_MAX_BYTES * 3 + 16];
+    unsigned frameNo = 0;
+    while (fgets(line, sizeof(line), in))
+    {
+        uint8_t bytes[LINE_MAX_BYTES];
+        uint8_t frame[EMU_DATA_SIZE] = {0};
+        if (line[0] == '#')
+            continue;
+        size_t n = parseHex(line, bytes, LINE_MAX_BYTES);
+        if (n == 0)
+            continue;
+
+        if (i2c)
+        {
+            CN91C4S96EmuWrite(&emu, EMU_SLAVE_ADDRESS, bytes, n);
+            CN91C4S96EmuVisible(&emu, frame);
+        }
+        else
+        {
+            memcpy(frame, bytes, n < EMU_DATA_SIZE ? n : EMU_DATA_SIZE);
+        }
+
+        if (!quiet)
+        {
+            char text[TEXT_SIZE];
+            CN91C4S96EmuRenderText(frame, text, sizeof(text));
+            printf("#%u\n%s", frameNo, text);
+        }
+        if (prefix)
+        {
+            char path[512];
+            snprintf(path, sizeof(path), "%s_%04u.png", prefix, frameNo);
+            if (CN91C4S96EmuRenderPNG(frame, path) != 0)
+                perror(path);
+        }
+        frameNo++;
+    }
+    return 0;
+}
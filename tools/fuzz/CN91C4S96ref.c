@@ -0,0 +1,589 @@
+/*******************************************************************************
+Reference model of the CN91C4S96 renderers. See CN91C4S96ref.h
+*******************************************************************************/
+
+#include "CN91C4S96ref.h"
+#include "CN91C4S96glyphs.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define DIGITS CN91C4S96_LAYOUT_DIGITS
+#define DOTS CN91C4S96_LAYOUT_DOTS
+#define MAX_NUM CN91C4S96_LAYOUT_MAX_NUM
+
+#define ICONS_LANG_BOTH (CN91C4S96_ICONS_RU && CN91C4S96_ICONS_EN)
+
+// segment letter -> bit in the FGE byte (F, G, E are bits 4..6) or in the ABCD byte (bits 0..3)
+static const struct
+{
+    char seg;
+    bool fge;
+    uint8_t bit;
+} segBits[] = {
+    {'a', false, 0x01}, {'b', false, 0x02}, {'c', false, 0x04}, {'d', false, 0x08},
+    {'f', true, 0x10},  {'g', true, 0x20},  {'e', true, 0x40},
+};
+
+//   aaa
+//  f   b
+//   ggg
+//  e   c
+//   ddd
+static const char *charSegs(char c)
+{
+    switch (c)
+    {
+    case '0': return "abcdef";
+    case '1': return "bc";
+    case '2': return "abdeg";
+    case '3': return "abcdg";
+    case '4': return "bcfg";
+    case '5': return "acdfg";
+    case '6': return "acdefg";
+    case '7': return "abc";
+    case '8': return "abcdefg";
+    case '9': return "abcdfg";
+    case 'A': return "abcefg";
+    case 'b': return "cdefg";
+    case 'C': return "adef";
+    case 'd': return "bcdeg";
+    case 'E': return "adefg";
+    case 'F': return "aefg";
+    case '-': return "g";
+    default: return "";
+    }
+}
+
+static void paintSegs(uint8_t *frame, uint8_t pos, const char *segs)
+{
+    uint8_t *fge = &frame[CN91C4S96Layout.digitFGE[pos]];
+    uint8_t *abcd = &frame[CN91C4S96Layout.digitABCD[pos]];
+
+    *fge &= (uint8_t)~0x70;
+    *abcd &= (uint8_t)~0x0f;
+    for (; *segs; segs++)
+    {
+        for (size_t i = 0; i < sizeof(segBits) / sizeof(segBits[0]); i++)
+        {
+            if (segBits[i].seg != *segs)
+                continue;
+            if (segBits[i].fge)
+                *fge |= segBits[i].bit;
+            else
+                *abcd |= segBits[i].bit;
+        }
+    }
+}
+
+static void paintRow(uint8_t *frame, uint8_t first, const char *row, uint8_t width)
+{
+    for (uint8_t i = 0; i < width; i++)
+    {
+        paintSegs(frame, first + i, charSegs(row[i]));
+    }
+}
+
+static void segSet(uint8_t *frame, const CN91C4S96_Seg_st *seg, bool on)
+{
+    if (on)
+        frame[seg->pos] |= seg->seg;
+    else
+        frame[seg->pos] &= (uint8_t)~seg->seg;
+}
+
+static void icon(uint8_t *frame, CN91C4S96_Icon_en id, bool on)
+{
+    segSet(frame, &CN91C4S96Layout.icons[id], on);
+}
+
+// dot right of digit `pos`, if the glass has one there
+static void dotRightOf(uint8_t *frame, int32_t pos, bool on)
+{
+    if (pos < 0 || pos >= DIGITS)
+        return;
+    int32_t dp = DIGITS - 1 - pos;
+    if (dp >= 1 && dp <= DOTS)
+        segSet(frame, &CN91C4S96Layout.dot[dp], on);
+}
+
+// all dots off, then the dot before the last `precision` digits on
+static void dotsShow(uint8_t *frame, int32_t precision)
+{
+    for (int32_t pos = 0; pos < DIGITS; pos++)
+    {
+        dotRightOf(frame, pos, false);
+    }
+    if (precision > 0 && precision < DIGITS)
+        dotRightOf(frame, DIGITS - 1 - precision, true);
+}
+
+void CN91C4S96RefNum(uint8_t *frame, int32_t num, int32_t precision)
+{
+    char row[DIGITS + 1];
+    char text[32];
+    int64_t value = num;
+
+    if (value > MAX_NUM)
+        value = MAX_NUM;
+    if (value < -MAX_NUM)
+        value = -MAX_NUM;
+
+    // "0.05": precision + 1 digits at least, the whole row at most
+    int digits = precision < 0 ? 1 : precision >= DIGITS ? DIGITS : precision + 1;
+    int len = snprintf(text, sizeof(text), "%0*lld", digits, (long long)(value < 0 ? -value : value));
+    bool minusSeg = false;
+
+    memset(row, ' ', DIGITS);
+    memcpy(row + DIGITS - len, text, len);
+    if (value < 0)
+    {
+        if (len < DIGITS)
+            row[DIGITS - len - 1] = '-';
+        else
+            minusSeg = true;
+    }
+    paintRow(frame, 0, row, DIGITS);
+    segSet(frame, &CN91C4S96Layout.minus, minusSeg);
+    dotsShow(frame, 0);
+}
+
+void CN91C4S96RefFixed(uint8_t *frame, int32_t num, uint32_t multiplier)
+{
+    int32_t precision = 0;
+
+    for (uint32_t p = 1, m = 10; p <= 5; p++, m *= 10)
+    {
+        if (multiplier == m)
+            precision = p;
+    }
+    CN91C4S96RefNum(frame, num, precision);
+    dotsShow(frame, precision);
+}
+
+void CN91C4S96RefNumBatch(uint8_t *frame, int32_t num, uint8_t precision)
+{
+    CN91C4S96RefNum(frame, num, precision);
+    dotsShow(frame, precision);
+}
+
+void CN91C4S96RefField(uint8_t *frame, const CN91C4S96Field_st *field, int32_t num, int32_t precision)
+{
+    int first = field->first;
+    int width = field->width;
+
+    if (width == 0 || first + width > DIGITS)
+        return;
+
+    char row[DIGITS + 1];
+    char text[32];
+    bool negative = field->sign && num < 0;
+    bool minusSegOwn = first == 0;
+    // minus takes a digit, except the field at the left edge which may use the minus segment
+    int room = (negative && !minusSegOwn) ? width - 1 : width;
+    int64_t max = 1;
+    for (int i = 0; i < room; i++)
+    {
+        max *= 10;
+    }
+    max -= 1;
+
+    int64_t value = negative ? -(int64_t)num : (num < 0 ? 0 : num);
+    if (value > max)
+        value = max;
+
+    int digits = (field->zeros || precision >= room) ? room : precision < 0 ? 1 : precision + 1;
+    int len = snprintf(text, sizeof(text), "%0*lld", digits, (long long)value);
+    bool minusSeg = false;
+
+    memset(row, ' ', width);
+    memcpy(row + width - len, text, len);
+    if (negative)
+    {
+        if (len < width)
+            row[width - len - 1] = '-';
+        else
+            minusSeg = true;
+    }
+    paintRow(frame, first, row, width);
+    if (minusSegOwn)
+        segSet(frame, &CN91C4S96Layout.minus, minusSeg);
+
+    // the dots between digits of the field belong to it
+    for (int pos = first; pos < first + width - 1; pos++)
+    {
+        dotRightOf(frame, pos, false);
+    }
+    if (precision > 0 && precision < width)
+        dotRightOf(frame, first + width - 1 - precision, true);
+}
+
+#if CN91C4S96_USE_FLOAT
+void CN91C4S96RefFloat(uint8_t *frame, float num, uint8_t precision)
+{
+    int32_t p = precision > DOTS ? DOTS : precision;
+    double scaled = trunc((double)num * pow(10, p));
+
+    if (isnan(scaled))
+        scaled = 0;
+    if (scaled > MAX_NUM)
+        scaled = MAX_NUM;
+    if (scaled < -MAX_NUM)
+        scaled = -MAX_NUM;
+    CN91C4S96RefNum(frame, (int32_t)scaled, p);
+    dotsShow(frame, p);
+}
+#endif //CN91C4S96_USE_FLOAT
+
+#if CN91C4S96_USE_TEXT
+#define UTF8_BAD 0xFFFFFFFF
+
+static const uint8_t glyphsAscii[] = {
+    CN91C4S96_GLYPHS_ASCII,
+#if CN91C4S96_USE_LETTERS
+    CN91C4S96_GLYPHS_ASCII_LETTERS,
+#endif
+};
+
+#if CN91C4S96_USE_LETTERS
+// only the pairs of the hash table are used, it is searched from start to end
+static const struct
+{
+    uint16_t cp;
+    uint8_t glyph;
+} glyphsOther[] = {CN91C4S96_GLYPHS_HASH};
+#endif
+
+// lead byte 0xxxxxxx, 110xxxxx, 1110xxxx or 11110xxx (and 11111xxx) and its 10xxxxxx bytes.
+// A stray 10xxxxxx byte or a sequence broken by another byte is one bad character
+static uint32_t utf8Decode(const uint8_t **s)
+{
+    const uint8_t *p = *s;
+    int len = (p[0] < 0x80) ? 1 : (p[0] < 0xC0) ? 0 : (p[0] < 0xE0) ? 2 : (p[0] < 0xF0) ? 3 : 4;
+
+    if (len <= 1)
+    {
+        *s = p + 1;
+        return len ? p[0] : UTF8_BAD;
+    }
+    uint32_t cp = p[0] & (0x7F >> len);
+    for (int i = 1; i < len; i++)
+    {
+        if ((p[i] & 0xC0) != 0x80)
+        {
+            *s = p + i;
+            return UTF8_BAD;
+        }
+        cp = (cp << 6) | (p[i] & 0x3F);
+    }
+    *s = p + len;
+    return cp;
+}
+
+// glyph in the glyphs.map format: a 0x10, b 0x20, c 0x40, d 0x08, e 0x04, f 0x01, g 0x02
+static uint8_t glyphOf(uint32_t cp)
+{
+    if (cp >= 0x20 && cp < 0x20 + sizeof(glyphsAscii))
+        return glyphsAscii[cp - 0x20];
+#if CN91C4S96_USE_LETTERS
+    if (cp >= 0x430 && cp <= 0x44F) // а..я
+        cp -= 0x20;
+    if (cp == 0x451) // ё
+        cp = 0x401;
+    for (size_t i = 0; i < sizeof(glyphsOther) / sizeof(glyphsOther[0]); i++)
+    {
+        if (glyphsOther[i].cp != 0 && glyphsOther[i].cp == cp)
+            return glyphsOther[i].glyph;
+    }
+#endif
+    return 0;
+}
+
+void CN91C4S96RefStr(uint8_t *frame, const char *str)
+{
+    static const struct
+    {
+        char seg;
+        uint8_t bit;
+    } mapBits[] = {{'a', 0x10}, {'b', 0x20}, {'c', 0x40}, {'d', 0x08}, {'e', 0x04}, {'f', 0x01}, {'g', 0x02}};
+    const uint8_t *s = (const uint8_t *)str;
+
+    // digits and dots are cleared, minus segment is kept
+    paintRow(frame, 0, "                ", DIGITS);
+    dotsShow(frame, 0);
+    for (uint8_t pos = 0; pos < DIGITS && *s; pos++)
+    {
+        uint8_t glyph = glyphOf(utf8Decode(&s));
+        char segs[8];
+        size_t n = 0;
+
+        for (size_t i = 0; i < sizeof(mapBits) / sizeof(mapBits[0]); i++)
+        {
+            if (glyph & mapBits[i].bit)
+                segs[n++] = mapBits[i].seg;
+        }
+        segs[n] = '\0';
+        paintSegs(frame, pos, segs);
+    }
+}
+#endif //CN91C4S96_USE_TEXT
+
+#if CN91C4S96_USE_CLOCK
+// "DD.MM.YY" or "HH-MM-SS" right aligned, `text` holds the 6 digits
+static void clockShow(uint8_t *frame, const char *text, bool date)
+{
+    char row[DIGITS + 1];
+    char *clock = row + DIGITS - 8;
+
+    memset(row, ' ', DIGITS);
+    if (date)
+        sprintf(clock, "  %.6s", text);
+    else
+        sprintf(clock, "%.2s-%.2s-%.2s", text, text + 2, text + 4);
+    paintRow(frame, 0, row, DIGITS);
+    segSet(frame, &CN91C4S96Layout.minus, false);
+    dotsShow(frame, 0);
+    if (date)
+    {
+        dotRightOf(frame, DIGITS - 5, true);
+        dotRightOf(frame, DIGITS - 3, true);
+    }
+}
+
+void CN91C4S96RefDate(uint8_t *frame, int32_t day, int32_t mon, int32_t year)
+{
+    char text[8];
+
+    // two last digits, negative as 00
+    snprintf(text, sizeof(text), "%02d%02d%02d", day < 0 ? 0 : day % 100, mon < 0 ? 0 : mon % 100,
+             year < 0 ? 0 : year % 100);
+    clockShow(frame, text, true);
+}
+
+static void bcdText(char *text, uint8_t a, uint8_t b, uint8_t c)
+{
+    uint8_t bytes[] = {a, b, c};
+
+    // nibbles above 9 are shown as 9
+    for (int i = 0; i < 3; i++)
+    {
+        text[2 * i] = '0' + ((bytes[i] >> 4) > 9 ? 9 : (bytes[i] >> 4));
+        text[2 * i + 1] = '0' + ((bytes[i] & 0xf) > 9 ? 9 : (bytes[i] & 0xf));
+    }
+    text[6] = '\0';
+}
+
+void CN91C4S96RefDateBCD(uint8_t *frame, uint8_t day, uint8_t mon, uint8_t year)
+{
+    char text[8];
+
+    bcdText(text, day, mon, year);
+    clockShow(frame, text, true);
+}
+
+void CN91C4S96RefTime(uint8_t *frame, uint8_t hours, uint8_t minutes, uint8_t seconds)
+{
+    char text[8];
+
+    // above 99 as 99
+    snprintf(text, sizeof(text), "%02d%02d%02d", hours > 99 ? 99 : hours, minutes > 99 ? 99 : minutes,
+             seconds > 99 ? 99 : seconds);
+    clockShow(frame, text, false);
+}
+
+void CN91C4S96RefTimeBCD(uint8_t *frame, uint8_t hours, uint8_t minutes, uint8_t seconds)
+{
+    char text[8];
+
+    bcdText(text, hours, minutes, seconds);
+    clockShow(frame, text, false);
+}
+#endif //CN91C4S96_USE_CLOCK
+
+// low `digits` characters of `text` right aligned, 0 digits: text without its leading zeros
+static void codeShow(uint8_t *frame, const char *text, int digits, int group)
+{
+    char row[DIGITS + 1];
+    int len = (int)strlen(text);
+    int shown = digits;
+
+    if (shown == 0)
+    {
+        shown = len;
+        while (shown > 1 && text[len - shown] == '0')
+            shown--;
+    }
+    if (shown > len)
+        shown = len;
+    if (shown > DIGITS)
+        shown = DIGITS;
+
+    memset(row, ' ', DIGITS);
+    memcpy(row + DIGITS - shown, text + len - shown, shown);
+    paintRow(frame, 0, row, DIGITS);
+    segSet(frame, &CN91C4S96Layout.minus, false);
+    dotsShow(frame, 0);
+    for (int dp = group; group > 0 && dp < shown; dp += group)
+    {
+        dotRightOf(frame, DIGITS - 1 - dp, true);
+    }
+}
+
+void CN91C4S96RefHex(uint8_t *frame, uint32_t value, uint8_t digits, uint8_t group)
+{
+    char text[16];
+
+    snprintf(text, sizeof(text), "%08X", (unsigned)value);
+    for (char *c = text; *c; c++)
+    {
+        if (*c == 'B' || *c == 'D')
+            *c += 'a' - 'A';
+    }
+    codeShow(frame, text, digits, group);
+}
+
+void CN91C4S96RefBCD(uint8_t *frame, uint32_t bcd, uint8_t digits, uint8_t group)
+{
+    char text[16];
+
+    snprintf(text, sizeof(text), "%08X", (unsigned)bcd);
+    for (char *c = text; *c; c++)
+    {
+        if (*c > '9')
+            *c = '-';
+    }
+    codeShow(frame, text, digits, group);
+}
+
+void CN91C4S96RefBin(uint8_t *frame, uint32_t value, uint8_t digits, uint8_t group)
+{
+    char text[33];
+
+    for (int i = 0; i < 32; i++)
+    {
+        text[i] = (value & (0x80000000u >> i)) ? '1' : '0';
+    }
+    text[32] = 0;
+    codeShow(frame, text, digits, group);
+}
+
+void CN91C4S96RefBattery(uint8_t *frame, uint8_t percents)
+{
+    icon(frame, ICON_BAT4, true);
+    icon(frame, ICON_BAT3, percents > 25);
+    icon(frame, ICON_BAT2, percents > 50);
+    icon(frame, ICON_BAT1, percents > 75);
+}
+
+void CN91C4S96RefSignal(uint8_t *frame, uint8_t percents)
+{
+    icon(frame, ICON_SIG1, percents > 0);
+    icon(frame, ICON_SIG2, percents > 30);
+    icon(frame, ICON_SIG3, percents > 60);
+}
+
+void CN91C4S96RefSetter(uint8_t *frame, CN91C4S96Ref_setter_en setter, bool a, bool b, bool c)
+{
+    // setters with one icon which follows `a`
+    static const CN91C4S96_Icon_en single[] = {
+        [REF_SET_SN] = ICON_SN,         [REF_SET_WARN] = ICON_WARN,   [REF_SET_MAGN] = ICON_MAGNET,
+        [REF_SET_LEFT] = ICON_LEFT,     [REF_SET_RIGHT] = ICON_RIGHT, [REF_SET_NOWATER] = ICON_NOWATER,
+        [REF_SET_CRC] = ICON_CRC,       [REF_SET_DELTA] = ICON_DELTA, [REF_SET_T] = ICON_T,
+        [REF_SET_T1] = ICON_T1,         [REF_SET_T2] = ICON_T2,       [REF_SET_NBFI] = ICON_NBFI,
+        [REF_SET_NBIOT] = ICON_NBIOT,   [REF_SET_DEGREE] = ICON_DEGREE, [REF_SET_FROST] = ICON_FROST,
+        [REF_SET_Q] = ICON_Q,           [REF_SET_MMBTU] = ICON_MMBTU,
+    };
+    // RU or EN icon selected by `b`, the other one off
+    static const CN91C4S96_Icon_en pair[][2] = {
+        [REF_SET_BURST] = {ICON_BURST_RU, ICON_BURST_EN}, [REF_SET_LEAK] = {ICON_LEAK_RU, ICON_LEAK_EN},
+        [REF_SET_REV] = {ICON_REV_RU, ICON_REV_EN},       [REF_SET_VER] = {ICON_VER_RU, ICON_VER_EN},
+        [REF_SET_SP] = {ICON_SP_RU, ICON_SP_EN},          [REF_SET_RP] = {ICON_RP_RU, ICON_RP_EN},
+    };
+    // `mode` argument picks the language only when both are built in
+    bool ru = ICONS_LANG_BOTH ? b : CN91C4S96_ICONS_RU;
+
+    switch (setter)
+    {
+    case REF_SET_MINMAX:
+        if (!a)
+        {
+            icon(frame, ICON_MIN_RU, false);
+            icon(frame, ICON_MAX_RU, false);
+            icon(frame, ICON_MIN_EN, false);
+            icon(frame, ICON_MAX_EN, false);
+        }
+        else // MIN or MAX of the selected language, the other language is left as is
+        {
+            icon(frame, ru ? ICON_MIN_RU : ICON_MIN_EN, c);
+            icon(frame, ru ? ICON_MAX_RU : ICON_MAX_EN, !c);
+        }
+        break;
+    case REF_SET_BURST:
+    case REF_SET_LEAK:
+    case REF_SET_REV:
+    case REF_SET_VER:
+        icon(frame, pair[setter][0], a && ru);
+        icon(frame, pair[setter][1], a && !ru);
+        break;
+    case REF_SET_SP:
+    case REF_SET_RP:
+        // enable adds the selected language, disable clears both
+        if (a)
+            icon(frame, pair[setter][ru ? 0 : 1], true);
+        else
+        {
+            icon(frame, pair[setter][0], false);
+            icon(frame, pair[setter][1], false);
+        }
+        break;
+    case REF_SET_ENERGY_J:
+        // b: Gcal instead of GJ, c: per hour. Enable leaves the other unit as is
+        if (a)
+        {
+            icon(frame, b ? ICON_GCAL : ICON_GJ, true);
+            icon(frame, b ? ICON_GCAL_H : ICON_GJ_H, c);
+        }
+        else
+        {
+            icon(frame, ICON_GJ, false);
+            icon(frame, ICON_GJ_H, false);
+            icon(frame, ICON_GCAL, false);
+            icon(frame, ICON_GCAL_H, false);
+        }
+        break;
+    case REF_SET_ENERGY_W:
+        // b: MW instead of kW, c: per hour
+        icon(frame, ICON_W, a);
+        icon(frame, ICON_MW, a && b);
+        icon(frame, ICON_KW, a && !b);
+        icon(frame, ICON_WH, a && c);
+        break;
+    case REF_SET_FLOW_M3:
+        // c: per hour, which has an extra EN segment
+        icon(frame, ICON_M3, a);
+        icon(frame, ICON_M3_H, a && c);
+        icon(frame, ICON_M3_H_EN, a && c && !ru);
+        break;
+    case REF_SET_FLOW_GAL:
+        icon(frame, ICON_GAL, a);
+        icon(frame, ICON_GAL_PM, a && b);
+        break;
+    case REF_SET_FLOW_FT:
+        icon(frame, ICON_FT3, a);
+        icon(frame, ICON_FT3_PM, a && b);
+        break;
+    case REF_SET_GAL:
+        icon(frame, ICON_GALLONS, a);
+        icon(frame, ICON_US, a && b);
+        break;
+    case REF_SET_POV:
+        // POV is shown with the VER RU segment
+        icon(frame, ICON_POV, a);
+        icon(frame, ICON_VER_RU, a);
+        break;
+    default:
+        if ((size_t)setter < sizeof(single) / sizeof(single[0]))
+            icon(frame, single[setter], a);
+        break;
+    }
+}
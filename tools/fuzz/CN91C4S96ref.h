@@ -0,0 +1,83 @@
+/*******************************************************************************
+Reference model of the CN91C4S96 renderers, used by the differential fuzzer.
+
+Written from the API description, as plain as possible and without code of
+src/CN91C4S96.c: numbers are formatted by snprintf, glyphs are lists of
+segment letters, UTF-8 is decoded by the textbook rules and the clock is
+drawn from scratch on every call. Only the glass layout table and the glyph
+map data come from the driver build. Speed doesn't matter here.
+
+Every function changes the same bits of `frame` as the driver function of
+the same name changes in Buffer.
+*******************************************************************************/
+
+#ifndef CN91C4S96REF_H_
+#define CN91C4S96REF_H_
+
+#include "CN91C4S96.h"
+
+// icon setters of CN91C4S96.h, arguments are passed as `a`, `b`, `c` in declaration order
+typedef enum
+{
+    REF_SET_SN = 0,
+    REF_SET_WARN,
+    REF_SET_MAGN,
+    REF_SET_LEFT,
+    REF_SET_RIGHT,
+    REF_SET_NOWATER,
+    REF_SET_CRC,
+    REF_SET_DELTA,
+    REF_SET_T,
+    REF_SET_T1,
+    REF_SET_T2,
+    REF_SET_NBFI,
+    REF_SET_NBIOT,
+    REF_SET_DEGREE,
+    REF_SET_FROST,
+    REF_SET_Q,
+    REF_SET_MMBTU,
+    REF_SET_MINMAX,
+    REF_SET_BURST,
+    REF_SET_LEAK,
+    REF_SET_REV,
+    REF_SET_VER,
+    REF_SET_SP,
+    REF_SET_RP,
+    REF_SET_ENERGY_J,
+    REF_SET_ENERGY_W,
+    REF_SET_FLOW_M3,
+    REF_SET_FLOW_GAL,
+    REF_SET_FLOW_FT,
+    REF_SET_GAL,
+    REF_SET_POV,
+    REF_SET_COUNT
+} CN91C4S96Ref_setter_en;
+
+void CN91C4S96RefNum(uint8_t *frame, int32_t num, int32_t precision);
+void CN91C4S96RefFixed(uint8_t *frame, int32_t num, uint32_t multiplier);
+// one frame of CN91C4S96RenderNumBatch rendered over `frame`
+void CN91C4S96RefNumBatch(uint8_t *frame, int32_t num, uint8_t precision);
+void CN91C4S96RefField(uint8_t *frame, const CN91C4S96Field_st *field, int32_t num, int32_t precision);
+void CN91C4S96RefHex(uint8_t *frame, uint32_t value, uint8_t digits, uint8_t group);
+void CN91C4S96RefBCD(uint8_t *frame, uint32_t bcd, uint8_t digits, uint8_t group);
+void CN91C4S96RefBin(uint8_t *frame, uint32_t value, uint8_t digits, uint8_t group);
+void CN91C4S96RefBattery(uint8_t *frame, uint8_t percents);
+void CN91C4S96RefSignal(uint8_t *frame, uint8_t percents);
+void CN91C4S96RefSetter(uint8_t *frame, CN91C4S96Ref_setter_en setter, bool a, bool b, bool c);
+
+#if CN91C4S96_USE_FLOAT
+void CN91C4S96RefFloat(uint8_t *frame, float num, uint8_t precision);
+#endif
+
+#if CN91C4S96_USE_TEXT
+void CN91C4S96RefStr(uint8_t *frame, const char *str);
+#endif
+
+#if CN91C4S96_USE_CLOCK
+void CN91C4S96RefDate(uint8_t *frame, int32_t day, int32_t mon, int32_t year);
+void CN91C4S96RefDateBCD(uint8_t *frame, uint8_t day, uint8_t mon, uint8_t year);
+void CN91C4S96RefTime(uint8_t *frame, uint8_t hours, uint8_t minutes, uint8_t seconds);
+void CN91C4S96RefTimeBCD(uint8_t *frame, uint8_t hours, uint8_t minutes, uint8_t seconds);
+#endif
+
+#endif
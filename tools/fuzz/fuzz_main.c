@@ -0,0 +1,587 @@
+/*******************************************************************************
+cn91fuzz - differential fuzzer of the CN91C4S96 renderers.
+
+An input is a program of print and icon calls. Every call is run by the
+driver, into Buffer, and by the reference model of CN91C4S96ref.c, into its
+own frame, and after every call the two 16 byte frames must be equal. A
+difference is printed with the call and the process aborts, so libFuzzer
+and AFL keep the input as a crash. Optimized renderers must keep it silent.
+
+libFuzzer (clang):
+    clang -g -O1 -fsanitize=fuzzer,address,undefined -DCN91C4S96_LIBFUZZER -Itools/fuzz -Isrc -o cn91fuzz \
+        tools/fuzz/fuzz_main.c tools/fuzz/CN91C4S96ref.c src/CN91C4S96.c src/CN91C4S96ctrl.c -lm
+    ./cn91fuzz corpus/
+
+AFL and plain builds have own main, the same command without
+-DCN91C4S96_LIBFUZZER and -fsanitize=fuzzer (afl-clang-fast or cc):
+    ./cn91fuzz < input          run one input, the way afl-fuzz calls it
+    ./cn91fuzz crash-1 ...      replay input files
+    ./cn91fuzz -r 1000000 -s 7  run random programs, seed is optional
+
+Configurations of CN91C4S96config.h are fuzzed with the same -D switches
+as the driver is built with. Calls of disabled features are skipped.
+
+Input: calls one after another, every call is an opcode byte (taken modulo
+the number of calls) and its arguments, little endian. Missing bytes at the
+end of input are 0.
+    0 printNum      num:4 precision:4
+    1 printFixed    num:4 multiplier:4
+    2 printFloat    num:4 (float) precision:1
+    3 printField    first:1 width:1 flags:1 (1 zeros, 2 sign) num:4 precision:4
+    4 printDate     day:4 mon:4 year:4
+    5 printDateBCD  day:1 mon:1 year:1
+    6 printTime     hours:1 minutes:1 seconds:1
+    7 printTimeBCD  hours:1 minutes:1 seconds:1
+    8 printStr      length:1 (up to 32) bytes:length
+    9 batteryLevel  percents:1
+   10 SignalLevel   percents:1
+   11 icon setter   setter:1 (CN91C4S96Ref_setter_en) flags:1 (arguments in bits 0..2)
+   12 printHex      value:4 digits:1 group:1
+   13 printBCD      bcd:4 digits:1 group:1
+   14 printBin      value:4 digits:1 group:1
+   15 RenderNumBatch value:4 precision:1, rendered over Buffer. The frame must
+                    also equal printNum and the dot of the precision in Buffer
+*******************************************************************************/
+
+#include "CN91C4S96ref.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#define STR_MAX 32
+#define PROGRAM_MAX 512 // bytes of one random program
+#define COUNT(A) (sizeof(A) / sizeof((A)[0]))
+
+typedef enum
+{
+    OP_NUM = 0,
+    OP_FIXED,
+    OP_FLOAT,
+    OP_FIELD,
+    OP_DATE,
+    OP_DATE_BCD,
+    OP_TIME,
+    OP_TIME_BCD,
+    OP_STR,
+    OP_BATTERY,
+    OP_SIGNAL,
+    OP_SETTER,
+    OP_HEX,
+    OP_BCD,
+    OP_BIN,
+    OP_BATCH,
+    OP_COUNT
+} Op_en;
+
+static const char *const opNames[OP_COUNT] = {
+    "printNum", "printFixed", "printFloat", "printField", "printDate", "printDateBCD",
+    "printTime", "printTimeBCD", "printStr", "batteryLevel", "SignalLevel", "setter",
+    "printHex", "printBCD", "printBin", "RenderNumBatch",
+};
+
+typedef struct
+{
+    uint8_t op;
+    int32_t n[3];     // numbers, precision, date fields
+    uint32_t mult;    // printFixed multiplier
+    float f;          // printFloat number
+    uint8_t u[3];     // byte arguments
+    CN91C4S96Field_st field;
+    char str[STR_MAX + 1];
+} Call_st;
+
+typedef struct
+{
+    const uint8_t *p;
+    size_t left;
+} Input_st;
+
+extern uint8_t *Buffer;
+// clear Buffer and clock state, see CN91C4S96.c
+void AllClear();
+// set the dot of precision in Buffer, see CN91C4S96.c
+void decimalSeparator(uint8_t dpPosition);
+
+static uint8_t batchFrame[DATA_SIZE]; // output of the last RenderNumBatch call
+
+static uint8_t get8(Input_st *in)
+{
+    if (in->left == 0)
+        return 0;
+    in->left--;
+    return *in->p++;
+}
+
+static uint32_t get32(Input_st *in)
+{
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        v |= (uint32_t)get8(in) << (8 * i);
+    }
+    return v;
+}
+
+static void decode(Input_st *in, Call_st *call)
+{
+    memset(call, 0, sizeof(*call));
+    call->op = get8(in) % OP_COUNT;
+
+    switch (call->op)
+    {
+    case OP_NUM:
+        call->n[0] = (int32_t)get32(in);
+        call->n[1] = (int32_t)get32(in);
+        break;
+    case OP_FIXED:
+        call->n[0] = (int32_t)get32(in);
+        call->mult = get32(in);
+        break;
+    case OP_FLOAT:
+    {
+        uint32_t bits = get32(in);
+        memcpy(&call->f, &bits, sizeof(call->f));
+        call->u[0] = get8(in);
+        break;
+    }
+    case OP_FIELD:
+        call->field.first = get8(in);
+        call->field.width = get8(in);
+        call->u[0] = get8(in);
+        call->field.zeros = call->u[0] & 1;
+        call->field.sign = call->u[0] & 2;
+        call->n[0] = (int32_t)get32(in);
+        call->n[1] = (int32_t)get32(in);
+        break;
+    case OP_DATE:
+        for (int i = 0; i < 3; i++)
+        {
+            call->n[i] = (int32_t)get32(in);
+        }
+        break;
+    case OP_STR:
+    {
+        uint8_t len = get8(in) % (STR_MAX + 1);
+        for (uint8_t i = 0; i < len; i++)
+        {
+            call->str[i] = (char)get8(in);
+        }
+        break;
+    }
+    case OP_HEX:
+    case OP_BCD:
+    case OP_BIN:
+        call->n[0] = (int32_t)get32(in);
+        call->u[0] = get8(in);
+        call->u[1] = get8(in);
+        break;
+    case OP_BATCH:
+        call->n[0] = (int32_t)get32(in);
+        call->u[0] = get8(in);
+        break;
+    case OP_DATE_BCD:
+    case OP_TIME:
+    case OP_TIME_BCD:
+        for (int i = 0; i < 3; i++)
+        {
+            call->u[i] = get8(in);
+        }
+        break;
+    default: // one or two bytes
+        call->u[0] = get8(in);
+        if (call->op == OP_SETTER)
+            call->u[1] = get8(in);
+        break;
+    }
+}
+
+static void driverSetter(uint8_t setter, bool a, bool b, bool c)
+{
+    switch (setter)
+    {
+    case REF_SET_SN: CN91C4S96DispSN(a); break;
+    case REF_SET_WARN: CN91C4S96DispWarn(a); break;
+    case REF_SET_MAGN: CN91C4S96DispMagn(a); break;
+    case REF_SET_LEFT: CN91C4S96DispLeft(a); break;
+    case REF_SET_RIGHT: CN91C4S96DispRight(a); break;
+    case REF_SET_NOWATER: CN91C4S96DispNoWater(a); break;
+    case REF_SET_CRC: CN91C4S96DispCRC(a); break;
+    case REF_SET_DELTA: CN91C4S96DispDelta(a); break;
+    case REF_SET_T: CN91C4S96DispT(a); break;
+    case REF_SET_T1: CN91C4S96Disp1(a); break;
+    case REF_SET_T2: CN91C4S96DispT2(a); break;
+    case REF_SET_NBFI: CN91C4S96DispNBFi(a); break;
+    case REF_SET_NBIOT: CN91C4S96DispNBIoT(a); break;
+    case REF_SET_DEGREE: CN91C4S96DispDegreePoint(a); break;
+    case REF_SET_FROST: CN91C4S96DispFrost(a); break;
+    case REF_SET_Q: CN91C4S96DispQ(a); break;
+    case REF_SET_MMBTU: CN91C4S96DispMMBTU(a); break;
+    case REF_SET_MINMAX: CN91C4S96DispMinMax(a, b, c); break;
+    case REF_SET_BURST: CN91C4S96DispBurst(a, b); break;
+    case REF_SET_LEAK: CN91C4S96DispLeak(a, b); break;
+    case REF_SET_REV: CN91C4S96DispRev(a, b); break;
+    case REF_SET_VER: CN91C4S96DispVer(a, b); break;
+    case REF_SET_SP: CN91C4S96DispSP(a, b); break;
+    case REF_SET_RP: CN91C4S96DispRP(a, b); break;
+    case REF_SET_ENERGY_J: CN91C4S96DispEnergyJ(a, b, c); break;
+    case REF_SET_ENERGY_W: CN91C4S96DispEnergyW(a, b, c); break;
+    case REF_SET_FLOW_M3: CN91C4S96DispFlowM3(a, b, c); break;
+    case REF_SET_FLOW_GAL: CN91C4S96DispFlowGAL(a, b); break;
+    case REF_SET_FLOW_FT: CN91C4S96DispFlowFT(a, b); break;
+    case REF_SET_GAL: CN91C4S96DispGal(a, b); break;
+    case REF_SET_POV: CN91C4S96DispPOV(a); break;
+    }
+}
+
+// run call by driver and reference model
+static void execute(const Call_st *call, uint8_t *ref)
+{
+    switch (call->op)
+    {
+    case OP_NUM:
+        CN91C4S96printNum(call->n[0], call->n[1]);
+        CN91C4S96RefNum(ref, call->n[0], call->n[1]);
+        break;
+    case OP_FIXED:
+        CN91C4S96printFixed(call->n[0], call->mult);
+        CN91C4S96RefFixed(ref, call->n[0], call->mult);
+        break;
+#if CN91C4S96_USE_FLOAT
+    case OP_FLOAT:
+        CN91C4S96printFloat(call->f, call->u[0]);
+        CN91C4S96RefFloat(ref, call->f, call->u[0]);
+        break;
+#endif
+    case OP_FIELD:
+        CN91C4S96printField(&call->field, call->n[0], call->n[1]);
+        CN91C4S96RefField(ref, &call->field, call->n[0], call->n[1]);
+        break;
+#if CN91C4S96_USE_CLOCK
+    case OP_DATE:
+        CN91C4S96printDate(call->n[0], call->n[1], call->n[2]);
+        CN91C4S96RefDate(ref, call->n[0], call->n[1], call->n[2]);
+        break;
+    case OP_DATE_BCD:
+        CN91C4S96printDateBCD(call->u[0], call->u[1], call->u[2]);
+        CN91C4S96RefDateBCD(ref, call->u[0], call->u[1], call->u[2]);
+        break;
+    case OP_TIME:
+        CN91C4S96printTime(call->u[0], call->u[1], call->u[2]);
+        CN91C4S96RefTime(ref, call->u[0], call->u[1], call->u[2]);
+        break;
+    case OP_TIME_BCD:
+        CN91C4S96printTimeBCD(call->u[0], call->u[1], call->u[2]);
+        CN91C4S96RefTimeBCD(ref, call->u[0], call->u[1], call->u[2]);
+        break;
+#endif
+#if CN91C4S96_USE_TEXT
+    case OP_STR:
+        CN91C4S96printStr(call->str);
+        CN91C4S96RefStr(ref, call->str);
+        break;
+#endif
+    case OP_HEX:
+        CN91C4S96printHex((uint32_t)call->n[0], call->u[0], call->u[1]);
+        CN91C4S96RefHex(ref, (uint32_t)call->n[0], call->u[0], call->u[1]);
+        break;
+    case OP_BCD:
+        CN91C4S96printBCD((uint32_t)call->n[0], call->u[0], call->u[1]);
+        CN91C4S96RefBCD(ref, (uint32_t)call->n[0], call->u[0], call->u[1]);
+        break;
+    case OP_BIN:
+        CN91C4S96printBin((uint32_t)call->n[0], call->u[0], call->u[1]);
+        CN91C4S96RefBin(ref, (uint32_t)call->n[0], call->u[0], call->u[1]);
+        break;
+    case OP_BATCH:
+        // rendered over Buffer, then the same number is printed into Buffer for the comparison
+        CN91C4S96RenderNumBatch(&call->n[0], &call->u[0], Buffer, 0, batchFrame, 1);
+        CN91C4S96printNum(call->n[0], call->u[0]);
+        decimalSeparator(call->u[0]);
+        CN91C4S96RefNumBatch(ref, call->n[0], call->u[0]);
+        break;
+    case OP_BATTERY:
+        CN91C4S96batteryLevel(call->u[0]);
+        CN91C4S96RefBattery(ref, call->u[0]);
+        break;
+    case OP_SIGNAL:
+        CN91C4S96SignalLevel(call->u[0]);
+        CN91C4S96RefSignal(ref, call->u[0]);
+        break;
+    case OP_SETTER:
+    {
+        uint8_t setter = call->u[0] % REF_SET_COUNT;
+        bool a = call->u[1] & 1, b = call->u[1] & 2, c = call->u[1] & 4;
+        driverSetter(setter, a, b, c);
+        CN91C4S96RefSetter(ref, setter, a, b, c);
+        break;
+    }
+    default: // feature is switched off
+        break;
+    }
+}
+
+static void printFrame(const char *name, const uint8_t *frame, const uint8_t *other)
+{
+    fprintf(stderr, "%-10s", name);
+    for (int i = 0; i < DATA_SIZE; i++)
+    {
+        fprintf(stderr, " %02x%c", frame[i], frame[i] != other[i] ? '*' : ' ');
+    }
+    fprintf(stderr, "\n");
+}
+
+static void report(unsigned index, const Call_st *call, const uint8_t *ref)
+{
+    fprintf(stderr, "cn91fuzz: frames differ after call %u: %s", index, opNames[call->op]);
+    switch (call->op)
+    {
+    case OP_FLOAT:
+        fprintf(stderr, "(%.9g, %u)", call->f, call->u[0]);
+        break;
+    case OP_FIELD:
+        fprintf(stderr, "({%u, %u, %d, %d}, %d, %d)", call->field.first, call->field.width, call->field.zeros,
+                call->field.sign, call->n[0], call->n[1]);
+        break;
+    case OP_FIXED:
+        fprintf(stderr, "(%d, %u)", call->n[0], call->mult);
+        break;
+    case OP_BATCH:
+        fprintf(stderr, "(%d, %u)", call->n[0], call->u[0]);
+        break;
+    case OP_NUM:
+    case OP_DATE:
+        fprintf(stderr, "(%d, %d, %d)", call->n[0], call->n[1], call->n[2]);
+        break;
+    case OP_HEX:
+    case OP_BCD:
+    case OP_BIN:
+        fprintf(stderr, "(0x%08x, %u, %u)", (uint32_t)call->n[0], call->u[0], call->u[1]);
+        break;
+    case OP_STR:
+        fprintf(stderr, "(\"");
+        for (const char *s = call->str; *s; s++)
+        {
+            fprintf(stderr, (*s >= ' ' && *s < 0x7f) ? "%c" : "\\x%02x", (uint8_t)*s);
+        }
+        fprintf(stderr, "\")");
+        break;
+    default:
+        fprintf(stderr, "(%u, %u, %u)", call->u[0], call->u[1], call->u[2]);
+        break;
+    }
+    fprintf(stderr, "\n");
+    printFrame("driver", Buffer, ref);
+    printFrame("reference", ref, Buffer);
+}
+
+// run all calls of input from an empty display, abort on the first difference
+static void runProgram(const uint8_t *data, size_t size)
+{
+    Input_st in = {data, size};
+    uint8_t ref[DATA_SIZE] = {0};
+    Call_st call;
+
+    AllClear();
+    for (unsigned index = 0; in.left > 0; index++)
+    {
+        decode(&in, &call);
+        execute(&call, ref);
+        if (memcmp(Buffer, ref, DATA_SIZE) != 0)
+        {
+            report(index, &call, ref);
+            abort();
+        }
+        if (call.op == OP_BATCH && memcmp(batchFrame, Buffer, DATA_SIZE) != 0)
+        {
+            fprintf(stderr, "cn91fuzz: RenderNumBatch differs from printNum after call %u\n", index);
+            report(index, &call, batchFrame);
+            abort();
+        }
+    }
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    runProgram(data, size);
+    return 0;
+}
+
+#ifndef CN91C4S96_LIBFUZZER
+static uint32_t rngState = 1;
+
+static uint32_t rnd(void)
+{
+    // xorshift32
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+static const uint32_t edges[] = {
+    0, 1, 2, 5, 6, 8, 9, 10, 99, 100, 1000, 10000, 100000, 1000000, 99999999, 100000000,
+    CN91C4S96_LAYOUT_MAX_NUM, CN91C4S96_LAYOUT_MAX_NUM + 1, INT32_MAX, (uint32_t)INT32_MIN,
+    (uint32_t)-1, (uint32_t)-9, (uint32_t)-10, (uint32_t)-99999999, (uint32_t)-100000000,
+    (uint32_t)-CN91C4S96_LAYOUT_MAX_NUM, (uint32_t)(-CN91C4S96_LAYOUT_MAX_NUM - 1),
+};
+
+static const char *const strings[] = {
+    "HELLO", "-12.5", "   _-", "0123456789", "\xd0\x9f\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82", // Привет
+    "\xd1\x91\xd0\x81\xc2\xb0\xe2\x88\x92\xe2\x80\x93", // ёЁ°−–
+    "\xd0\x41\xe2\x88\x41\x80\xff\xf8\x88\x80\x80\x80\xc1\x81", // broken and overlong sequences
+};
+
+// number: edge value, small one or any bits
+static uint32_t rndValue(void)
+{
+    switch (rnd() % 4)
+    {
+    case 0:
+        return edges[rnd() % COUNT(edges)];
+    case 1:
+        return rnd() % 32 - 8;
+    case 2:
+    {
+        float f = (float)(int32_t)rnd() / (float)(1 << (rnd() % 24));
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        return bits;
+    }
+    default:
+        return rnd();
+    }
+}
+
+static size_t put32(uint8_t *p, uint32_t v)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+    return 4;
+}
+
+// random program in the input format, values are biased to the edges
+static size_t generate(uint8_t *buf)
+{
+    size_t size = 0;
+    unsigned calls = 1 + rnd() % 16;
+
+    for (unsigned n = 0; n < calls; n++)
+    {
+        uint8_t op = rnd() % OP_COUNT;
+        buf[size++] = op;
+        switch (op)
+        {
+        case OP_STR:
+        {
+            const char *s = strings[rnd() % COUNT(strings)];
+            uint8_t len = (uint8_t)strlen(s);
+            if (rnd() % 2)
+            {
+                buf[size++] = len;
+                memcpy(buf + size, s, len);
+            }
+            else
+            {
+                len = rnd() % (STR_MAX + 1);
+                buf[size++] = len;
+                for (uint8_t i = 0; i < len; i++)
+                {
+                    buf[size + i] = (uint8_t)rnd();
+                }
+            }
+            size += len;
+            break;
+        }
+        case OP_FIELD:
+            buf[size++] = rnd() % (CN91C4S96_LAYOUT_DIGITS + 1);
+            buf[size++] = rnd() % (CN91C4S96_LAYOUT_DIGITS + 2);
+            buf[size++] = (uint8_t)rnd();
+            size += put32(buf + size, rndValue());
+            size += put32(buf + size, rndValue());
+            break;
+        case OP_HEX:
+        case OP_BCD:
+        case OP_BIN:
+            size += put32(buf + size, rndValue());
+            buf[size++] = rnd() % 12;
+            buf[size++] = rnd() % 7;
+            break;
+        case OP_BATCH:
+            size += put32(buf + size, rndValue());
+            buf[size++] = rnd() % 12;
+            break;
+        default:
+            // all other arguments are 4 byte numbers or small values in the first byte
+            for (int i = 0; i < 3; i++)
+            {
+                size += put32(buf + size, rndValue());
+            }
+            break;
+        }
+    }
+    return size;
+}
+
+static void runFile(FILE *f, const char *name)
+{
+    static uint8_t data[1 << 16];
+    size_t size = fread(data, 1, sizeof(data), f);
+
+    if (ferror(f))
+    {
+        perror(name);
+        exit(1);
+    }
+    runProgram(data, size);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long count = 0;
+    int i = 1;
+
+    for (; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (argv[i][1] == 'r' && i + 1 < argc)
+            count = strtoul(argv[++i], NULL, 0);
+        else if (argv[i][1] == 's' && i + 1 < argc)
+            rngState = (uint32_t)strtoul(argv[++i], NULL, 0) | 1;
+        else
+        {
+            fprintf(stderr, "usage: cn91fuzz [-r count] [-s seed] [input...]\n");
+            return 1;
+        }
+    }
+
+    if (count)
+    {
+        static uint8_t buf[PROGRAM_MAX];
+        for (unsigned long n = 0; n < count; n++)
+        {
+            runProgram(buf, generate(buf));
+        }
+        printf("%lu random programs, no differences\n", count);
+        return 0;
+    }
+    if (i == argc)
+    {
+        runFile(stdin, "stdin");
+        return 0;
+    }
+    for (; i < argc; i++)
+    {
+        FILE *f = fopen(argv[i], "rb");
+        if (!f)
+        {
+            perror(argv[i]);
+            return 1;
+        }
+        runFile(f, argv[i]);
+        fclose(f);
+    }
+    return 0;
+}
+#endif //CN91C4S96_LIBFUZZER
@@ -0,0 +1,8 @@
+/*******************************************************************************
+Replacement of the CubeMX i2c.h for the fuzzer build: bus is a stub
+*******************************************************************************/
+
+#ifndef FUZZ_I2C_H_
+#define FUZZ_I2C_H_
+
+#endif
@@ -0,0 +1,18 @@
+/*******************************************************************************
+Replacement of the CubeMX main.h for the fuzzer build: no HAL, failed asserts
+abort, so the fuzzer reports them as crashes
+*******************************************************************************/
+
+#ifndef FUZZ_MAIN_H_
+#define FUZZ_MAIN_H_
+
+#include <stddef.h>
+
+#define assert_param(expr) ((expr) ? (void)0U : __builtin_trap())
+
+#define SET_BIT(REG, BIT) ((REG) |= (BIT))
+#define CLEAR_BIT(REG, BIT) ((REG) &= ~(BIT))
+#define READ_BIT(REG, BIT) ((REG) & (BIT))
+#define MODIFY_REG(REG, CLEARMASK, SETMASK) ((REG) = (((REG) & (~(CLEARMASK))) | (SETMASK)))
+
+#endif
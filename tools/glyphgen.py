@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+"""Convert a glyph map into the glyph tables header of CN91C4S96 printStr.
+
+usage: glyphgen.py map_file header_file
+
+Map format is described in extras/glyphs.map. ASCII characters go into a
+dense table indexed by code, all other code points into a perfect hash table
+which is searched here, so a lookup on the target is one multiplication and
+one compare. Cyrillic lowercase letters are folded to uppercase by the driver
+before the lookup and must not be in the map.
+"""
+
+import os
+import sys
+
+# segment bits of the glyph format used by the driver tables, see README.md
+SEGMENTS = {"a": 0x10, "b": 0x20, "c": 0x40, "d": 0x08, "e": 0x04, "f": 0x01, "g": 0x02}
+ASCII_FIRST = 0x20
+ASCII_LETTERS = 0x40  # first code of the table part under CN91C4S96_USE_LETTERS
+ASCII_END = 0x80
+KEY_MAX = 0xFFFF  # hash keys are uint16_t
+CYRILLIC_LOWER = range(0x430, 0x450)
+CYRILLIC_YO_LOWER = 0x451
+
+
+class MapError(Exception):
+    pass
+
+
+def code_point(word):
+    if word.upper().startswith("U+") and len(word) > 2:
+        try:
+            return int(word[2:], 16)
+        except ValueError:
+            raise MapError("bad code point %s" % word)
+    if len(word) != 1:
+        raise MapError("one character or U+XXXX expected: %s" % word)
+    return ord(word)
+
+
+def segments(word):
+    if word == "-":
+        return 0
+    value = 0
+    for s in word:
+        if s not in SEGMENTS:
+            raise MapError("unknown segment %s in %s" % (s, word))
+        value |= SEGMENTS[s]
+    return value
+
+
+def parse(path):
+    glyphs = {}
+    with open(path, encoding="utf-8") as f:
+        for lineno, line in enumerate(f, 1):
+            words = line.split("#", 1)[0].split()
+            if not words:
+                continue
+            try:
+                if len(words) != 2:
+                    raise MapError("can't parse: %s" % line.strip())
+                cp = code_point(words[0])
+                if cp in glyphs:
+                    raise MapError("%s twice" % words[0])
+                if cp in CYRILLIC_LOWER or cp == CYRILLIC_YO_LOWER:
+                    raise MapError("lowercase cyrillic %s is folded to uppercase by the driver" % words[0])
+                if cp < ASCII_FIRST or cp > KEY_MAX:
+                    raise MapError("code point out of range U+%04X..U+%04X: %s" % (ASCII_FIRST, KEY_MAX, words[0]))
+                glyphs[cp] = segments(words[1])
+            except MapError as e:
+                raise MapError("%s:%d: %s" % (path, lineno, e))
+
+    # lowercase latin shows the uppercase glyph unless it has its own
+    for cp in range(ord("a"), ord("z") + 1):
+        if cp not in glyphs and cp - 0x20 in glyphs:
+            glyphs[cp] = glyphs[cp - 0x20]
+    return glyphs
+
+
+def hash_of(cp, mult, bits):
+    return ((cp * mult) & 0xFFFF) >> (16 - bits)
+
+
+def perfect_hash(keys):
+    bits = max(1, (len(keys) - 1).bit_length())
+    while bits <= 16:
+        for mult in range(1, 0x10000, 2):
+            if len({hash_of(k, mult, bits) for k in keys}) == len(keys):
+                return mult, bits
+        bits += 1
+    raise MapError("no perfect hash found")
+
+
+def row(values):
+    return ", ".join("0x%02x" % v for v in values)
+
+
+def header(glyphs, map_path):
+    others = sorted(cp for cp in glyphs if cp >= ASCII_END)
+    mult, bits = perfect_hash(others) if others else (1, 1)
+    table = [(0, 0)] * (1 << bits)
+    for cp in others:
+        table[hash_of(cp, mult, bits)] = (cp, glyphs[cp])
+
+    ascii_base = [glyphs.get(cp, 0) for cp in range(ASCII_FIRST, ASCII_LETTERS)]
+    ascii_letters = [glyphs.get(cp, 0) for cp in range(ASCII_LETTERS, ASCII_END)]
+
+    out = []
+    out.append("/*******************************************************************************")
+    out.append("Glyph tables of CN91C4S96printStr, see CN91C4S96glyphs.h")
+    out.append("")
+    out.append("Generated by tools/glyphgen.py from %s, don't edit." % os.path.basename(map_path))
+    out.append("*******************************************************************************/")
+    out.append("")
+    out.append("#ifndef CN91C4S96GLYPHS_DEFAULT_H_")
+    out.append("#define CN91C4S96GLYPHS_DEFAULT_H_")
+    out.append("")
+    out.append("// codes 0x%02x..0x%02x" % (ASCII_FIRST, ASCII_LETTERS - 1))
+    out.append("#define CN91C4S96_GLYPHS_ASCII \\")
+    for i in range(0, len(ascii_base), 16):
+        out.append("    %s%s" % (row(ascii_base[i:i + 16]), ", \\" if i + 16 < len(ascii_base) else ""))
+    out.append("")
+    out.append("// codes 0x%02x..0x%02x" % (ASCII_LETTERS, ASCII_END - 1))
+    out.append("#define CN91C4S96_GLYPHS_ASCII_LETTERS \\")
+    for i in range(0, len(ascii_letters), 16):
+        out.append("    %s%s" % (row(ascii_letters[i:i + 16]), ", \\" if i + 16 < len(ascii_letters) else ""))
+    out.append("")
+    out.append("// other code points: slot ((uint16_t)(cp * MULT) >> (16 - BITS)) holds {cp, glyph}")
+    out.append("#define CN91C4S96_GLYPHS_HASH_MULT 0x%04x" % mult)
+    out.append("#define CN91C4S96_GLYPHS_HASH_BITS %d" % bits)
+    out.append("#define CN91C4S96_GLYPHS_HASH \\")
+    for i in range(0, len(table), 4):
+        part = ", ".join("{0x%04x, 0x%02x}" % t for t in table[i:i + 4])
+        out.append("    %s%s" % (part, ", \\" if i + 4 < len(table) else ""))
+    out.append("")
+    out.append("#endif")
+    return "\n".join(out) + "\n"
+
+
+def main(argv):
+    if len(argv) != 3:
+        sys.stderr.write(__doc__)
+        return 2
+    try:
+        glyphs = parse(argv[1])
+        text = header(glyphs, argv[1])
+    except (MapError, OSError) as e:
+        sys.stderr.write("glyphgen: %s\n" % e)
+        return 1
+    with open(argv[2], "w") as f:
+        f.write(text)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
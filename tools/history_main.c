@@ -0,0 +1,109 @@
+/*******************************************************************************
+cn91hist - rebuild the screen sequence from a frame history dump recorded by
+src/CN91C4S96history.c.
+
+Build:  cc -O2 -Isrc -o cn91hist tools/history_main.c tools/CN91C4S96emu.c
+
+Prints every frame as 16 hex bytes (the cn91emu input format).
+
+Options:
+    -e          render every frame as text (see cn91emu)
+    -p PREFIX   write every frame to PREFIXnnnnnn.png
+*******************************************************************************/
+
+#include "CN91C4S96history.h"
+#include "CN91C4S96emu.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void show(uint32_t n, const uint8_t *frame, bool render, const char *prefix)
+{
+    printf("%6u:", n);
+    for (int i = 0; i < HISTORY_FRAME_SIZE; i++)
+        printf(" %02x", frame[i]);
+    printf("\n");
+    if (render)
+    {
+        char text[1024];
+        CN91C4S96EmuRenderText(frame, text, sizeof(text));
+        fputs(text, stdout);
+    }
+    if (prefix)
+    {
+        char name[1024];
+        snprintf(name, sizeof(name), "%s%06u.png", prefix, n);
+        if (CN91C4S96EmuRenderPNG(frame, name))
+            perror(name);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool render = false;
+    const char *prefix = NULL;
+    const char *path = NULL;
+
+    for (int a = 1; a < argc; a++)
+    {
+        if (!strcmp(argv[a], "-e"))
+            render = true;
+        else if (!strcmp(argv[a], "-p") && a + 1 < argc)
+            prefix = argv[++a];
+        else
+            path = argv[a];
+    }
+    if (!path)
+    {
+        fprintf(stderr, "usage: %s [-e] [-p prefix] history.bin\n", argv[0]);
+        return 2;
+    }
+
+    FILE *f = fopen(path, "rb");
+    if (!f)
+    {
+        perror(path);
+        return 1;
+    }
+    fseek(f, 0, SEEK_END);
+    long fileLen = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *p = malloc(fileLen > 0 ? fileLen : 1);
+    size_t len = fread(p, 1, fileLen, f);
+    fclose(f);
+
+    if (len < HISTORY_HEADER_SIZE + HISTORY_FRAME_SIZE || p[0] != HISTORY_MAGIC0 || p[1] != HISTORY_MAGIC1 ||
+        p[2] != HISTORY_MAGIC2 || p[3] != HISTORY_VERSION)
+    {
+        fprintf(stderr, "%s: not a frame history of version %d\n", path, HISTORY_VERSION);
+        return 1;
+    }
+    uint32_t n = p[4] | (p[5] << 8) | (p[6] << 16) | ((uint32_t)p[7] << 24);
+
+    uint8_t frame[HISTORY_FRAME_SIZE];
+    size_t pos = HISTORY_HEADER_SIZE;
+    memcpy(frame, p + pos, HISTORY_FRAME_SIZE);
+    pos += HISTORY_FRAME_SIZE;
+    if (n)
+        show(n, frame, render, prefix); // the oldest frame which is known in full
+
+    while (pos < len)
+    {
+        uint8_t at = 0;
+        uint8_t token;
+        while (pos < len && (token = p[pos++]) != HISTORY_END)
+        {
+            at += HISTORY_SKIP(token);
+            for (uint8_t c = 0; c < HISTORY_COUNT(token) && pos < len && at < HISTORY_FRAME_SIZE; c++)
+                frame[at++] ^= p[pos++];
+        }
+        if (token != HISTORY_END)
+        {
+            fprintf(stderr, "%s: truncated record at offset %zu\n", path, pos);
+            break;
+        }
+        show(++n, frame, render, prefix);
+    }
+    free(p);
+    return 0;
+}
@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+"""Convert a glass segment map into a CN91C4S96 layout profile header.
+
+usage: layoutgen.py map_file header_file
+
+Map format is described in extras/pdc6x1.map. Icon names must be the ones of
+CN91C4S96_ICONS in src/CN91C4S96layout.h, icons missing from the map are
+written as {0, 0} and are never lit on that glass.
+"""
+
+import os
+import re
+import sys
+
+DATA_SIZE = 16  # frame bytes, see src/CN91C4S96.h
+DIGIT_FGE = 0x70
+DIGIT_ABCD = 0x0F
+INT32_MAX = 0x7FFFFFFF
+
+LAYOUT_H = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "src", "CN91C4S96layout.h")
+
+
+class MapError(Exception):
+    pass
+
+
+def known_icons():
+    with open(LAYOUT_H) as f:
+        text = f.read()
+    block = text[text.index("#define CN91C4S96_ICONS(X)"):]
+    block = block[:block.index("\n\n")]
+    return re.findall(r"X\((\w+)\)", block)
+
+
+def number(word, limit, what):
+    try:
+        value = int(word, 0)
+    except ValueError:
+        raise MapError("%s is not a number: %s" % (what, word))
+    if value < 0 or value >= limit:
+        raise MapError("%s out of range 0..%d: %s" % (what, limit - 1, word))
+    return value
+
+
+def parse(path, icons):
+    layout = {"name": None, "digits": {}, "dots": {}, "minus": None, "icons": {}}
+    with open(path) as f:
+        for lineno, line in enumerate(f, 1):
+            words = line.split("#", 1)[0].split()
+            if not words:
+                continue
+            try:
+                kind, args = words[0], words[1:]
+                if kind == "name" and len(args) == 1:
+                    layout["name"] = args[0]
+                elif kind == "digit" and len(args) == 3:
+                    n = number(args[0], 32, "digit")
+                    layout["digits"][n] = (number(args[1], DATA_SIZE, "byte"), number(args[2], DATA_SIZE, "byte"))
+                elif kind == "dot" and len(args) == 3:
+                    p = number(args[0], 32, "dot")
+                    if p == 0:
+                        raise MapError("dot 0 means no dot")
+                    layout["dots"][p] = (number(args[1], DATA_SIZE, "byte"), 1 << number(args[2], 8, "bit"))
+                elif kind == "minus" and len(args) == 2:
+                    layout["minus"] = (number(args[0], DATA_SIZE, "byte"), 1 << number(args[1], 8, "bit"))
+                elif kind == "icon" and len(args) == 3:
+                    if args[0] not in icons:
+                        raise MapError("unknown icon %s" % args[0])
+                    if args[0] in layout["icons"]:
+                        raise MapError("icon %s twice" % args[0])
+                    layout["icons"][args[0]] = (number(args[1], DATA_SIZE, "byte"), 1 << number(args[2], 8, "bit"))
+                else:
+                    raise MapError("can't parse: %s" % line.strip())
+            except MapError as e:
+                raise MapError("%s:%d: %s" % (path, lineno, e))
+
+    if not layout["name"] or not re.match(r"^\w+$", layout["name"]):
+        raise MapError("%s: name is missing or not an identifier" % path)
+    for key in ("digits", "dots"):
+        first = 0 if key == "digits" else 1
+        if sorted(layout[key]) != list(range(first, first + len(layout[key]))):
+            raise MapError("%s: %s must be numbered from %d without gaps" % (path, key, first))
+    if not layout["digits"]:
+        raise MapError("%s: no digits" % path)
+    if len(layout["dots"]) >= len(layout["digits"]):
+        raise MapError("%s: more dots than digits" % path)
+    if layout["minus"] is None:
+        raise MapError("%s: minus is missing" % path)
+    return layout
+
+
+def warn_shared(layout):
+    owners = {}
+
+    def take(pos, mask, what):
+        for bit in range(8):
+            if mask & (1 << bit):
+                owners.setdefault((pos, bit), []).append(what)
+
+    for n, (fge, abcd) in layout["digits"].items():
+        take(fge, DIGIT_FGE, "digit %d" % n)
+        take(abcd, DIGIT_ABCD, "digit %d" % n)
+    for p, (pos, seg) in layout["dots"].items():
+        take(pos, seg, "dot %d" % p)
+    take(layout["minus"][0], layout["minus"][1], "minus")
+    for name, (pos, seg) in layout["icons"].items():
+        take(pos, seg, name)
+
+    for (pos, bit), what in sorted(owners.items()):
+        if len(set(what)) > 1:
+            sys.stderr.write("warning: byte %d bit %d is shared by %s\n" % (pos, bit, ", ".join(what)))
+
+
+def seg(pair):
+    return "%d, 0x%02x" % pair
+
+
+def text_mask(digits, dots):
+    mask = [0] * DATA_SIZE
+    for fge, abcd in digits:
+        mask[fge] |= DIGIT_FGE
+        mask[abcd] |= DIGIT_ABCD
+    for pos, seg in dots:
+        mask[pos] |= seg
+    return mask
+
+
+def header(layout, icons, map_path):
+    name = layout["name"]
+    guard = "CN91C4S96LAYOUT_%s_H_" % name.upper()
+    digits = [layout["digits"][n] for n in range(len(layout["digits"]))]
+    dots = [(0, 0)] + [layout["dots"][p] for p in range(1, len(layout["dots"]) + 1)]
+
+    out = []
+    out.append("/*******************************************************************************")
+    out.append("%s glass layout profile, see CN91C4S96layout.h" % name)
+    out.append("")
+    out.append("Generated by tools/layoutgen.py from %s, don't edit." % os.path.basename(map_path))
+    out.append("*******************************************************************************/")
+    out.append("")
+    out.append("#ifndef %s" % guard)
+    out.append("#define %s" % guard)
+    out.append("")
+    out.append('#define CN91C4S96_LAYOUT_NAME "%s"' % name)
+    out.append("#define CN91C4S96_LAYOUT_DIGITS %d" % len(digits))
+    out.append("#define CN91C4S96_LAYOUT_DOTS %d" % (len(dots) - 1))
+    out.append("#define CN91C4S96_LAYOUT_MAX_NUM %d" % min(10 ** len(digits) - 1, INT32_MAX))
+    out.append("")
+    out.append("#define CN91C4S96_LAYOUT_DIGIT_FGE {%s}" % ", ".join(str(d[0]) for d in digits))
+    out.append("#define CN91C4S96_LAYOUT_DIGIT_ABCD {%s}" % ", ".join(str(d[1]) for d in digits))
+    out.append("#define CN91C4S96_LAYOUT_DOT {%s}" % ", ".join("{%s}" % seg(d) for d in dots))
+    out.append("#define CN91C4S96_LAYOUT_MINUS %s" % seg(layout["minus"]))
+    out.append("// digit and dot bits of every byte, the part of the frame written by text")
+    out.append("#define CN91C4S96_LAYOUT_TEXT_MASK {%s}" % ", ".join("0x%02x" % m for m in text_mask(digits, dots[1:])))
+    out.append("")
+    for icon in icons:
+        out.append("#define CN91C4S96_LAYOUT_ICON_%s %s" % (icon, seg(layout["icons"].get(icon, (0, 0)))))
+    out.append("")
+    out.append("#endif")
+    return "\n".join(out) + "\n"
+
+
+def main(argv):
+    if len(argv) != 3:
+        sys.stderr.write(__doc__)
+        return 2
+    icons = known_icons()
+    try:
+        layout = parse(argv[1], icons)
+    except (MapError, OSError) as e:
+        sys.stderr.write("layoutgen: %s\n" % e)
+        return 1
+    warn_shared(layout)
+    with open(argv[2], "w") as f:
+        f.write(header(layout, icons, argv[1]))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
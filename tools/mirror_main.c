@@ -0,0 +1,139 @@
+/*******************************************************************************
+cn91mirror - decode remote mirroring stream made by src/CN91C4S96mirror.c.
+
+Build:  cc -O2 -Isrc -o cn91mirror tools/mirror_main.c tools/CN91C4S96emu.c
+
+Input file: messages as received, every one prefixed by its length byte.
+Prints every rebuilt frame as 16 hex bytes (the cn91emu input format) and
+the stream cost. After a lost message (sequence gap) frames are not shown
+until the next keyframe.
+
+Options:
+    -e          render every frame as text (see cn91emu)
+*******************************************************************************/
+
+#include "CN91C4S96mirror.h"
+#include "CN91C4S96emu.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MASK_BYTES 2
+
+// apply one message to frame. Returns false if it is malformed
+static bool apply(uint8_t *frame, const uint8_t *msg, size_t len)
+{
+    if (msg[0] & MIRROR_KEY)
+    {
+        if (len != 1 + MIRROR_FRAME_SIZE)
+            return false;
+        memcpy(frame, msg + 1, MIRROR_FRAME_SIZE);
+        return true;
+    }
+    if (msg[0] & MIRROR_MASK)
+    {
+        if (len < 1 + MASK_BYTES)
+            return false;
+        uint16_t mask = msg[1] | (msg[2] << 8);
+        size_t pos = 1 + MASK_BYTES;
+        for (int i = 0; i < MIRROR_FRAME_SIZE; i++)
+        {
+            if (!(mask & (1 << i)))
+                continue;
+            if (pos >= len)
+                return false;
+            frame[i] = msg[pos++];
+        }
+        return pos == len;
+    }
+    if ((len - 1) % 2)
+        return false;
+    for (size_t pos = 1; pos < len; pos += 2)
+    {
+        if (msg[pos] >= MIRROR_FRAME_SIZE)
+            return false;
+        frame[msg[pos]] = msg[pos + 1];
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    bool render = false;
+    const char *path = NULL;
+
+    for (int a = 1; a < argc; a++)
+    {
+        if (!strcmp(argv[a], "-e"))
+            render = true;
+        else
+            path = argv[a];
+    }
+    if (!path)
+    {
+        fprintf(stderr, "usage: %s [-e] stream.bin\n", argv[0]);
+        return 2;
+    }
+
+    FILE *f = fopen(path, "rb");
+    if (!f)
+    {
+        perror(path);
+        return 1;
+    }
+
+    uint8_t frame[MIRROR_FRAME_SIZE] = {0};
+    uint8_t msg[256];
+    bool synced = false;
+    uint8_t seq = 0;
+    uint32_t messages = 0, keyframes = 0, lost = 0, bytes = 0;
+    int c;
+
+    while ((c = fgetc(f)) != EOF)
+    {
+        size_t len = (size_t)c;
+        if (len == 0 || fread(msg, 1, len, f) != len)
+        {
+            fprintf(stderr, "%s: truncated message %u\n", path, messages + 1);
+            break;
+        }
+        messages++;
+        bytes += len;
+
+        if (synced && (msg[0] & MIRROR_SEQ) != seq)
+        {
+            lost++;
+            synced = false;
+        }
+        seq = (msg[0] + 1) & MIRROR_SEQ;
+        if (msg[0] & MIRROR_KEY)
+        {
+            keyframes++;
+            synced = true;
+        }
+        if (!synced)
+            continue;
+        if (!apply(frame, msg, len))
+        {
+            fprintf(stderr, "%s: malformed message %u\n", path, messages);
+            synced = false;
+            continue;
+        }
+
+        printf("%6u:", messages);
+        for (int i = 0; i < MIRROR_FRAME_SIZE; i++)
+            printf(" %02x", frame[i]);
+        printf("\n");
+        if (render)
+        {
+            char text[1024];
+            CN91C4S96EmuRenderText(frame, text, sizeof(text));
+            fputs(text, stdout);
+        }
+    }
+    fclose(f);
+
+    printf("messages %u, keyframes %u, gaps %u, bytes %u, %.1f bytes per message\n", messages, keyframes, lost, bytes,
+           messages ? (double)bytes / messages : 0);
+    return 0;
+}
@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+"""Flash and RAM cost of every CN91C4S96config.h switch.
+
+usage: sizereport.py [--cc CC] [--size SIZE] [--cflags=FLAGS] [-I DIR]...
+
+Builds src/CN91C4S96.c with all features on, then with each switch off, and
+prints text/data/bss of the object and what the feature adds. Pass the target
+compiler and flags to get numbers for the firmware, for example:
+
+    python3 tools/sizereport.py --cc arm-none-eabi-gcc --cflags="-Os -mcpu=cortex-m0 -mthumb"
+
+main.h and i2c.h of the firmware are found with -I. Without them a stub
+main.h with the bit macros is used.
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+
+SRC = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "src")
+
+FEATURES = [
+    ("float print", ["CN91C4S96_USE_FLOAT=0"]),
+    ("text print", ["CN91C4S96_USE_TEXT=0"]),
+    ("letters", ["CN91C4S96_USE_LETTERS=0"]),
+    ("date and time", ["CN91C4S96_USE_CLOCK=0"]),
+    ("RU icons", ["CN91C4S96_ICONS_RU=0"]),
+    ("EN icons", ["CN91C4S96_ICONS_EN=0"]),
+]
+
+STUB_MAIN_H = """#define assert_param(expr) ((void)0)
+#define SET_BIT(REG, BIT) ((REG) |= (BIT))
+#define CLEAR_BIT(REG, BIT) ((REG) &= ~(BIT))
+#define MODIFY_REG(REG, CLEARMASK, SETMASK) ((REG) = (((REG) & (~(CLEARMASK))) | (SETMASK)))
+"""
+
+
+def size_tool(cc):
+    base = os.path.basename(cc)
+    for suffix in ("gcc", "clang", "cc"):
+        if base.endswith(suffix):
+            return os.path.join(os.path.dirname(cc), base[: -len(suffix)] + "size")
+    return "size"
+
+
+def build(args, includes, defines, obj):
+    cmd = [args.cc, "-c", os.path.join(SRC, "CN91C4S96.c"), "-o", obj, "-I" + SRC]
+    cmd += args.cflags.split() + ["-I" + i for i in includes] + ["-D" + d for d in defines]
+    subprocess.run(cmd, check=True, stderr=subprocess.DEVNULL)
+    out = subprocess.run([args.size, obj], check=True, stdout=subprocess.PIPE, universal_newlines=True).stdout
+    text, data, bss = out.splitlines()[1].split()[:3]
+    return int(text), int(data), int(bss)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="flash and RAM cost of CN91C4S96 features")
+    parser.add_argument("--cc", default=os.environ.get("CC", "cc"))
+    parser.add_argument("--size", default=None, help="size tool, default is derived from --cc")
+    parser.add_argument("--cflags", default="-Os -ffunction-sections -fdata-sections")
+    parser.add_argument("-I", dest="includes", action="append", default=[])
+    args = parser.parse_args()
+    args.size = args.size or size_tool(args.cc)
+
+    with tempfile.TemporaryDirectory() as tmp:
+        includes = list(args.includes)
+        if not any(os.path.exists(os.path.join(i, "main.h")) for i in includes):
+            with open(os.path.join(tmp, "main.h"), "w") as f:
+                f.write(STUB_MAIN_H)
+            open(os.path.join(tmp, "i2c.h"), "w").close()
+            includes.append(tmp)
+
+        obj = os.path.join(tmp, "CN91C4S96.o")
+        try:
+            full = build(args, includes, [], obj)
+            rows = [(name, build(args, includes, defines, obj)) for name, defines in FEATURES]
+        except (subprocess.CalledProcessError, OSError) as e:
+            sys.stderr.write("sizereport: %s\n" % e)
+            return 1
+
+    print("%-16s %7s %7s %7s" % ("feature", "flash", "data", "bss"))
+    # data is copied from flash at startup, so it costs both
+    print("%-16s %7d %7d %7d" % ("all on", full[0] + full[1], full[1], full[2]))
+    for name, (text, data, bss) in rows:
+        print("%-16s %+7d %+7d %+7d" % (name, full[0] + full[1] - text - data, full[1] - data, full[2] - bss))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
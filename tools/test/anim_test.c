@@ -0,0 +1,121 @@
+/*******************************************************************************
+Host test of src/CN91C4S96anim.c
+
+Build:  cc -Itools/fuzz -Itools -Isrc -o anim_test tools/test/anim_test.c tools/CN91C4S96emu.c \
+            src/CN91C4S96anim.c src/CN91C4S96.c src/CN91C4S96ctrl.c
+*******************************************************************************/
+
+#include "test.h"
+#include "CN91C4S96anim.h"
+
+#define SPINNER_MASK (CN91C4S96_ANIM_SEG_A | CN91C4S96_ANIM_SEG_B | CN91C4S96_ANIM_SEG_C | CN91C4S96_ANIM_SEG_D | \
+                      CN91C4S96_ANIM_SEG_E | CN91C4S96_ANIM_SEG_F)
+
+static const CN91C4S96_Seg_st warn = {CN91C4S96_LAYOUT_ICON_WARN};
+
+static const CN91C4S96AnimDelta_st warnOn[] = {CN91C4S96_ANIM_ICON(WARN, true)};
+static const CN91C4S96AnimDelta_st warnOff[] = {CN91C4S96_ANIM_ICON(WARN, false)};
+static const CN91C4S96AnimStep_st warnSteps[] = {CN91C4S96_ANIM_STEP(warnOn, 2), CN91C4S96_ANIM_STEP(warnOff, 2)};
+static const CN91C4S96Anim_st blinkOnce = CN91C4S96_ANIM(warnSteps, false);
+
+#if CN91C4S96_USE_CLOCK
+// E segment on the tens of seconds, the digit the clock doesn't redraw between 56 and 57
+static const CN91C4S96AnimDelta_st tensE[] = {CN91C4S96_ANIM_DIGIT(1, CN91C4S96_ANIM_SEG_E, CN91C4S96_ANIM_SEG_E)};
+static const CN91C4S96AnimStep_st tensSteps[] = {CN91C4S96_ANIM_STEP(tensE, 1)};
+static const CN91C4S96Anim_st markTens = CN91C4S96_ANIM(tensSteps, false);
+#endif
+
+// digit segments of the rightmost digit in CN91C4S96_ANIM_SEG_x bits
+static uint8_t lastDigit(void)
+{
+    uint8_t n = DISPLAY_SIZE - 1;
+    return (Buffer[CN91C4S96Layout.digitFGE[n]] & 0x70) | (Buffer[CN91C4S96Layout.digitABCD[n]] & 0x0f);
+}
+
+static bool warnShown(void)
+{
+    return (Buffer[warn.pos] & warn.seg) != 0;
+}
+
+static void testSpinner(void)
+{
+    static const uint8_t order[] = {CN91C4S96_ANIM_SEG_A, CN91C4S96_ANIM_SEG_B, CN91C4S96_ANIM_SEG_C,
+                                    CN91C4S96_ANIM_SEG_D, CN91C4S96_ANIM_SEG_E, CN91C4S96_ANIM_SEG_F};
+    CN91C4S96AnimPlayer_st player;
+
+    testInit();
+    CN91C4S96printNum(8, 0);
+    CN91C4S96AnimStart(&player, &CN91C4S96AnimSpinner);
+    for (unsigned t = 0; t < 2 * sizeof(order); t++)
+    {
+        // G of the printed 8 is outside of the spinner mask and stays
+        CHECK((lastDigit() & SPINNER_MASK) == order[t % sizeof(order)]);
+        CHECK(lastDigit() & CN91C4S96_ANIM_SEG_G);
+        testReset();
+        CHECK(CN91C4S96AnimTick(&player, 1));
+        // one write, only the bytes of the digit
+        CHECK(testTransfers == 1 && testBytes <= SYS_SIZE + 2);
+    }
+    uint8_t frame[DATA_SIZE];
+    testVisible(frame);
+    CHECK_FRAME(frame, Buffer);
+}
+
+static void testOnce(void)
+{
+    CN91C4S96AnimPlayer_st players[2];
+
+    testInit();
+    CN91C4S96AnimStart(&players[0], &blinkOnce);
+    CN91C4S96AnimStart(&players[1], NULL);
+    CHECK(players[1].anim == NULL);
+    CHECK(warnShown());
+
+    // two ticks per step, stops on the last step and keeps it
+    CHECK(!CN91C4S96AnimTick(players, 2));
+    CHECK(warnShown());
+    CHECK(CN91C4S96AnimTick(players, 2));
+    CHECK(!warnShown());
+    CHECK(!CN91C4S96AnimTick(players, 2));
+    testReset();
+    CHECK(!CN91C4S96AnimTick(players, 2));
+    CHECK(players[0].anim == NULL && !warnShown());
+    CHECK(testTransfers == 0);
+
+    // stopped player leaves the segments as they are
+    CN91C4S96AnimStart(&players[0], &blinkOnce);
+    CN91C4S96AnimStop(&players[0]);
+    CHECK(!CN91C4S96AnimTick(players, 2) && warnShown());
+}
+
+// a digit delta is drawn over the clock like any other content: the next print redraws the whole row
+static void testClock(void)
+{
+#if CN91C4S96_USE_CLOCK
+    uint8_t expected[DATA_SIZE];
+    uint8_t marked[DATA_SIZE];
+    CN91C4S96AnimPlayer_st player;
+
+    testInit();
+    CN91C4S96printTime(12, 34, 57);
+    memcpy(expected, Buffer, DATA_SIZE);
+
+    AllClear();
+    CN91C4S96printTime(12, 34, 56);
+    CN91C4S96AnimStart(&player, &markTens);
+    memcpy(marked, Buffer, DATA_SIZE);
+    // no clock on the row anymore, nothing to count
+    CN91C4S96ClockTick();
+    CHECK_FRAME(Buffer, marked);
+    CN91C4S96printTime(12, 34, 57);
+    CHECK_FRAME(Buffer, expected);
+#endif
+}
+
+int main(void)
+{
+    testSpinner();
+    testOnce();
+    testClock();
+    return testDone("anim");
+}
@@ -0,0 +1,173 @@
+/*******************************************************************************
+Host test of src/CN91C4S96bus.c
+
+Build:  cc -Itools/fuzz -Itools -Isrc -o bus_test tools/test/bus_test.c tools/CN91C4S96emu.c \
+            src/CN91C4S96bus.c src/CN91C4S96.c src/CN91C4S96ctrl.c
+*******************************************************************************/
+
+#include "test.h"
+#include "CN91C4S96bus.h"
+
+#define CHUNK 4
+#define DISPLAY_PRIORITY 100
+#define LOG_MAX 64
+#define LOG_DISPLAY 'D'
+
+static char busLog[LOG_MAX + 1]; // display transfers and jobs in bus order
+static uint8_t logLen = 0;
+static bool displayBusy = false;    // display transfer not waited for
+static unsigned jobsWhileBusy = 0;  // jobs run in the middle of a display transfer
+static uint16_t maxDisplaySize = 0; // data bytes of the longest display transfer
+static CN91C4S96BusJob_st *requestOnWrite = NULL;
+
+static void logEvent(char event)
+{
+    if (logLen < LOG_MAX)
+        busLog[logLen++] = event;
+    busLog[logLen] = 0;
+}
+
+static void logReset(void)
+{
+    logLen = 0;
+    busLog[0] = 0;
+}
+
+static int8_t displayWrite(uint8_t address, const uint8_t *data, uint16_t size)
+{
+    logEvent(LOG_DISPLAY);
+    displayBusy = true;
+    // commands are not counted, every chunk has its own address command
+    uint16_t i = 0;
+    while (i + 1 < size && (data[i] & 0x80))
+        i++;
+    if (size - i - 1 > maxDisplaySize)
+        maxDisplaySize = size - i - 1;
+    // a device asks for the bus while the display sends
+    if (requestOnWrite)
+    {
+        CN91C4S96BusRequest(requestOnWrite);
+        requestOnWrite = NULL;
+    }
+    return testWriteI2C(address, data, size);
+}
+
+static void displayWait(void)
+{
+    displayBusy = false;
+}
+
+static CN91C4S96_HAL_st displayHal = {testInitI2C, displayWrite, displayWait};
+
+typedef struct
+{
+    CN91C4S96BusJob_st job;
+    char name; // in the log
+} TestJob_st;
+
+static TestJob_st *again = NULL; // job which asks for another run while it runs
+
+static int8_t jobRun(void *ctx)
+{
+    TestJob_st *test = ctx;
+
+    if (displayBusy)
+        jobsWhileBusy++;
+    logEvent(test->name);
+    if (again == test)
+    {
+        again = NULL;
+        CN91C4S96BusRequest(&test->job);
+    }
+    return test->name;
+}
+
+static TestJob_st urgent = {{.priority = 200, .run = jobRun, .ctx = &urgent}, 'U'};
+static TestJob_st urgent2 = {{.priority = 200, .run = jobRun, .ctx = &urgent2}, 'V'};
+static TestJob_st sensor = {{.priority = 150, .run = jobRun, .ctx = &sensor}, 'S'};
+static TestJob_st slow = {{.priority = 10, .run = jobRun, .ctx = &slow}, 'L'};
+
+static void testNoHal(void)
+{
+    CN91C4S96BusAttach(&slow.job);
+    CN91C4S96BusAttach(&urgent.job);
+    CN91C4S96BusAttach(&sensor.job);
+    CN91C4S96BusAttach(&urgent2.job);
+    CN91C4S96BusRequest(&slow.job);
+    // the bus isn't owned by the driver yet
+    CHECK(CN91C4S96BusService() == 0);
+}
+
+static void testService(void)
+{
+    CN91C4S96EmuReset(&CN91C4S96EmuGlobal);
+    AllClear();
+    CN91C4S96Init(CN91C4S96BusHal(&displayHal, CHUNK, DISPLAY_PRIORITY));
+    CN91C4S96BusService();
+    logReset();
+
+    // priority order, attach order within the same priority, twice requested runs once
+    CN91C4S96BusRequest(&slow.job);
+    CN91C4S96BusRequest(&urgent2.job);
+    CN91C4S96BusRequest(&sensor.job);
+    CN91C4S96BusRequest(&urgent.job);
+    CN91C4S96BusRequest(&urgent.job);
+    CHECK(CN91C4S96BusService() == 4);
+    CHECK(strcmp(busLog, "UVSL") == 0);
+    CHECK(urgent.job.status == 'U' && slow.job.status == 'L');
+    CHECK(CN91C4S96BusService() == 0);
+
+    // request made while the job runs is kept
+    logReset();
+    again = &sensor;
+    CN91C4S96BusRequest(&sensor.job);
+    CHECK(CN91C4S96BusService() == 2);
+    CHECK(strcmp(busLog, "SS") == 0);
+}
+
+static void testChunks(void)
+{
+    uint8_t visible[DATA_SIZE];
+
+    CN91C4S96EmuReset(&CN91C4S96EmuGlobal);
+    AllClear();
+    CN91C4S96Init(CN91C4S96BusHal(&displayHal, CHUNK, DISPLAY_PRIORITY));
+    CN91C4S96BusService();
+
+    // whole frame in chunks, an urgent job asking during the first one goes before the second
+    logReset();
+    maxDisplaySize = 0;
+    CN91C4S96printNum(-12345, 2);
+    CN91C4S96batteryLevel(100);
+    CN91C4S96DispSN(true);
+    for (uint8_t i = 0; i < DATA_SIZE; i++)
+        Buffer[i] |= 0x01;
+    requestOnWrite = &urgent.job;
+    CN91C4S96BusRequest(&slow.job);
+    CN91C4S96DispWrite();
+    CHECK(maxDisplaySize <= CHUNK);
+    CHECK(jobsWhileBusy == 0);
+    CHECK(strncmp(busLog, "DUD", 3) == 0);
+    // the slow job waits for the service call
+    CHECK(strchr(busLog, 'L') == NULL);
+    CHECK(CN91C4S96BusService() == 1);
+    CHECK(jobsWhileBusy == 0);
+    testVisible(visible);
+    CHECK_FRAME(visible, Buffer);
+
+    // whole frame in one transfer with chunk 0
+    CN91C4S96Init(CN91C4S96BusHal(&displayHal, 0, DISPLAY_PRIORITY));
+    maxDisplaySize = 0;
+    CN91C4S96DispRefresh();
+    CHECK(maxDisplaySize == DATA_SIZE);
+    testVisible(visible);
+    CHECK_FRAME(visible, Buffer);
+}
+
+int main(void)
+{
+    testNoHal();
+    testService();
+    testChunks();
+    return testDone("bus");
+}
@@ -0,0 +1,104 @@
+/*******************************************************************************
+Host test of src/CN91C4S96decim.c
+
+Build:  cc -Itools/fuzz -Itools -Isrc -o decim_test tools/test/decim_test.c tools/CN91C4S96emu.c \
+            src/CN91C4S96decim.c src/CN91C4S96.c src/CN91C4S96ctrl.c
+*******************************************************************************/
+
+#include "test.h"
+#include "CN91C4S96decim.h"
+
+#define PERIOD 100
+#define MULTIPLIER 10
+
+static CN91C4S96Decim_st decim;
+
+// Buffer is value with the icons of view
+static bool shows(int32_t value, CN91C4S96_Decim_en view)
+{
+    uint8_t frame[DATA_SIZE];
+
+    memcpy(frame, Buffer, DATA_SIZE);
+    AllClear();
+    CN91C4S96printFixed(value, MULTIPLIER);
+    CN91C4S96DispMinMax(view != CN91C4S96_DECIM_MEAN, false, view == CN91C4S96_DECIM_MIN);
+    bool same = memcmp(frame, Buffer, DATA_SIZE) == 0;
+    memcpy(Buffer, frame, DATA_SIZE);
+    return same;
+}
+
+static void push(int32_t from, int32_t to)
+{
+    for (int32_t s = from; s <= to; s++)
+        CN91C4S96DecimPush(&decim, s);
+}
+
+static void testValues(void)
+{
+    testInit();
+    CN91C4S96DecimInit(&decim, PERIOD, MULTIPLIER, false);
+    // samples before the first update belong to the first window
+    push(1, 5);
+    CHECK(!CN91C4S96DecimUpdate(&decim, 1000));
+    CHECK(!CN91C4S96DecimView(&decim, CN91C4S96_DECIM_MEAN));
+    push(6, 10);
+    CHECK(!CN91C4S96DecimUpdate(&decim, 1000 + PERIOD - 1));
+    CHECK(CN91C4S96DecimUpdate(&decim, 1000 + PERIOD));
+    // 5.5 is rounded away from zero
+    CHECK(shows(6, CN91C4S96_DECIM_MEAN));
+    CHECK(CN91C4S96DecimView(&decim, CN91C4S96_DECIM_MIN) && shows(1, CN91C4S96_DECIM_MIN));
+    CHECK(CN91C4S96DecimView(&decim, CN91C4S96_DECIM_MAX) && shows(10, CN91C4S96_DECIM_MAX));
+
+    // the selected view is kept, an empty window keeps the glass
+    push(-10, -1);
+    CHECK(CN91C4S96DecimUpdate(&decim, 1000 + 2 * PERIOD));
+    CHECK(shows(-1, CN91C4S96_DECIM_MAX));
+    CHECK(!CN91C4S96DecimUpdate(&decim, 1000 + 3 * PERIOD));
+    CHECK(shows(-1, CN91C4S96_DECIM_MAX));
+    CHECK(CN91C4S96DecimView(&decim, CN91C4S96_DECIM_MEAN) && shows(-6, CN91C4S96_DECIM_MEAN));
+}
+
+static void testGrid(void)
+{
+    CN91C4S96DecimInit(&decim, PERIOD, MULTIPLIER, false);
+    CN91C4S96DecimUpdate(&decim, 0);
+
+    // a late update doesn't move the next window
+    push(1, 1);
+    CHECK(CN91C4S96DecimUpdate(&decim, PERIOD + PERIOD / 2));
+    push(2, 2);
+    CHECK(!CN91C4S96DecimUpdate(&decim, 2 * PERIOD - 1));
+    CHECK(CN91C4S96DecimUpdate(&decim, 2 * PERIOD));
+    CHECK(shows(2, CN91C4S96_DECIM_MEAN));
+
+    // whole periods missed are skipped, not made up by updates in a row
+    push(3, 3);
+    CHECK(CN91C4S96DecimUpdate(&decim, 5 * PERIOD + 10));
+    push(4, 4);
+    CHECK(!CN91C4S96DecimUpdate(&decim, 5 * PERIOD + 20));
+    CHECK(!CN91C4S96DecimUpdate(&decim, 6 * PERIOD - 1));
+    CHECK(CN91C4S96DecimUpdate(&decim, 6 * PERIOD));
+    CHECK(shows(4, CN91C4S96_DECIM_MEAN));
+
+    // tick counter wraps
+    CN91C4S96DecimInit(&decim, PERIOD, MULTIPLIER, false);
+    CN91C4S96DecimUpdate(&decim, (uint32_t)-(PERIOD / 2));
+    push(7, 7);
+    CHECK(!CN91C4S96DecimUpdate(&decim, PERIOD / 2 - 1));
+    CHECK(CN91C4S96DecimUpdate(&decim, PERIOD / 2));
+    CHECK(shows(7, CN91C4S96_DECIM_MEAN));
+
+    // period 0 closes the window on every update
+    CN91C4S96DecimInit(&decim, 0, MULTIPLIER, false);
+    CN91C4S96DecimUpdate(&decim, 5);
+    push(8, 8);
+    CHECK(CN91C4S96DecimUpdate(&decim, 5));
+    CHECK(shows(8, CN91C4S96_DECIM_MEAN));
+}
+
+int main(void)
+{
+    testValues();
+    testGrid();
+    return testDone("decim");
+}
@@ -0,0 +1,151 @@
+/*******************************************************************************
+Host test of src/CN91C4S96history.c
+
+Build:  cc -Itools/fuzz -Itools -Isrc -o history_test tools/test/history_test.c tools/CN91C4S96emu.c \
+            src/CN91C4S96history.c src/CN91C4S96mirror.c src/CN91C4S96.c src/CN91C4S96ctrl.c
+*******************************************************************************/
+
+#include "test.h"
+#include "CN91C4S96history.h"
+#include "CN91C4S96mirror.h"
+
+#define FRAMES 100
+
+// see CN91C4S96.c
+void commitAttach(void (*hook)(const uint8_t *frame));
+void commitDetach(void (*hook)(const uint8_t *frame));
+
+static uint8_t written[FRAMES][DATA_SIZE];
+static unsigned hookCalls = 0;
+static unsigned mirrorMsgs = 0;
+
+static void hook(const uint8_t *frame)
+{
+    (void)frame;
+    hookCalls++;
+}
+
+static void emit(const uint8_t *msg, size_t len)
+{
+    (void)msg;
+    (void)len;
+    mirrorMsgs++;
+}
+
+// rebuild the frames of a dump, the way tools/history_main.c does it. Returns number of frames
+static unsigned decode(const uint8_t *dump, size_t size, uint8_t frames[][DATA_SIZE], uint32_t *folded)
+{
+    uint8_t frame[DATA_SIZE];
+    unsigned count = 0;
+    size_t i = HISTORY_HEADER_SIZE + DATA_SIZE;
+
+    *folded = dump[4] | (dump[5] << 8) | (dump[6] << 16) | ((uint32_t)dump[7] << 24);
+    memcpy(frame, dump + HISTORY_HEADER_SIZE, DATA_SIZE);
+    while (i < size)
+    {
+        uint8_t pos = 0;
+        for (uint8_t token = dump[i++]; token != HISTORY_END; token = dump[i++])
+        {
+            pos += HISTORY_SKIP(token);
+            for (uint8_t n = 0; n < HISTORY_COUNT(token); n++)
+            {
+                frame[pos++] ^= dump[i++];
+            }
+        }
+        memcpy(frames[count++], frame, DATA_SIZE);
+    }
+    return count;
+}
+
+static void testRing(void)
+{
+    static uint8_t ring[200];
+    static uint8_t dump[HISTORY_HEADER_SIZE + DATA_SIZE + sizeof(ring)];
+    static uint8_t frames[FRAMES][DATA_SIZE];
+    uint32_t folded;
+
+    testInit();
+    commitAttach(hook);
+    CN91C4S96HistoryStart(ring, sizeof(ring));
+    for (int i = 0; i < FRAMES; i++)
+    {
+        CN91C4S96printNum(i * 7, i % 3);
+        if (i % 10 == 0)
+            CN91C4S96DispSN(i % 20 == 0);
+        CN91C4S96DispWrite();
+        memcpy(written[i], Buffer, DATA_SIZE);
+        // the same frame again is not stored
+        CN91C4S96DispWrite();
+    }
+    // the hook attached before keeps getting every frame
+    CHECK(hookCalls == 2 * FRAMES);
+
+    size_t size = CN91C4S96HistoryDump(dump, sizeof(dump));
+    CHECK(size > HISTORY_HEADER_SIZE + DATA_SIZE);
+    CHECK(CN91C4S96HistoryDump(dump, size - 1) == 0);
+    unsigned count = decode(dump, size, frames, &folded);
+    CHECK(count == CN91C4S96HistoryCount());
+    CHECK(count + folded == FRAMES);
+    CHECK(count > 0 && count < FRAMES);
+    for (unsigned n = 0; n < count; n++)
+    {
+        CHECK_FRAME(frames[n], written[FRAMES - count + n]);
+    }
+
+    CN91C4S96HistoryStop();
+    CN91C4S96printNum(1, 0);
+    CN91C4S96DispWrite();
+    CHECK(CN91C4S96HistoryCount() == count);
+    CHECK(hookCalls == 2 * FRAMES + 1);
+    commitDetach(hook);
+}
+
+// history and mirror in both start and stop orders, the other hook keeps running
+static void testChain(void)
+{
+    static uint8_t ring[64];
+
+    testInit();
+    commitAttach(hook);
+    hookCalls = 0;
+    CN91C4S96HistoryStart(ring, sizeof(ring));
+    CN91C4S96MirrorStart(emit, 0);
+    CN91C4S96printNum(2, 0);
+    CN91C4S96DispWrite();
+    CHECK(hookCalls == 1 && mirrorMsgs == 1 && CN91C4S96HistoryCount() == 1);
+    CN91C4S96MirrorStop();
+    CN91C4S96HistoryStop();
+
+    CN91C4S96MirrorStart(emit, 0);
+    CN91C4S96HistoryStart(ring, sizeof(ring));
+    CN91C4S96printNum(3, 0);
+    CN91C4S96DispWrite();
+    CHECK(hookCalls == 2 && mirrorMsgs == 2 && CN91C4S96HistoryCount() == 1);
+    CN91C4S96HistoryStop();
+    CN91C4S96MirrorStop();
+
+    // history stopped under mirror, then started again
+    CN91C4S96HistoryStart(ring, sizeof(ring));
+    CN91C4S96MirrorStart(emit, 0);
+    CN91C4S96HistoryStop();
+    CN91C4S96printNum(4, 0);
+    CN91C4S96DispWrite();
+    CHECK(hookCalls == 3 && mirrorMsgs == 3 && CN91C4S96HistoryCount() == 0);
+    CN91C4S96HistoryStart(ring, sizeof(ring));
+    CN91C4S96printNum(5, 0);
+    CN91C4S96DispWrite();
+    CHECK(hookCalls == 4 && mirrorMsgs == 4 && CN91C4S96HistoryCount() == 1);
+    CN91C4S96HistoryStop();
+    CN91C4S96MirrorStop();
+    CN91C4S96printNum(6, 0);
+    CN91C4S96DispWrite();
+    CHECK(hookCalls == 5 && mirrorMsgs == 4 && CN91C4S96HistoryCount() == 1);
+    commitDetach(hook);
+}
+
+int main(void)
+{
+    testRing();
+    testChain();
+    return testDone("history");
+}
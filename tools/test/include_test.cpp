@@ -0,0 +1,105 @@
+/*******************************************************************************
+C++ include test of the CN91C4S96 headers with atomic struct fields.
+
+The structs are allocated by C++ code and used through the C functions, so
+a layout difference between the C and the C++ view breaks the checks.
+
+Build:  cc -Itools/fuzz -Itools -Isrc -c tools/CN91C4S96emu.c src/CN91C4S96rtos.c src/CN91C4S96bus.c \
+            src/CN91C4S96decim.c src/CN91C4S96.c src/CN91C4S96ctrl.c
+        c++ -std=c++17 -Itools/fuzz -Itools -Isrc -o include_test tools/test/include_test.cpp \
+            CN91C4S96emu.o CN91C4S96rtos.o CN91C4S96bus.o CN91C4S96decim.o CN91C4S96.o CN91C4S96ctrl.o
+*******************************************************************************/
+
+extern "C"
+{
+#include "test.h"
+#include "CN91C4S96rtos.h"
+#include "CN91C4S96bus.h"
+#include "CN91C4S96decim.h"
+}
+
+static_assert(sizeof(CN91C4S96_atomic_u8) == sizeof(uint_fast8_t), "C and C++ atomics differ in size");
+static_assert(alignof(CN91C4S96_atomic_u8) == alignof(uint_fast8_t), "C and C++ atomics differ in alignment");
+static_assert(CN91C4S96_atomic_u8::is_always_lock_free, "atomic fields must be lock-free");
+static_assert(sizeof(CN91C4S96_atomic_bool) == sizeof(bool), "C and C++ atomics differ in size");
+
+static void testRtos(void)
+{
+    static CN91C4S96Msg_st itemsA[4];
+    static CN91C4S96Msg_st itemsB[4];
+    static CN91C4S96Queue_st queueA;
+    static CN91C4S96Queue_st queueB;
+    uint8_t expected[DATA_SIZE];
+
+    testInit();
+    CN91C4S96printFixed(-125, 100);
+    CN91C4S96DispSN(true);
+    memcpy(expected, Buffer, DATA_SIZE);
+
+    testInit();
+    CN91C4S96QueueInit(&queueA, itemsA, 4);
+    CN91C4S96QueueInit(&queueB, itemsB, 4);
+    CN91C4S96QueueAttach(&queueA);
+    CN91C4S96QueueAttach(&queueB);
+    CHECK(CN91C4S96PostNum(&queueA, CN91C4S96_FIELD_MAIN, -125, 2));
+    CHECK(CN91C4S96PostIcon(&queueB, ICON_SN, true));
+    CHECK(CN91C4S96DisplayProcess());
+    CHECK_FRAME(Buffer, expected);
+}
+
+static int jobRuns = 0;
+
+static int8_t jobRun(void *ctx)
+{
+    (void)ctx;
+    jobRuns++;
+    return 0;
+}
+
+static void testBus(void)
+{
+    static CN91C4S96BusJob_st jobA;
+    static CN91C4S96BusJob_st jobB;
+
+    jobA.priority = 200;
+    jobA.run = jobRun;
+    jobB.priority = 10;
+    jobB.run = jobRun;
+    testInit();
+    CN91C4S96BusAttach(&jobA);
+    CN91C4S96BusAttach(&jobB);
+    CN91C4S96Init(CN91C4S96BusHal(&testHal, 4, 100));
+    CN91C4S96BusRequest(&jobA);
+    CN91C4S96BusRequest(&jobB);
+    CHECK(CN91C4S96BusService() == 2);
+    CHECK(jobRuns == 2);
+    CHECK(CN91C4S96BusService() == 0);
+}
+
+static void testDecim(void)
+{
+    static CN91C4S96Decim_st decim;
+    uint8_t expected[DATA_SIZE];
+
+    testInit();
+    CN91C4S96printFixed(25, 10);
+    memcpy(expected, Buffer, DATA_SIZE);
+
+    testInit();
+    CN91C4S96DecimInit(&decim, 100, 10, false);
+    CN91C4S96DecimUpdate(&decim, 0);
+    CN91C4S96DecimPush(&decim, 20);
+    CN91C4S96DecimPush(&decim, 30);
+    CHECK(CN91C4S96DecimUpdate(&decim, 100));
+    CHECK_FRAME(Buffer, expected);
+    CN91C4S96DecimPush(&decim, 40);
+    CHECK(CN91C4S96DecimUpdate(&decim, 200));
+}
+
+int main(void)
+{
+    testRtos();
+    testBus();
+    testDecim();
+    return testDone("include");
+}
@@ -0,0 +1,126 @@
+/*******************************************************************************
+Host test of src/CN91C4S96layer.c
+
+Build:  cc -Itools/fuzz -Itools -Isrc -o layer_test tools/test/layer_test.c tools/CN91C4S96emu.c \
+            src/CN91C4S96layer.c src/CN91C4S96.c src/CN91C4S96ctrl.c
+*******************************************************************************/
+
+#include "test.h"
+#include "CN91C4S96layer.h"
+
+static uint8_t base[DATA_SIZE];
+static uint8_t status[DATA_SIZE];
+static uint8_t alarm[DATA_SIZE];
+static uint8_t statusOwn[DATA_SIZE];
+static uint8_t alarmOwn[DATA_SIZE];
+
+// draw into a layer and keep a copy of its frame
+static void snapshot(CN91C4S96_Layer_en layer, uint8_t *copy)
+{
+    CN91C4S96LayerSelect(layer);
+    memcpy(copy, Buffer, DATA_SIZE);
+    CN91C4S96LayerSelect(CN91C4S96_LAYER_BASE);
+}
+
+static void over(uint8_t *frame, const uint8_t *layer, const uint8_t *own)
+{
+    for (uint8_t i = 0; i < DATA_SIZE; i++)
+    {
+        frame[i] = (frame[i] & ~own[i]) | (layer[i] & own[i]);
+    }
+}
+
+// write the frame and check the glass shows base with the given layers over it
+static void expect(bool statusShown, bool alarmShown, int line)
+{
+    uint8_t expected[DATA_SIZE];
+    uint8_t frame[DATA_SIZE];
+
+    memcpy(base, Buffer, DATA_SIZE);
+    memcpy(expected, base, DATA_SIZE);
+    if (statusShown)
+        over(expected, status, statusOwn);
+    if (alarmShown)
+        over(expected, alarm, alarmOwn);
+    CN91C4S96DispWrite();
+    testVisible(frame);
+    testCheck(memcmp(frame, expected, DATA_SIZE) == 0, "glass shows composed layers", __FILE__, line);
+}
+
+int main(void)
+{
+    const CN91C4S96_Seg_st *warn = &CN91C4S96Layout.icons[ICON_WARN];
+    const CN91C4S96_Seg_st *pov = &CN91C4S96Layout.icons[ICON_POV];
+
+    testInit();
+    CN91C4S96printNum(12345, 2);
+    CN91C4S96DispPOV(true);
+    expect(false, false, __LINE__);
+
+    // status owns POV and keeps it off over the base page
+    CN91C4S96LayerOwnIcon(CN91C4S96_LAYER_STATUS, ICON_POV);
+    statusOwn[pov->pos] |= pov->seg;
+    CN91C4S96LayerSelect(CN91C4S96_LAYER_STATUS);
+    CN91C4S96DispPOV(false);
+    CN91C4S96LayerSelect(CN91C4S96_LAYER_BASE);
+    snapshot(CN91C4S96_LAYER_STATUS, status);
+    expect(false, false, __LINE__);
+    CN91C4S96LayerShow(CN91C4S96_LAYER_STATUS, true);
+    expect(true, false, __LINE__);
+
+    // alarm owns the digit row and WARN, other bits drawn into it are not shown
+    CN91C4S96LayerOwnDigits(CN91C4S96_LAYER_ALARM);
+    CN91C4S96LayerOwnIcon(CN91C4S96_LAYER_ALARM, ICON_WARN);
+    for (uint8_t i = 0; i < DISPLAY_SIZE; i++)
+    {
+        alarmOwn[CN91C4S96Layout.digitFGE[i]] |= 0x70;
+        alarmOwn[CN91C4S96Layout.digitABCD[i]] |= 0x0f;
+    }
+    for (uint8_t p = 1; p <= CN91C4S96_LAYOUT_DOTS; p++)
+    {
+        alarmOwn[CN91C4S96Layout.dot[p].pos] |= CN91C4S96Layout.dot[p].seg;
+    }
+    alarmOwn[CN91C4S96Layout.minus.pos] |= CN91C4S96Layout.minus.seg;
+    alarmOwn[warn->pos] |= warn->seg;
+    CN91C4S96LayerSelect(CN91C4S96_LAYER_ALARM);
+    CN91C4S96printStr("ALARM");
+    CN91C4S96DispWarn(true);
+    CN91C4S96DispFrost(true);
+    CN91C4S96LayerSelect(CN91C4S96_LAYER_BASE);
+    snapshot(CN91C4S96_LAYER_ALARM, alarm);
+    CN91C4S96LayerShow(CN91C4S96_LAYER_ALARM, true);
+    expect(true, true, __LINE__);
+
+    // base changes under the alarm don't reach the bus
+    testReset();
+    CN91C4S96printNum(-777, 0);
+    expect(true, true, __LINE__);
+    CHECK(testBytes == 0);
+    CN91C4S96DispWarn(false);
+    CN91C4S96DispSN(true);
+    testReset();
+    expect(true, true, __LINE__);
+    CHECK(testTransfers == 1);
+
+    // hidden layer keeps its content
+    CN91C4S96LayerShow(CN91C4S96_LAYER_ALARM, false);
+    expect(true, false, __LINE__);
+    CN91C4S96LayerShow(CN91C4S96_LAYER_ALARM, true);
+    expect(true, true, __LINE__);
+
+    // released layer owns nothing
+    CN91C4S96LayerRelease(CN91C4S96_LAYER_ALARM);
+    memset(alarmOwn, 0, sizeof(alarmOwn));
+    expect(true, true, __LINE__);
+    CN91C4S96LayerRelease(CN91C4S96_LAYER_STATUS);
+    memset(statusOwn, 0, sizeof(statusOwn));
+    expect(true, true, __LINE__);
+
+    // invalid layers are ignored, selecting one falls back to the base page
+    CN91C4S96LayerShow(CN91C4S96_LAYER_COUNT, true);
+    CN91C4S96LayerOwn(CN91C4S96_LAYER_BASE, 0, 0xff);
+    CN91C4S96LayerSelect(CN91C4S96_LAYER_COUNT);
+    CN91C4S96printNum(5, 0);
+    expect(false, false, __LINE__);
+    return testDone("layer");
+}
@@ -0,0 +1,200 @@
+/*******************************************************************************
+Host test of src/CN91C4S96mirror.c
+
+Build:  cc -Itools/fuzz -Itools -Isrc -o mirror_test tools/test/mirror_test.c tools/CN91C4S96emu.c \
+            src/CN91C4S96mirror.c src/CN91C4S96history.c src/CN91C4S96.c src/CN91C4S96ctrl.c
+*******************************************************************************/
+
+#include "test.h"
+#include "CN91C4S96mirror.h"
+#include "CN91C4S96history.h"
+
+// receiver, the same rules as tools/mirror_main.c
+static uint8_t rxFrame[DATA_SIZE];
+static bool rxSynced = false;
+static uint8_t rxSeq = 0;
+static unsigned rxMsgs = 0;
+static size_t rxLen = 0;
+static uint8_t rxHeader = 0;
+static bool dropNext = false;
+
+static void emit(const uint8_t *msg, size_t len)
+{
+    if (dropNext)
+    {
+        dropNext = false;
+        return;
+    }
+    rxMsgs++;
+    rxLen = len;
+    rxHeader = msg[0];
+
+    uint8_t seq = msg[0] & MIRROR_SEQ;
+    bool gap = seq != ((rxSeq + 1) & MIRROR_SEQ);
+    rxSeq = seq;
+    if (msg[0] & MIRROR_KEY)
+    {
+        CHECK(len == 1 + DATA_SIZE);
+        memcpy(rxFrame, msg + 1, DATA_SIZE);
+        rxSynced = true;
+        return;
+    }
+    if (gap)
+        rxSynced = false;
+    if (!rxSynced)
+        return;
+    if (msg[0] & MIRROR_MASK)
+    {
+        uint16_t mask = msg[1] | (msg[2] << 8);
+        size_t i = 3;
+        for (uint8_t n = 0; n < DATA_SIZE; n++)
+        {
+            if (mask & (1 << n))
+                rxFrame[n] = msg[i++];
+        }
+        CHECK(i == len);
+    }
+    else
+    {
+        CHECK(len % 2 == 1);
+        for (size_t i = 1; i + 1 < len; i += 2)
+        {
+            CHECK(msg[i] < DATA_SIZE);
+            rxFrame[msg[i]] = msg[i + 1];
+        }
+    }
+}
+
+// change the first count bytes of the frame and write it
+static void writeChanged(uint8_t count)
+{
+    for (uint8_t i = 0; i < count; i++)
+        Buffer[i] ^= 0x01;
+    CN91C4S96DispWrite();
+}
+
+static void testForms(void)
+{
+    testInit();
+    CN91C4S96MirrorStart(emit, 0);
+    CN91C4S96DispWrite();
+    CHECK(rxMsgs == 1 && (rxHeader & MIRROR_KEY) && rxSynced);
+    CHECK_FRAME(rxFrame, Buffer);
+
+    // unchanged frame is not sent
+    CN91C4S96DispWrite();
+    CHECK(rxMsgs == 1);
+
+    // pairs are shorter up to 2 changed bytes
+    writeChanged(1);
+    CHECK(rxLen == 3 && !(rxHeader & (MIRROR_KEY | MIRROR_MASK)));
+    CHECK_FRAME(rxFrame, Buffer);
+    writeChanged(2);
+    CHECK(rxLen == 5 && !(rxHeader & (MIRROR_KEY | MIRROR_MASK)));
+    CHECK_FRAME(rxFrame, Buffer);
+
+    writeChanged(3);
+    CHECK(rxLen == 6 && (rxHeader & MIRROR_MASK) && !(rxHeader & MIRROR_KEY));
+    CHECK_FRAME(rxFrame, Buffer);
+    writeChanged(13);
+    CHECK(rxLen == 16 && (rxHeader & MIRROR_MASK));
+    CHECK_FRAME(rxFrame, Buffer);
+
+    // delta which isn't shorter than keyframe
+    writeChanged(14);
+    CHECK(rxLen == 1 + DATA_SIZE && (rxHeader & MIRROR_KEY));
+    CHECK_FRAME(rxFrame, Buffer);
+    CN91C4S96MirrorStop();
+}
+
+static void testResync(void)
+{
+    testInit();
+    rxMsgs = 0;
+    CN91C4S96MirrorStart(emit, 4);
+    CN91C4S96DispWrite();
+    for (int i = 0; i < 4; i++)
+    {
+        CN91C4S96printNum(i, 0);
+        CN91C4S96DispWrite();
+        CHECK(!(rxHeader & MIRROR_KEY));
+        CHECK_FRAME(rxFrame, Buffer);
+    }
+    // keyEvery deltas sent, the next one is a keyframe
+    writeChanged(1);
+    CHECK(rxHeader & MIRROR_KEY);
+
+    // lost message, the receiver waits for a keyframe
+    dropNext = true;
+    writeChanged(1);
+    writeChanged(1);
+    CHECK(!rxSynced);
+    CN91C4S96MirrorKeyframe();
+    CHECK((rxHeader & MIRROR_KEY) && rxSynced);
+    CHECK_FRAME(rxFrame, Buffer);
+    writeChanged(1);
+    CHECK(rxSynced);
+    CHECK_FRAME(rxFrame, Buffer);
+
+    // the sequence number wraps
+    for (int i = 0; i < 2 * (MIRROR_SEQ + 1); i++)
+    {
+        writeChanged(2);
+        CHECK(rxSynced);
+    }
+    CHECK_FRAME(rxFrame, Buffer);
+
+    CN91C4S96MirrorStop();
+    unsigned msgs = rxMsgs;
+    writeChanged(1);
+    CN91C4S96MirrorKeyframe();
+    CHECK(rxMsgs == msgs);
+}
+
+// stop and start again under history started later
+static void testChain(void)
+{
+    static uint8_t ring[64];
+
+    testInit();
+    rxSeq = MIRROR_SEQ;
+    rxMsgs = 0;
+    CN91C4S96MirrorStart(emit, 0);
+    CN91C4S96HistoryStart(ring, sizeof(ring));
+    CN91C4S96printNum(1, 0);
+    CN91C4S96DispWrite();
+    CHECK(rxMsgs == 1 && CN91C4S96HistoryCount() == 1);
+
+    CN91C4S96MirrorStop();
+    CN91C4S96printNum(2, 0);
+    CN91C4S96DispWrite();
+    CHECK(rxMsgs == 1 && CN91C4S96HistoryCount() == 2);
+
+    rxSeq = MIRROR_SEQ;
+    CN91C4S96MirrorStart(emit, 0);
+    CN91C4S96printNum(3, 0);
+    CN91C4S96DispWrite();
+    CHECK(rxMsgs == 2 && (rxHeader & MIRROR_KEY) && CN91C4S96HistoryCount() == 3);
+    CHECK_FRAME(rxFrame, Buffer);
+    CN91C4S96MirrorStart(emit, 0);
+    CN91C4S96printNum(4, 0);
+    CN91C4S96DispWrite();
+    CHECK(rxMsgs == 3 && CN91C4S96HistoryCount() == 4);
+
+    CN91C4S96HistoryStop();
+    CN91C4S96printNum(5, 0);
+    CN91C4S96DispWrite();
+    CHECK(rxMsgs == 4 && CN91C4S96HistoryCount() == 4);
+    CHECK_FRAME(rxFrame, Buffer);
+    CN91C4S96MirrorStop();
+}
+
+int main(void)
+{
+    rxSeq = MIRROR_SEQ; // the first message has sequence 0
+    testForms();
+    rxSeq = MIRROR_SEQ;
+    testResync();
+    testChain();
+    return testDone("mirror");
+}
@@ -0,0 +1,144 @@
+/*******************************************************************************
+Host test of src/CN91C4S96power.c
+
+Build:  cc -Itools/fuzz -Itools -Isrc -o power_test tools/test/power_test.c tools/CN91C4S96emu.c \
+            src/CN91C4S96power.c src/CN91C4S96.c src/CN91C4S96ctrl.c
+*******************************************************************************/
+
+#include "test.h"
+#include "CN91C4S96power.h"
+
+static const uint8_t dark[DATA_SIZE] = {0};
+
+// glass shows Buffer
+static bool shown(void)
+{
+    uint8_t frame[DATA_SIZE];
+    testVisible(frame);
+    return memcmp(frame, Buffer, DATA_SIZE) == 0;
+}
+
+static bool isDark(void)
+{
+    uint8_t frame[DATA_SIZE];
+    testVisible(frame);
+    return memcmp(frame, dark, DATA_SIZE) == 0;
+}
+
+static void testStages(void)
+{
+    const CN91C4S96PowerCfg_st cfg = {10, 20, 30};
+
+    testInit();
+    CN91C4S96printNum(1234, 0);
+    CN91C4S96DispWrite();
+    CN91C4S96PowerInit(&cfg, 0);
+    CHECK(shown() && !CN91C4S96EmuGlobal.ulp);
+
+    CHECK(CN91C4S96PowerTick(9) == CN91C4S96_POWER_ACTIVE);
+    CHECK(CN91C4S96PowerTick(10) == CN91C4S96_POWER_DIM);
+    CHECK(shown() && CN91C4S96EmuGlobal.ulp);
+    CHECK(CN91C4S96PowerTick(20) == CN91C4S96_POWER_OFF);
+    CHECK(isDark() && CN91C4S96EmuGlobal.sysen);
+    CHECK(CN91C4S96PowerTick(30) == CN91C4S96_POWER_SLEEP);
+    CHECK(isDark() && !CN91C4S96EmuGlobal.sysen);
+
+    // a frame written while asleep goes to display RAM and shows up on wake
+    CN91C4S96printNum(5678, 0);
+    CN91C4S96DispWrite();
+    CHECK(isDark());
+
+    // wake sends mode commands only, no display data
+    testReset();
+    CN91C4S96PowerActivity(40);
+    CHECK(CN91C4S96PowerState() == CN91C4S96_POWER_ACTIVE);
+    CHECK(shown() && CN91C4S96EmuGlobal.sysen && !CN91C4S96EmuGlobal.ulp);
+    CHECK(testTransfers == 2 && testBytes == 2);
+
+    // idle time starts again from the activity
+    CHECK(CN91C4S96PowerTick(49) == CN91C4S96_POWER_ACTIVE);
+    CHECK(CN91C4S96PowerTick(70) == CN91C4S96_POWER_SLEEP);
+}
+
+static void testSkippedStages(void)
+{
+    const CN91C4S96PowerCfg_st cfg = {0, 0, 30};
+
+    testInit();
+    CN91C4S96printNum(42, 0);
+    CN91C4S96DispWrite();
+    CN91C4S96PowerInit(&cfg, 100);
+    // no DIM stage: active keeps the low power mode of CTRL_INIT
+    CHECK(shown() && CN91C4S96EmuGlobal.ulp);
+    CHECK(CN91C4S96PowerTick(129) == CN91C4S96_POWER_ACTIVE);
+    CHECK(CN91C4S96PowerTick(130) == CN91C4S96_POWER_SLEEP);
+    CHECK(isDark());
+
+    // only the disable is undone
+    testReset();
+    CN91C4S96PowerActivity(131);
+    CHECK(shown() && CN91C4S96EmuGlobal.ulp);
+    CHECK(testTransfers == 1 && testBytes == 1);
+
+    // activity while active sends nothing
+    testReset();
+    CN91C4S96PowerActivity(132);
+    CHECK(testTransfers == 0);
+}
+
+// dimTicks 0: the controller never leaves the low power mode, also after a config with DIM
+static void testNoDim(void)
+{
+    const CN91C4S96PowerCfg_st dim = {10, 0, 0};
+    const CN91C4S96PowerCfg_st off = {0, 20, 0};
+
+    testInit();
+    CN91C4S96printNum(99, 0);
+    CN91C4S96DispWrite();
+    CN91C4S96PowerInit(&dim, 0);
+    CHECK(!CN91C4S96EmuGlobal.ulp);
+    CN91C4S96PowerInit(&off, 0);
+    CHECK(shown() && CN91C4S96EmuGlobal.ulp);
+    CHECK(CN91C4S96PowerTick(20) == CN91C4S96_POWER_OFF);
+    CHECK(isDark() && CN91C4S96EmuGlobal.ulp);
+    testReset();
+    CN91C4S96PowerActivity(21);
+    CHECK(shown() && CN91C4S96EmuGlobal.ulp && CN91C4S96EmuGlobal.sysen);
+    CHECK(testTransfers == 1);
+}
+
+// policy state kept over MCU standby, the display stays as it was until activity
+static void testResume(void)
+{
+    const CN91C4S96PowerCfg_st cfg = {10, 20, 0};
+
+    testInit();
+    CN91C4S96printNum(7, 0);
+    CN91C4S96DispWrite();
+    CN91C4S96PowerInit(&cfg, 0);
+    CHECK(CN91C4S96PowerTick(25) == CN91C4S96_POWER_OFF);
+    uint8_t saved = CN91C4S96PowerSave();
+
+    // after MCU standby, instead of CN91C4S96PowerInit
+    CN91C4S96PowerResume(&cfg, 1000, saved);
+    CHECK(CN91C4S96PowerState() == CN91C4S96_POWER_OFF);
+    testReset();
+    CHECK(CN91C4S96PowerTick(1005) == CN91C4S96_POWER_OFF);
+    CHECK(testTransfers == 0);
+
+    CN91C4S96PowerActivity(1006);
+    CHECK(shown() && !CN91C4S96EmuGlobal.ulp);
+
+    // saved value out of range starts active
+    CN91C4S96PowerResume(&cfg, 0, 0x0f);
+    CHECK(CN91C4S96PowerState() == CN91C4S96_POWER_ACTIVE);
+}
+
+int main(void)
+{
+    testStages();
+    testSkippedStages();
+    testNoDim();
+    testResume();
+    return testDone("power");
+}
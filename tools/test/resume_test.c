@@ -0,0 +1,146 @@
+/*******************************************************************************
+Host test of CN91C4S96Save and CN91C4S96Resume, src/CN91C4S96.c
+
+Build:  cc -Itools/fuzz -Itools -Isrc -o resume_test tools/test/resume_test.c tools/CN91C4S96emu.c \
+            src/CN91C4S96.c src/CN91C4S96ctrl.c
+*******************************************************************************/
+
+#include "test.h"
+
+#define CHANGE_BYTES_MAX 4 // commands and the two frame bytes of one digit
+
+extern uint8_t BufferSendOld[];
+
+static uint8_t block[CN91C4S96_RETAIN_SIZE];
+
+// MCU standby: RAM of the driver is lost, the controller keeps its RAM and mode
+static void standby(void)
+{
+    AllClear();
+    memset(BufferSendOld + SYS_SIZE, 0, DATA_SIZE);
+}
+
+static void testSynced(void)
+{
+    uint8_t frame[DATA_SIZE];
+    uint8_t visible[DATA_SIZE];
+
+    testInit();
+    CN91C4S96printFixed(-2718, 1000);
+    CN91C4S96DispSN(true);
+    CN91C4S96DispWrite();
+    memcpy(frame, Buffer, DATA_SIZE);
+    CHECK(CN91C4S96Save(block, DATA_SIZE + 1) == 0);
+    size_t size = CN91C4S96Save(block, sizeof(block));
+    CHECK(size == DATA_SIZE + 2);
+
+    standby();
+    testReset();
+    CHECK(CN91C4S96Resume(&testHal, block, size));
+    CHECK(testTransfers == 0);
+    CHECK_FRAME(Buffer, frame);
+    // display RAM already holds the frame
+    CN91C4S96DispWrite();
+    CHECK(testTransfers == 0);
+    CN91C4S96DispSN(false);
+    CN91C4S96DispWrite();
+    CHECK(testTransfers == 1 && testBytes <= CHANGE_BYTES_MAX);
+    testVisible(visible);
+    CHECK_FRAME(visible, Buffer);
+}
+
+// frame printed but not written before standby
+static void testShadow(void)
+{
+    uint8_t frame[DATA_SIZE];
+    uint8_t visible[DATA_SIZE];
+
+    testInit();
+    CN91C4S96printNum(1234, 0);
+    CN91C4S96DispWrite();
+    CN91C4S96printNum(1235, 0);
+    memcpy(frame, Buffer, DATA_SIZE);
+    size_t size = CN91C4S96Save(block, sizeof(block));
+    CHECK(size == 2 * DATA_SIZE + 2);
+
+    standby();
+    testReset();
+    CHECK(CN91C4S96Resume(&testHal, block, size));
+    CHECK(testTransfers == 0);
+    CHECK_FRAME(Buffer, frame);
+    CN91C4S96DispWrite();
+    CHECK(testTransfers == 1 && testBytes <= CHANGE_BYTES_MAX);
+    testVisible(visible);
+    CHECK_FRAME(visible, frame);
+}
+
+#if CN91C4S96_USE_CLOCK
+static void testClock(void)
+{
+    uint8_t next[DATA_SIZE];
+    uint8_t visible[DATA_SIZE];
+
+    testInit();
+    CN91C4S96printTime(12, 34, 57);
+    memcpy(next, Buffer, DATA_SIZE);
+
+    testInit();
+    CN91C4S96printTime(12, 34, 56);
+    CN91C4S96DispWrite();
+    size_t size = CN91C4S96Save(block, sizeof(block));
+    CHECK(size > DATA_SIZE + 2 && size <= CN91C4S96_RETAIN_SIZE);
+
+    standby();
+    CHECK(CN91C4S96Resume(&testHal, block, size));
+    testReset();
+    CN91C4S96ClockTick();
+    CHECK_FRAME(Buffer, next);
+    CN91C4S96DispWrite();
+    CHECK(testTransfers == 1 && testBytes <= CHANGE_BYTES_MAX);
+    testVisible(visible);
+    CHECK_FRAME(visible, next);
+}
+#endif
+
+// a bad block starts the driver as CN91C4S96Init does
+static void testInvalid(void)
+{
+    uint8_t visible[DATA_SIZE];
+
+    testInit();
+    CN91C4S96printNum(77, 0);
+    CN91C4S96DispWrite();
+    size_t size = CN91C4S96Save(block, sizeof(block));
+
+    for (size_t i = 0; i < size; i++)
+    {
+        block[i] ^= 0x10;
+        standby();
+        CN91C4S96EmuReset(&CN91C4S96EmuGlobal);
+        testReset();
+        CHECK(!CN91C4S96Resume(&testHal, block, size));
+        CHECK(testTransfers > 0 && CN91C4S96EmuGlobal.sysen);
+        block[i] ^= 0x10;
+    }
+    standby();
+    CHECK(!CN91C4S96Resume(&testHal, block, size - 1));
+    CHECK(!CN91C4S96Resume(&testHal, block, 0));
+
+    // display RAM is unknown then, the whole frame is written
+    CN91C4S96printNum(77, 0);
+    CN91C4S96DispWrite();
+    CHECK(testBytes > DATA_SIZE);
+    testVisible(visible);
+    CHECK_FRAME(visible, Buffer);
+}
+
+int main(void)
+{
+    testSynced();
+    testShadow();
+#if CN91C4S96_USE_CLOCK
+    testClock();
+#endif
+    testInvalid();
+    return testDone("resume");
+}
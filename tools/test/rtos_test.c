@@ -0,0 +1,116 @@
+/*******************************************************************************
+Host test of src/CN91C4S96rtos.c
+
+Build:  cc -pthread -Itools/fuzz -Itools -Isrc -o rtos_test tools/test/rtos_test.c tools/CN91C4S96emu.c \
+            src/CN91C4S96rtos.c src/CN91C4S96.c src/CN91C4S96ctrl.c
+*******************************************************************************/
+
+#include "test.h"
+#include "CN91C4S96rtos.h"
+#include <pthread.h>
+
+#define PRODUCER_POSTS 200000
+#define QUEUE_SIZE 4
+
+static CN91C4S96Msg_st itemsA[QUEUE_SIZE];
+static CN91C4S96Msg_st itemsB[64];
+static CN91C4S96Queue_st queueA;
+static CN91C4S96Queue_st queueB;
+static unsigned notified = 0;
+static atomic_bool producerDone;
+
+static void notify(void)
+{
+    notified++;
+}
+
+static void *producer(void *arg)
+{
+    (void)arg;
+    for (int32_t i = 1; i <= PRODUCER_POSTS;)
+    {
+        if (CN91C4S96PostNum(&queueB, CN91C4S96_FIELD_MAIN, i, 0))
+            i++;
+    }
+    atomic_store(&producerDone, true);
+    return NULL;
+}
+
+// the frame the same updates give when the driver is called directly
+static void direct(uint8_t *frame)
+{
+    CN91C4S96printFixed(12345, 1000);
+    CN91C4S96DispSN(true);
+    CN91C4S96batteryLevel(50);
+    CN91C4S96SignalLevel(100);
+    Buffer[0] = (Buffer[0] & ~0x0f) | 0x01;
+    memcpy(frame, Buffer, DATA_SIZE);
+}
+
+static void testMerge(void)
+{
+    uint8_t expected[DATA_SIZE];
+    uint8_t frame[DATA_SIZE];
+
+    testInit();
+    direct(expected);
+
+    testInit();
+    CN91C4S96QueueInit(&queueA, itemsA, QUEUE_SIZE);
+    CN91C4S96QueueInit(&queueB, itemsB, sizeof(itemsB) / sizeof(itemsB[0]));
+    CN91C4S96QueueAttach(&queueA);
+    CN91C4S96QueueAttach(&queueB);
+    CN91C4S96RtosNotify(notify);
+    CHECK(!CN91C4S96DisplayProcess());
+    CHECK(testTransfers == 0);
+
+    // a queue holds size - 1 messages, the next post is dropped
+    CHECK(CN91C4S96PostNum(&queueA, CN91C4S96_FIELD_MAIN, 1, 0));
+    CHECK(CN91C4S96PostNum(&queueA, CN91C4S96_FIELD_MAIN, 12345, 3));
+    CHECK(CN91C4S96PostIcon(&queueA, ICON_SN, true));
+    CHECK(!CN91C4S96PostBattery(&queueA, 50));
+    CHECK(notified == 3);
+    CHECK(CN91C4S96PostBattery(&queueB, 50));
+    CHECK(CN91C4S96PostSignal(&queueB, 100));
+    CHECK(CN91C4S96PostMask(&queueB, 0, 0x0f, 0x01));
+
+    // all queues in one pass, one write, only the last number is rendered
+    CHECK(CN91C4S96DisplayProcess());
+    CHECK(testTransfers == 1);
+    CHECK_FRAME(Buffer, expected);
+    testVisible(frame);
+    CHECK_FRAME(frame, expected);
+
+    // the slots are free again
+    CHECK(CN91C4S96PostBattery(&queueA, 50));
+    CHECK(CN91C4S96PostBattery(&queueA, 50));
+    CHECK(CN91C4S96PostBattery(&queueA, 50));
+    CHECK(CN91C4S96DisplayProcess());
+    CN91C4S96RtosNotify(NULL);
+}
+
+// a producer thread posts while the display task drains, the last value wins
+static void testThreads(void)
+{
+    uint8_t expected[DATA_SIZE];
+    pthread_t thread;
+
+    CN91C4S96printNum(PRODUCER_POSTS, 0);
+    memcpy(expected, Buffer, DATA_SIZE);
+    CN91C4S96printNum(0, 0);
+
+    atomic_init(&producerDone, false);
+    CHECK(pthread_create(&thread, NULL, producer, NULL) == 0);
+    while (!atomic_load(&producerDone))
+        CN91C4S96DisplayProcess();
+    pthread_join(thread, NULL);
+    CN91C4S96DisplayProcess();
+    CHECK_FRAME(Buffer, expected);
+}
+
+int main(void)
+{
+    testMerge();
+    testThreads();
+    return testDone("rtos");
+}
@@ -0,0 +1,153 @@
+/*******************************************************************************
+Host test of src/CN91C4S96selftest.c
+
+Build:  cc -Itools/fuzz -Itools -Isrc -o selftest_test tools/test/selftest_test.c tools/CN91C4S96emu.c \
+            src/CN91C4S96selftest.c src/CN91C4S96.c src/CN91C4S96ctrl.c
+*******************************************************************************/
+
+#include "test.h"
+#include "CN91C4S96selftest.h"
+
+#define BITS_PER_BYTE 8
+#define MAX_NUM CN91C4S96_LAYOUT_MAX_NUM
+#define STEP_BYTES_MAX 2     // display RAM bytes written by one walk step
+#define TRANSFER_BYTES_MAX 3 // commands and data of a one byte write
+
+// bit count of frame
+static unsigned bits(const uint8_t *frame)
+{
+    unsigned count = 0;
+    for (uint8_t i = 0; i < DATA_SIZE; i++)
+    {
+        for (uint8_t b = frame[i]; b; b &= b - 1)
+            count++;
+    }
+    return count;
+}
+
+// every segment of the glass: all digits as 8, dots, minus and icons
+static void glassSegments(uint8_t *mask)
+{
+    CN91C4S96printNum(MAX_NUM / 9 * 8, 0);
+    memcpy(mask, Buffer, DATA_SIZE);
+    for (uint8_t i = 1; i <= CN91C4S96_LAYOUT_DOTS; i++)
+    {
+        mask[CN91C4S96Layout.dot[i].pos] |= CN91C4S96Layout.dot[i].seg;
+    }
+    mask[CN91C4S96Layout.minus.pos] |= CN91C4S96Layout.minus.seg;
+    for (uint8_t i = 0; i < ICON_COUNT; i++)
+    {
+        mask[CN91C4S96Layout.icons[i].pos] |= CN91C4S96Layout.icons[i].seg;
+    }
+}
+
+static void userFrame(uint8_t *frame)
+{
+    CN91C4S96printFixed(-1234, 100);
+    CN91C4S96DispSN(true);
+    CN91C4S96DispWrite();
+    memcpy(frame, Buffer, DATA_SIZE);
+}
+
+// walk to the end, every step shows one segment of mask alone, in bit order
+static unsigned walk(const uint8_t *mask, const uint8_t *user)
+{
+    uint8_t visible[DATA_SIZE];
+    uint8_t walked[DATA_SIZE] = {0};
+    int16_t last = -1;
+    unsigned steps = 0;
+
+    testReset();
+    CHECK(CN91C4S96SelfTestStep() == CN91C4S96_TEST_ALL_OFF);
+    testVisible(visible);
+    CHECK(bits(visible) == 0);
+    // display RAM isn't touched by all on and all off
+    CHECK_FRAME(CN91C4S96EmuGlobal.dram, user);
+    CHECK(testBytes < 4);
+
+    while (1)
+    {
+        testReset();
+        if (CN91C4S96SelfTestStep() != CN91C4S96_TEST_WALK)
+            break;
+        steps++;
+        int16_t segment = CN91C4S96SelfTestSegment();
+        uint8_t pos = segment / BITS_PER_BYTE;
+        uint8_t seg = 0x80 >> (segment % BITS_PER_BYTE);
+        testVisible(visible);
+        CHECK(segment > last);
+        CHECK(bits(visible) == 1 && (visible[pos] & seg));
+        CHECK(mask[pos] & seg);
+        walked[pos] |= seg;
+        last = segment;
+        // the segment before off, this one on. The first step clears the user frame
+        if (steps > 1)
+            CHECK(testTransfers <= STEP_BYTES_MAX && testBytes <= STEP_BYTES_MAX * TRANSFER_BYTES_MAX);
+    }
+    CHECK_FRAME(walked, mask);
+    return steps;
+}
+
+static void testWalk(void)
+{
+    uint8_t user[DATA_SIZE];
+    uint8_t mask[DATA_SIZE];
+    uint8_t visible[DATA_SIZE];
+
+    testInit();
+    glassSegments(mask);
+    userFrame(user);
+    CN91C4S96SelfTestStart(NULL);
+    testVisible(visible);
+    CHECK(bits(visible) == DATA_SIZE * BITS_PER_BYTE);
+    CHECK(CN91C4S96SelfTestSegment() == -1);
+    CHECK(walk(mask, user) == bits(mask));
+
+    // user frame is back, a print made during the test is shown by the next DispWrite
+    CHECK(CN91C4S96SelfTestStep() == CN91C4S96_TEST_IDLE);
+    CHECK(CN91C4S96SelfTestSegment() == -1);
+    testVisible(visible);
+    CHECK_FRAME(visible, user);
+    CN91C4S96printNum(42, 0);
+    CN91C4S96DispWrite();
+    testVisible(visible);
+    CHECK_FRAME(visible, Buffer);
+}
+
+static void testMaskStop(void)
+{
+    uint8_t user[DATA_SIZE];
+    uint8_t mask[DATA_SIZE] = {0};
+    uint8_t visible[DATA_SIZE];
+
+    testInit();
+    userFrame(user);
+    mask[0] = 0x81;
+    mask[DATA_SIZE - 1] = 0x10;
+    CN91C4S96SelfTestStart(mask);
+    CHECK(walk(mask, user) == 3);
+    testVisible(visible);
+    CHECK_FRAME(visible, user);
+
+    // stop in the walk and in all-on
+    CN91C4S96SelfTestStart(mask);
+    CN91C4S96SelfTestStep();
+    CN91C4S96SelfTestStep();
+    CHECK(CN91C4S96SelfTestSegment() == 0);
+    CN91C4S96SelfTestStop();
+    testVisible(visible);
+    CHECK_FRAME(visible, user);
+    CHECK(CN91C4S96EmuGlobal.pix == EMU_PIX_DATA);
+    CN91C4S96SelfTestStart(mask);
+    CN91C4S96SelfTestStop();
+    testVisible(visible);
+    CHECK_FRAME(visible, user);
+    CHECK(CN91C4S96SelfTestStep() == CN91C4S96_TEST_IDLE);
+}
+
+int main(void)
+{
+    testWalk();
+    testMaskStop();
+    return testDone("selftest");
+}
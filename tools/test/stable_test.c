@@ -0,0 +1,106 @@
+/*******************************************************************************
+Host test of src/CN91C4S96stable.c
+
+Build:  cc -Itools/fuzz -Itools -Isrc -o stable_test tools/test/stable_test.c tools/CN91C4S96emu.c \
+            src/CN91C4S96stable.c src/CN91C4S96.c src/CN91C4S96ctrl.c
+*******************************************************************************/
+
+#include "test.h"
+#include "CN91C4S96stable.h"
+
+static const uint8_t thresholds[] = {25, 50, 75};
+
+static void testDeadband(void)
+{
+    CN91C4S96Deadband_st db;
+    int32_t shown = -1;
+
+    CN91C4S96DeadbandInit(&db, 5, 10, 50);
+    CHECK(CN91C4S96DeadbandUpdate(&db, 100, 0, &shown) && shown == 100);
+    // small change waits for settleTicks, counted from its first appearance
+    CHECK(!CN91C4S96DeadbandUpdate(&db, 103, 20, &shown));
+    CHECK(!CN91C4S96DeadbandUpdate(&db, 104, 60, &shown));
+    CHECK(CN91C4S96DeadbandUpdate(&db, 104, 70, &shown) && shown == 104);
+    // large change waits for holdTicks only
+    CHECK(!CN91C4S96DeadbandUpdate(&db, 200, 75, &shown));
+    CHECK(CN91C4S96DeadbandUpdate(&db, 200, 80, &shown) && shown == 200);
+    // going back to the shown value drops the pending small change
+    CHECK(!CN91C4S96DeadbandUpdate(&db, 199, 100, &shown));
+    CHECK(!CN91C4S96DeadbandUpdate(&db, 200, 120, &shown));
+    CHECK(!CN91C4S96DeadbandUpdate(&db, 199, 160, &shown));
+    CHECK(shown == 200);
+
+    // settleTicks 0: small changes are never shown, deadband works over the int32_t range
+    CN91C4S96DeadbandInit(&db, 5, 0, 0);
+    CHECK(CN91C4S96DeadbandUpdate(&db, INT32_MAX, 0, &shown));
+    CHECK(!CN91C4S96DeadbandUpdate(&db, INT32_MAX - 5, 1000, &shown));
+    CHECK(CN91C4S96DeadbandUpdate(&db, INT32_MIN, 1001, &shown) && shown == INT32_MIN);
+}
+
+static void testHyst(void)
+{
+    CN91C4S96Hyst_st hyst;
+    uint8_t level = 0xff;
+
+    CN91C4S96HystInit(&hyst, thresholds, sizeof(thresholds), 5, 0);
+    CHECK(CN91C4S96HystUpdate(&hyst, 0, 0, &level) && level == 0);
+    CHECK(CN91C4S96HystUpdate(&hyst, 26, 1, &level) && level == 1);
+    // inside the band below 25 the level stays
+    CHECK(!CN91C4S96HystUpdate(&hyst, 25, 2, &level));
+    CHECK(!CN91C4S96HystUpdate(&hyst, 21, 3, &level));
+    CHECK(CN91C4S96HystUpdate(&hyst, 20, 4, &level) && level == 0);
+    CHECK(CN91C4S96HystUpdate(&hyst, 255, 5, &level) && level == 3);
+    CHECK(CN91C4S96HystUpdate(&hyst, 0, 6, &level) && level == 0);
+
+    // hold time between level changes
+    CN91C4S96HystInit(&hyst, thresholds, sizeof(thresholds), 5, 100);
+    CHECK(CN91C4S96HystUpdate(&hyst, 60, 0, &level) && level == 2);
+    CHECK(!CN91C4S96HystUpdate(&hyst, 80, 50, &level));
+    CHECK(CN91C4S96HystUpdate(&hyst, 80, 100, &level) && level == 3);
+}
+
+// the stable setters draw the same bars as the plain ones and leave Buffer alone on jitter
+static void testSetters(void)
+{
+    uint8_t expected[DATA_SIZE];
+    uint8_t before[DATA_SIZE];
+    CN91C4S96Deadband_st db;
+
+    testInit();
+    CN91C4S96StableConfig(5, 0);
+    CN91C4S96SignalLevel(31);
+    CN91C4S96batteryLevel(80);
+    CN91C4S96printFixed(1234, 100);
+    memcpy(expected, Buffer, DATA_SIZE);
+
+    AllClear();
+    CHECK(CN91C4S96SignalLevelStable(31, 0));
+    CHECK(CN91C4S96batteryLevelStable(80, 0));
+    CN91C4S96DeadbandInit(&db, 2, 0, 0);
+    CHECK(CN91C4S96printFixedStable(&db, 1234, 100, 0));
+    CHECK_FRAME(Buffer, expected);
+
+    memcpy(before, Buffer, DATA_SIZE);
+    for (uint32_t t = 1; t < 20; t++)
+    {
+        CHECK(!CN91C4S96SignalLevelStable((t & 1) ? 29 : 31, t));
+        CHECK(!CN91C4S96batteryLevelStable((t & 1) ? 74 : 78, t));
+        CHECK(!CN91C4S96printFixedStable(&db, 1234 + (int32_t)(t % 3) - 1, 100, t));
+    }
+    CHECK_FRAME(Buffer, before);
+
+    // no Buffer change, no bytes on the bus
+    CN91C4S96DispWrite();
+    testReset();
+    CN91C4S96SignalLevelStable(30, 30);
+    CN91C4S96DispWrite();
+    CHECK(testBytes == 0);
+}
+
+int main(void)
+{
+    testDeadband();
+    testHyst();
+    testSetters();
+    return testDone("stable");
+}
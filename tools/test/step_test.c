@@ -0,0 +1,142 @@
+/*******************************************************************************
+Host test of src/CN91C4S96step.c
+
+Build:  cc -Itools/fuzz -Itools -Isrc -o step_test tools/test/step_test.c tools/CN91C4S96emu.c \
+            src/CN91C4S96step.c src/CN91C4S96.c src/CN91C4S96ctrl.c
+*******************************************************************************/
+
+#include "test.h"
+#include "CN91C4S96step.h"
+
+#define BUSY_POLLS 3 // polls a transfer takes
+
+static int busyLeft = 0;
+static unsigned writesWhileBusy = 0;
+static unsigned waits = 0;
+
+static int8_t busWrite(uint8_t address, const uint8_t *data, uint16_t size)
+{
+    if (busyLeft)
+        writesWhileBusy++;
+    busyLeft = BUSY_POLLS;
+    return testWriteI2C(address, data, size);
+}
+
+static void busWait(void)
+{
+    waits++;
+}
+
+static bool busBusy(void)
+{
+    if (!busyLeft)
+        return false;
+    busyLeft--;
+    return true;
+}
+
+static CN91C4S96_HAL_st busHal = {testInitI2C, busWrite, busWait};
+
+static unsigned drain(void)
+{
+    unsigned polls = 0;
+    while (CN91C4S96StepPoll() != CN91C4S96_STEP_IDLE)
+        polls++;
+    return polls;
+}
+
+// display RAM holds Buffer
+static bool inRam(void)
+{
+    return memcmp(CN91C4S96EmuGlobal.dram, Buffer, DATA_SIZE) == 0;
+}
+
+static void testQueue(void)
+{
+    CN91C4S96EmuReset(&CN91C4S96EmuGlobal);
+    AllClear();
+    CN91C4S96Init(CN91C4S96StepHal(&busHal, busBusy));
+    // queued only, the bus is untouched until polled
+    CHECK(CN91C4S96EmuGlobal.writes == 0 && CN91C4S96StepPending());
+    drain();
+    CHECK(CN91C4S96EmuGlobal.sysen && !CN91C4S96StepPending());
+
+    CN91C4S96printNum(123, 1);
+    CN91C4S96DispWrite();
+    CN91C4S96displayOff();
+    CN91C4S96displayData();
+    CHECK(CN91C4S96EmuGlobal.writes == 1);
+    // one transfer per poll after the bus is free
+    CHECK(drain() == 3 * (BUSY_POLLS + 1));
+    CHECK(inRam() && CN91C4S96EmuGlobal.pix == EMU_PIX_DATA);
+}
+
+// frames which don't fit are sent again in full, the last one is shown
+static void testFrameOverflow(void)
+{
+    for (int32_t i = 1; i <= 10; i++)
+    {
+        CN91C4S96printNum(i * 11111111, 0);
+        CN91C4S96DispWrite();
+    }
+    drain();
+    CHECK(inRam());
+    CHECK(CN91C4S96StepDropped() == 0);
+}
+
+// commands don't get lost behind frames: the reserve takes them, then the retry buffer
+static void testCommandsUnderLoad(void)
+{
+    for (int32_t i = 1; i <= 10; i++)
+    {
+        CN91C4S96printNum(-i * 1111111, 0);
+        CN91C4S96DispWrite();
+    }
+    CN91C4S96displayOff();
+    CN91C4S96displayOn();
+    CN91C4S96displayOff();
+    CN91C4S96printNum(42, 0);
+    CN91C4S96DispWrite();
+    drain();
+    CHECK(CN91C4S96EmuGlobal.pix == EMU_PIX_OFF);
+    CHECK(inRam());
+    CHECK(CN91C4S96StepDropped() == 0);
+
+    // retry buffer keeps the order of the commands
+    for (int i = 0; i < 20; i++)
+    {
+        CN91C4S96printNum(i * 1234567, 0);
+        CN91C4S96DispWrite();
+    }
+    for (int i = 0; i < 4; i++)
+    {
+        CN91C4S96displayOn();
+        CN91C4S96displayData();
+    }
+    drain();
+    CHECK(CN91C4S96EmuGlobal.pix == EMU_PIX_DATA);
+    CHECK(inRam());
+    CHECK(CN91C4S96StepDropped() == 0);
+}
+
+// queue and retry buffer both full, dropped commands are counted
+static void testDropped(void)
+{
+    for (int i = 0; i < 64; i++)
+    {
+        CN91C4S96displayOff();
+    }
+    CHECK(CN91C4S96StepDropped() > 0);
+    drain();
+    CHECK(!CN91C4S96StepPending());
+}
+
+int main(void)
+{
+    testQueue();
+    testFrameOverflow();
+    testCommandsUnderLoad();
+    testDropped();
+    CHECK(writesWhileBusy == 0 && waits == 0);
+    return testDone("step");
+}
@@ -0,0 +1,84 @@
+/*******************************************************************************
+Helpers of the host tests of the CN91C4S96 modules.
+
+Every test is a program of its own, built with the stubs of tools/fuzz, the
+controller model of tools/CN91C4S96emu.c and the driver sources it needs (see
+Build in its header). Failed checks are printed, the exit code is 1 if any.
+The display is the global emulator, so a test can check what the glass shows.
+*******************************************************************************/
+
+#ifndef CN91C4S96TEST_H_
+#define CN91C4S96TEST_H_
+
+#include "CN91C4S96.h"
+#include "CN91C4S96emu.h"
+#include <stdio.h>
+#include <string.h>
+
+#define CHECK(EXPR) testCheck((EXPR), #EXPR, __FILE__, __LINE__)
+#define CHECK_FRAME(A, B) CHECK(memcmp((A), (B), DATA_SIZE) == 0)
+
+extern uint8_t *Buffer;
+// clear Buffer and clock state, see CN91C4S96.c
+void AllClear();
+
+static unsigned testChecks = 0;
+static unsigned testFailed = 0;
+static uint32_t testTransfers = 0; // WriteI2C calls since the last testReset
+static uint32_t testBytes = 0;     // bytes of them
+
+static inline void testCheck(bool ok, const char *expr, const char *file, int line)
+{
+    testChecks++;
+    if (ok)
+        return;
+    testFailed++;
+    printf("%s:%d: check failed: %s\n", file, line, expr);
+}
+
+static inline void testInitI2C(void)
+{
+}
+
+static inline int8_t testWriteI2C(uint8_t address, const uint8_t *data, uint16_t size)
+{
+    testTransfers++;
+    testBytes += size;
+    return CN91C4S96EmuWriteI2C(address, data, size);
+}
+
+static inline void testWaitI2C(void)
+{
+}
+
+static CN91C4S96_HAL_st testHal = {testInitI2C, testWriteI2C, testWaitI2C};
+
+// start counting transfers again
+static inline void testReset(void)
+{
+    testTransfers = 0;
+    testBytes = 0;
+}
+
+// fresh controller and driver with an empty Buffer, display RAM isn't written yet
+static inline void testInit(void)
+{
+    CN91C4S96EmuReset(&CN91C4S96EmuGlobal);
+    AllClear();
+    CN91C4S96Init(&testHal);
+    testReset();
+}
+
+// segments the glass shows now
+static inline void testVisible(uint8_t *frame)
+{
+    CN91C4S96EmuVisible(&CN91C4S96EmuGlobal, frame);
+}
+
+static inline int testDone(const char *name)
+{
+    printf("%s: %u checks, %u failed\n", name, testChecks, testFailed);
+    return testFailed ? 1 : 0;
+}
+
+#endif
@@ -0,0 +1,99 @@
+/*******************************************************************************
+Test of the constant messages of CN91C4S96printText.
+
+Messages encoded by the compiler from CN91C4S96text.hpp and by tools/textgen.py
+into src/CN91C4S96text_messages.h must show the same frame as printStr of their
+text: cyrillic in both cases, ё, unknown characters and broken UTF-8.
+Built as C++14 (constexpr) and C++20 (consteval).
+
+Build:  cc -Itools/fuzz -Itools -Isrc -c tools/CN91C4S96emu.c src/CN91C4S96.c src/CN91C4S96ctrl.c
+        c++ -std=c++14 -Itools/fuzz -Itools -Isrc -o text_test tools/test/text_test.cpp \
+            CN91C4S96emu.o CN91C4S96.o CN91C4S96ctrl.o
+        c++ -std=c++20 -Itools/fuzz -Itools -Isrc -o text_test20 tools/test/text_test.cpp \
+            CN91C4S96emu.o CN91C4S96.o CN91C4S96ctrl.o
+*******************************************************************************/
+
+extern "C"
+{
+#include "test.h"
+#include "CN91C4S96text_messages.h"
+}
+#include "CN91C4S96text.hpp"
+
+using namespace cn91c4s96::literals;
+
+struct Message
+{
+    const char *str;
+    CN91C4S96Text_st text;
+};
+
+// "\xd0" "A": a hex escape would take the A too
+static constexpr Message literals[] = {
+    {"", ""_cn91},
+    {"ERR 05", "ERR 05"_cn91},
+    {"-_ 7", "-_ 7"_cn91},
+    {"CLOSED", "CLOSED"_cn91},
+    {"closed", "closed"_cn91},
+    {"ОШИБКА", "ОШИБКА"_cn91},
+    {"ошибка", "ошибка"_cn91},
+    {"Ёж ёж", "Ёж ёж"_cn91},
+    {"ЖЯ жя", "ЖЯ жя"_cn91},
+    {"A€B", "A€B"_cn91},
+    {"\xff" "A", "\xff" "A"_cn91},
+    {"\x80" "A", "\x80" "A"_cn91},
+    {"A\xd0", "A\xd0"_cn91},
+    {"\xd0" "A", "\xd0" "A"_cn91},
+    {"\xe2\x82" "A", "\xe2\x82" "A"_cn91},
+    {"123456789", "123456789"_cn91},
+};
+
+static constexpr Message generated[] = {
+    {"ERR 05", CN91C4S96_TEXT_ERR05},
+    {"CLOSED", CN91C4S96_TEXT_CLOSED},
+    {"OPEN", CN91C4S96_TEXT_OPEN},
+    {"LEAK", CN91C4S96_TEXT_LEAK},
+    {"SN   ", CN91C4S96_TEXT_SN},
+    {"donE", CN91C4S96_TEXT_DONE},
+    {"ОШИБКА", CN91C4S96_TEXT_ERROR_RU},
+};
+
+// printText of the message shows what printStr of its text shows
+static void checkMessage(const Message &msg)
+{
+    uint8_t expected[DATA_SIZE];
+
+    testInit();
+    CN91C4S96printStr(msg.str);
+    memcpy(expected, Buffer, DATA_SIZE);
+
+    testInit();
+    CN91C4S96printText(&msg.text);
+    if (memcmp(Buffer, expected, DATA_SIZE) != 0)
+        printf("message \"%s\" differs from printStr\n", msg.str);
+    CHECK_FRAME(Buffer, expected);
+}
+
+static void testLiterals(void)
+{
+    for (const Message &msg : literals)
+        checkMessage(msg);
+    // unknown and broken characters are blanks, not dropped
+    static constexpr CN91C4S96Text_st blank = "A B"_cn91;
+    CHECK(memcmp(literals[9].text.frame, blank.frame, DATA_SIZE) == 0);
+}
+
+static void testGenerated(void)
+{
+    for (const Message &msg : generated)
+        checkMessage(msg);
+    CHECK(memcmp(generated[0].text.frame, literals[1].text.frame, DATA_SIZE) == 0);
+    CHECK(memcmp(generated[6].text.frame, literals[5].text.frame, DATA_SIZE) == 0);
+}
+
+int main(void)
+{
+    testLiterals();
+    testGenerated();
+    return testDone("text");
+}
@@ -0,0 +1,191 @@
+/*******************************************************************************
+Host test of src/CN91C4S96trace.c and of the replay in tools/trace_main.c
+
+Build:  cc -Itools/fuzz -Itools -Isrc -o trace_test tools/test/trace_test.c tools/CN91C4S96emu.c \
+            src/CN91C4S96trace.c src/CN91C4S96.c src/CN91C4S96ctrl.c
+
+The test includes tools/trace_main.c with its main renamed, runs it on the
+recorded trace and checks the counts it prints.
+*******************************************************************************/
+
+#define main cn91traceMain
+#include "../trace_main.c"
+#undef main
+
+#include "test.h"
+#include <unistd.h>
+
+#define TICK_HZ 1000
+
+// see CN91C4S96.c
+void commitAttach(void (*hook)(const uint8_t *frame));
+void commitDetach(void (*hook)(const uint8_t *frame));
+
+static uint8_t trace[4096];
+static uint32_t tick = 0;
+static unsigned hookCalls = 0;
+
+static uint32_t getTick(void)
+{
+    return tick += 3;
+}
+
+static void hook(const uint8_t *frame)
+{
+    (void)frame;
+    hookCalls++;
+}
+
+typedef struct
+{
+    uint32_t transfers;
+    uint32_t commands;
+    uint32_t bytes;
+    uint32_t frames;     // frame marks
+    uint32_t frameBytes; // bytes of data transfers before the last mark
+} Counts_st;
+
+// walk the records, replay them into emu
+static bool scan(const uint8_t *p, size_t len, Counts_st *counts, CN91C4S96Emu_st *emu)
+{
+    uint32_t pendingBytes = 0;
+    size_t pos = TRACE_HEADER_SIZE;
+    int err = 0;
+
+    memset(counts, 0, sizeof(*counts));
+    while (pos < len)
+    {
+        rdVarint(p, len, &pos, &err);
+        uint8_t address = p[pos++];
+        uint32_t size = rdVarint(p, len, &pos, &err);
+        if (err || pos + size > len)
+            return false;
+        if (address == TRACE_FRAME_MARK)
+        {
+            if (size)
+                return false;
+            counts->frames++;
+            counts->frameBytes += pendingBytes;
+            pendingBytes = 0;
+            continue;
+        }
+        counts->transfers++;
+        counts->bytes += size;
+        if (isCommand(p + pos, size))
+            counts->commands++;
+        else
+            pendingBytes += size;
+        CN91C4S96EmuWrite(emu, address, p + pos, (uint16_t)size);
+        pos += size;
+    }
+    return pendingBytes == 0;
+}
+
+// output of cn91trace for the trace
+static bool replay(const uint8_t *p, size_t len, char *out, size_t outSize)
+{
+    char path[] = "/tmp/cn91traceXXXXXX";
+    char *argv[] = {"cn91trace", path, NULL};
+    int fd = mkstemp(path);
+    if (fd < 0 || write(fd, p, len) != (ssize_t)len)
+        return false;
+
+    FILE *capture = tmpfile();
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    dup2(fileno(capture), STDOUT_FILENO);
+    int status = cn91traceMain(2, argv);
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+    close(fd);
+    unlink(path);
+
+    rewind(capture);
+    size_t n = fread(out, 1, outSize - 1, capture);
+    out[n] = 0;
+    fclose(capture);
+    return status == 0;
+}
+
+static void testRecord(void)
+{
+    uint8_t visible[DATA_SIZE];
+    uint8_t replayed[DATA_SIZE];
+    CN91C4S96Emu_st emu;
+    Counts_st counts;
+
+    CN91C4S96EmuReset(&CN91C4S96EmuGlobal);
+    AllClear();
+    testReset();
+    CN91C4S96Init(CN91C4S96TraceStart(&testHal, trace, sizeof(trace), getTick, TICK_HZ));
+    CHECK(memcmp(trace, "CNT", 3) == 0 && trace[3] == TRACE_VERSION);
+    CN91C4S96printNum(1, 0);
+    CN91C4S96DispWrite();
+    CN91C4S96printNum(-22, 1);
+    CN91C4S96DispWrite();
+    // nothing changed, still a frame write
+    CN91C4S96DispWrite();
+    CN91C4S96DispRefresh();
+    CN91C4S96displayOff();
+    CN91C4S96displayData();
+
+    size_t size = CN91C4S96TraceSize();
+    CHECK(CN91C4S96TraceDropped() == 0);
+    CN91C4S96EmuReset(&emu);
+    CHECK(scan(trace, size, &counts, &emu));
+    CHECK(counts.frames == 4);
+    CHECK(counts.transfers == testTransfers && counts.bytes == testBytes);
+    CHECK(counts.commands >= 2);
+    CN91C4S96EmuVisible(&emu, replayed);
+    testVisible(visible);
+    CHECK_FRAME(replayed, visible);
+    CHECK_FRAME(replayed, Buffer);
+
+    char out[2048];
+    char expected[256];
+    CHECK(replay(trace, size, out, sizeof(out)));
+    snprintf(expected, sizeof(expected), "transfers %u, bytes %u, span", counts.transfers, counts.bytes);
+    CHECK(strstr(out, expected) != NULL);
+    snprintf(expected, sizeof(expected), "frames %u, %.1f bytes per frame, commands %u\n", counts.frames,
+             (double)counts.frameBytes / counts.frames, counts.commands);
+    CHECK(strstr(out, expected) != NULL);
+    CHECK(strstr(out, "not counted") == NULL);
+    CN91C4S96TraceStop();
+}
+
+// stop with another hook attached later, then start again
+static void testStop(void)
+{
+    Counts_st counts;
+    CN91C4S96Emu_st emu;
+
+    CN91C4S96EmuReset(&CN91C4S96EmuGlobal);
+    AllClear();
+    CN91C4S96Init(CN91C4S96TraceStart(&testHal, trace, sizeof(trace), getTick, TICK_HZ));
+    commitAttach(hook);
+    CN91C4S96printNum(3, 0);
+    CN91C4S96DispWrite();
+    CN91C4S96TraceStop();
+    size_t size = CN91C4S96TraceSize();
+    CN91C4S96printNum(4, 0);
+    CN91C4S96DispWrite();
+    CHECK(CN91C4S96TraceSize() == size && hookCalls == 2);
+
+    CN91C4S96TraceStart(&testHal, trace, sizeof(trace), getTick, TICK_HZ);
+    CN91C4S96printNum(5, 0);
+    CN91C4S96DispWrite();
+    CHECK(hookCalls == 3);
+    CN91C4S96EmuReset(&emu);
+    CHECK(scan(trace, CN91C4S96TraceSize(), &counts, &emu));
+    CHECK(counts.frames == 1 && counts.commands == 0);
+    CN91C4S96TraceStop();
+    commitDetach(hook);
+}
+
+int main(void)
+{
+    testRecord();
+    testStop();
+    return testDone("trace");
+}
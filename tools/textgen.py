@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+"""Encode constant messages into a header of CN91C4S96printText messages.
+
+usage: textgen.py [-l layout_map] [-g glyph_map] messages_map header_file
+
+Map format is described in extras/messages.map. Every message becomes a
+CN91C4S96Text_st initializer: the frame bits of its digits, looked up in the
+glyph map (default extras/glyphs.map) and placed by the layout map (default
+extras/pdc6x1.map), the same as CN91C4S96printStr does it on the target.
+Use the maps of the driver build; the header refuses another layout.
+"""
+
+import json
+import os
+import re
+import sys
+
+import glyphgen
+import layoutgen
+
+EXTRAS = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "extras")
+GLYPHS_H = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "src", "CN91C4S96glyphs.h")
+
+
+def folding():
+    """case folding constants of the driver, CN91C4S96_CYRILLIC_* of src/CN91C4S96glyphs.h"""
+    with open(GLYPHS_H, encoding="utf-8") as f:
+        text = f.read()
+    return {m.group(1): int(m.group(2), 0)
+            for m in re.finditer(r"#define CN91C4S96_CYRILLIC_(\w+) (0x[0-9a-fA-F]+|\d+)", text)}
+
+
+FOLD = folding()
+
+
+class MapError(Exception):
+    pass
+
+
+def parse(path):
+    messages = []
+    names = set()
+    with open(path, encoding="utf-8") as f:
+        for lineno, line in enumerate(f, 1):
+            line = line.rstrip("\r\n")
+            if not line.strip() or line.lstrip().startswith("#"):
+                continue
+            parts = line.strip().split(None, 1)
+            text = parts[1] if len(parts) > 1 else ""
+            if len(text) >= 2 and text[0] == '"' and text[-1] == '"':
+                text = text[1:-1]
+            if not re.match(r"^[A-Za-z_]\w*$", parts[0]):
+                raise MapError("%s:%d: name is not an identifier: %s" % (path, lineno, parts[0]))
+            if parts[0] in names:
+                raise MapError("%s:%d: %s twice" % (path, lineno, parts[0]))
+            names.add(parts[0])
+            messages.append((parts[0], text, lineno))
+    return messages
+
+
+def glyph_of(glyphs, cp):
+    # lowercase cyrillic is folded by the driver, see glyphLookup in src/CN91C4S96.c
+    if 0 <= cp - FOLD["LOWER_FIRST"] < FOLD["CASE_COUNT"]:
+        cp -= FOLD["CASE_COUNT"]
+    elif cp == FOLD["YO_LOWER"]:
+        cp -= FOLD["YO_DELTA"]
+    return glyphs.get(cp)
+
+
+def encode(layout, glyphs, name, text, where):
+    digits = [layout["digits"][n] for n in range(len(layout["digits"]))]
+    if len(text) > len(digits):
+        raise MapError("%s: %s has %d characters, glass has %d digits" % (where, name, len(text), len(digits)))
+    frame = [0] * layoutgen.DATA_SIZE
+    for (fge, abcd), ch in zip(digits, text):
+        glyph = glyph_of(glyphs, ord(ch))
+        if glyph is None:
+            if ch != " ":
+                sys.stderr.write("warning: %s: %s: no glyph for %r, shown as blank\n" % (where, name, ch))
+            glyph = 0
+        # shift 4 for changing data format from library to the display, D segment is at the same bit
+        frame[fge] |= layoutgen.DIGIT_FGE & (glyph << 4)
+        frame[abcd] |= layoutgen.DIGIT_ABCD & ((glyph >> 4) | (glyph & 0x08))
+    return frame
+
+
+def header(layout, glyphs, paths, messages, header_path):
+    guard = re.sub(r"\W", "_", os.path.basename(header_path)).upper() + "_"
+    maps = ", ".join(os.path.basename(p) for p in paths)
+
+    out = []
+    out.append("/*******************************************************************************")
+    out.append("Messages of CN91C4S96printText for the %s layout, see CN91C4S96.h" % layout["name"])
+    out.append("")
+    out.append("Generated by tools/textgen.py from %s, don't edit." % maps)
+    out.append("*******************************************************************************/")
+    out.append("")
+    out.append("#ifndef %s" % guard)
+    out.append("#define %s" % guard)
+    out.append("")
+    out.append('#include "CN91C4S96.h"')
+    out.append("")
+    out.append("#ifndef CN91C4S96LAYOUT_%s_H_" % layout["name"].upper())
+    out.append('#error "messages are made for the %s layout, run tools/textgen.py with the map of the glass"' % layout["name"])
+    out.append("#endif")
+    for name, text, lineno in messages:
+        frame = encode(layout, glyphs, name, text, "%s:%d" % (os.path.basename(paths[0]), lineno))
+        out.append("")
+        out.append("// %s" % json.dumps(text, ensure_ascii=False))
+        out.append("#define CN91C4S96_TEXT_%s {{%s}}" % (name, ", ".join("0x%02x" % b for b in frame)))
+    out.append("")
+    out.append("#endif")
+    return "\n".join(out) + "\n"
+
+
+def main(argv):
+    layout_map = os.path.join(EXTRAS, "pdc6x1.map")
+    glyph_map = os.path.join(EXTRAS, "glyphs.map")
+    args = argv[1:]
+    while len(args) > 2 and args[0] in ("-l", "-g"):
+        if args[0] == "-l":
+            layout_map = args[1]
+        else:
+            glyph_map = args[1]
+        args = args[2:]
+    if len(args) != 2:
+        sys.stderr.write(__doc__)
+        return 2
+    try:
+        layout = layoutgen.parse(layout_map, layoutgen.known_icons())
+        glyphs = glyphgen.parse(glyph_map)
+        messages = parse(args[0])
+        text = header(layout, glyphs, [args[0], glyph_map, layout_map], messages, args[1])
+    except (MapError, layoutgen.MapError, glyphgen.MapError, OSError) as e:
+        sys.stderr.write("textgen: %s\n" % e)
+        return 1
+    with open(args[1], "w", encoding="utf-8") as f:
+        f.write(text)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
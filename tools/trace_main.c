@@ -0,0 +1,242 @@
+/*******************************************************************************
+cn91trace - replay I2C trace recorded by src/CN91C4S96trace.c.
+
+Build:  cc -O2 -Isrc -o cn91trace tools/trace_main.c tools/CN91C4S96emu.c
+
+Prints bus time at 100 kHz, 400 kHz and 1 MHz per frame and the estimated
+bus energy per day. A frame is all data transfers of one frame write of the
+driver (DispWrite, DispRefresh, ...), delimited by the frame marks of the
+recorder. Transfers without data bytes (init, mode and power commands) are
+counted apart. Version 1 traces have no marks, every data transfer is taken
+as a frame there.
+
+Options:
+    -l          list every transfer and frame
+    -e          render display after every transfer (see cn91emu)
+    -s SECONDS  refresh schedule: one average recorded frame every SECONDS,
+                commands are not repeated. Without it the recorded time span,
+                commands included, is scaled to one day
+    -V VOLTS    supply voltage, default 3.0
+    -I MA       average current drawn while the bus is busy (pull-ups and
+                interface), default 0.5 mA
+*******************************************************************************/
+
+#include "CN91C4S96trace.h"
+#include "CN91C4S96emu.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SPEEDS 3
+#define SECONDS_PER_DAY 86400.0
+#define I2C_BITS_PER_BYTE 9 // 8 data bits and ACK
+#define I2C_BITS_FRAMING 2  // START and STOP conditions
+#define CMD_CONTINUE 0x80   // command byte flag: another command byte follows
+
+static const double speeds[SPEEDS] = {100e3, 400e3, 1e6};
+
+static uint32_t rdVarint(const uint8_t *p, size_t len, size_t *pos, int *err)
+{
+    uint32_t v = 0;
+    for (int shift = 0; shift < 7 * TRACE_VARINT_MAX; shift += 7)
+    {
+        if (*pos >= len)
+            break;
+        uint8_t b = p[(*pos)++];
+        v |= (uint32_t)(b & 0x7f) << shift;
+        if (!(b & 0x80))
+            return v;
+    }
+    *err = 1;
+    return 0;
+}
+
+// time of one write transfer: address byte plus data bytes
+static double busTime(uint32_t size, double hz)
+{
+    return (I2C_BITS_FRAMING + I2C_BITS_PER_BYTE * (size + 1.0)) / hz;
+}
+
+// transfer is command bytes only, nothing follows the last command byte
+static bool isCommand(const uint8_t *data, uint32_t size)
+{
+    uint32_t i = 0;
+    while (i < size && (data[i] & CMD_CONTINUE))
+        i++;
+    return i + 1 >= size;
+}
+
+int main(int argc, char **argv)
+{
+    bool list = false;
+    bool render = false;
+    double schedule = 0;
+    double volts = 3.0;
+    double amps = 0.5e-3;
+    const char *path = NULL;
+
+    for (int a = 1; a < argc; a++)
+    {
+        if (!strcmp(argv[a], "-l"))
+            list = true;
+        else if (!strcmp(argv[a], "-e"))
+            render = true;
+        else if (!strcmp(argv[a], "-s") && a + 1 < argc)
+            schedule = atof(argv[++a]);
+        else if (!strcmp(argv[a], "-V") && a + 1 < argc)
+            volts = atof(argv[++a]);
+        else if (!strcmp(argv[a], "-I") && a + 1 < argc)
+            amps = atof(argv[++a]) * 1e-3;
+        else
+            path = argv[a];
+    }
+    if (!path)
+    {
+        fprintf(stderr, "usage: %s [-l] [-e] [-s seconds] [-V volts] [-I mA] trace.bin\n", argv[0]);
+        return 2;
+    }
+
+    FILE *f = fopen(path, "rb");
+    if (!f)
+    {
+        perror(path);
+        return 1;
+    }
+    fseek(f, 0, SEEK_END);
+    long fileLen = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *p = malloc(fileLen > 0 ? fileLen : 1);
+    size_t len = fread(p, 1, fileLen, f);
+    fclose(f);
+
+    if (len < TRACE_HEADER_SIZE || p[0] != TRACE_MAGIC0 || p[1] != TRACE_MAGIC1 || p[2] != TRACE_MAGIC2 ||
+        p[3] < 1 || p[3] > TRACE_VERSION)
+    {
+        fprintf(stderr, "%s: not a trace of version 1..%d\n", path, TRACE_VERSION);
+        return 1;
+    }
+    bool marks = p[3] >= 2;
+    uint32_t tickHz = p[4] | (p[5] << 8) | (p[6] << 16) | ((uint32_t)p[7] << 24);
+    if (tickHz == 0)
+        tickHz = 1;
+
+    CN91C4S96Emu_st emu;
+    CN91C4S96EmuReset(&emu);
+
+    double frameBusy[SPEEDS] = {0};   // finished frames
+    double pendingBusy[SPEEDS] = {0}; // data transfers since the last mark
+    double cmdBusy[SPEEDS] = {0};
+    double ticks = 0;
+    uint32_t transfers = 0;
+    uint32_t commands = 0;
+    uint32_t frames = 0;
+    uint32_t pending = 0;
+    uint32_t bytes = 0;
+    uint32_t frameBytes = 0;
+    uint32_t pendingBytes = 0;
+    size_t pos = TRACE_HEADER_SIZE;
+    int err = 0;
+
+    if (list)
+        printf("%6s %12s %4s %5s %10s %10s %10s\n", "#", "time, s", "addr", "size", "100k, us", "400k, us", "1M, us");
+    while (pos < len)
+    {
+        uint32_t dt = rdVarint(p, len, &pos, &err);
+        if (pos >= len)
+            err = 1;
+        uint8_t address = err ? 0 : p[pos++];
+        uint32_t size = rdVarint(p, len, &pos, &err);
+        if (err || pos + size > len)
+        {
+            fprintf(stderr, "%s: truncated record at offset %zu\n", path, pos);
+            break;
+        }
+
+        ticks += dt;
+        if (marks && address == TRACE_FRAME_MARK)
+        {
+            frames++;
+            frameBytes += pendingBytes;
+            for (int s = 0; s < SPEEDS; s++)
+            {
+                frameBusy[s] += pendingBusy[s];
+                pendingBusy[s] = 0;
+            }
+            if (list)
+                printf("%6s %12.6f frame %u: %u transfers, %u bytes\n", "--", ticks / tickHz, frames, pending,
+                       pendingBytes);
+            pending = 0;
+            pendingBytes = 0;
+            pos += size;
+            continue;
+        }
+
+        transfers++;
+        bytes += size;
+        if (isCommand(p + pos, size))
+        {
+            commands++;
+            for (int s = 0; s < SPEEDS; s++)
+                cmdBusy[s] += busTime(size, speeds[s]);
+        }
+        else
+        {
+            pending++;
+            pendingBytes += size;
+            for (int s = 0; s < SPEEDS; s++)
+                pendingBusy[s] += busTime(size, speeds[s]);
+            if (!marks)
+            {
+                // no marks to group by, one transfer is one frame
+                frames++;
+                frameBytes += pendingBytes;
+                for (int s = 0; s < SPEEDS; s++)
+                {
+                    frameBusy[s] += pendingBusy[s];
+                    pendingBusy[s] = 0;
+                }
+                pending = 0;
+                pendingBytes = 0;
+            }
+        }
+
+        if (list)
+            printf("%6u %12.6f %4.2x %5u %10.1f %10.1f %10.1f\n", transfers, ticks / tickHz, address, size,
+                   busTime(size, speeds[0]) * 1e6, busTime(size, speeds[1]) * 1e6, busTime(size, speeds[2]) * 1e6);
+        if (render)
+        {
+            char text[1024];
+            uint8_t frame[EMU_DATA_SIZE];
+            CN91C4S96EmuWrite(&emu, address, p + pos, (uint16_t)size);
+            CN91C4S96EmuVisible(&emu, frame);
+            CN91C4S96EmuRenderText(frame, text, sizeof(text));
+            fputs(text, stdout);
+        }
+        pos += size;
+    }
+
+    double span = ticks / tickHz;
+
+    printf("transfers %u, bytes %u, span %.3f s\n", transfers, bytes, span);
+    printf("frames %u, %.1f bytes per frame, commands %u\n", frames, frames ? (double)frameBytes / frames : 0,
+           commands);
+    if (!marks)
+        printf("version 1 trace without frame marks, every data transfer is taken as a frame\n");
+    if (pending)
+        printf("%u data transfers after the last frame mark are not counted\n", pending);
+    if (schedule > 0 && !frames)
+        printf("no frames, the schedule can't be applied\n");
+    for (int s = 0; s < SPEEDS; s++)
+    {
+        double frame = frames ? frameBusy[s] / frames : 0;
+        double day = 0;
+        if (schedule > 0)
+            day = frame * SECONDS_PER_DAY / schedule;
+        else if (span > 0)
+            day = (frameBusy[s] + cmdBusy[s]) * SECONDS_PER_DAY / span;
+        printf("%5.0f kHz: %8.1f us per frame, commands %8.1f us, per day %8.3f s, %10.3f mJ\n", speeds[s] / 1e3,
+               frame * 1e6, cmdBusy[s] * 1e6, day, day * volts * amps * 1e3);
+    }
+    free(p);
+    return 0;
+}
@@ -0,0 +1,8 @@
+/*******************************************************************************
+Replacement of the CubeMX i2c.h for the WCET harness build: bus is a stub
+*******************************************************************************/
+
+#ifndef WCET_I2C_H_
+#define WCET_I2C_H_
+
+#endif
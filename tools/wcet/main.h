@@ -0,0 +1,17 @@
+/*******************************************************************************
+Replacement of the CubeMX main.h for the WCET harness build: no HAL, no asserts
+*******************************************************************************/
+
+#ifndef WCET_MAIN_H_
+#define WCET_MAIN_H_
+
+#include <stddef.h>
+
+#define assert_param(expr) ((void)0U)
+
+#define SET_BIT(REG, BIT) ((REG) |= (BIT))
+#define CLEAR_BIT(REG, BIT) ((REG) &= ~(BIT))
+#define READ_BIT(REG, BIT) ((REG) & (BIT))
+#define MODIFY_REG(REG, CLEARMASK, SETMASK) ((REG) = (((REG) & (~(CLEARMASK))) | (SETMASK)))
+
+#endif
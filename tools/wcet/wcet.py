@@ -0,0 +1,272 @@
+#!/usr/bin/env python3
+"""WCET regression harness for the CN91C4S96 driver.
+
+Builds tools/wcet/wcet_main.c with the driver for Cortex-M, runs it in the
+unicorn Thumb emulator and reports min/max instructions and cycles of every
+measured API against tools/wcet/budgets.txt. Exit code is 1 if a budget is
+exceeded, or if a measured API has no budget ("-" or no line) unless --report
+is given. Budgets are only valid for the compiler and flags which recorded
+them, both are kept in budgets.txt and checked too.
+
+Cycles follow the Cortex-M0+ timing with zero wait state memory: loads and
+stores 2, LDM/STM/PUSH 1+N, POP with PC 3+N, taken branches 2, BL 3,
+MSR/MRS/barriers 3, single-cycle multiplier. Bus transfers are stubs and are
+not counted. --selftest checks the cycle table against encodings of the
+Cortex-M0+ TRM timing table, without the toolchain.
+
+usage: tools/wcet/wcet.py [--cc arm-none-eabi-gcc] [--cflags="..."] [--update] [--margin 10] [--report]
+       tools/wcet/wcet.py --selftest
+
+Needs arm-none-eabi-gcc (with newlib) and `pip install unicorn`.
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+ROOT = os.path.dirname(os.path.dirname(HERE))
+BUDGETS = os.path.join(HERE, 'budgets.txt')
+SOURCES = ['src/CN91C4S96.c', 'src/CN91C4S96ctrl.c', 'tools/wcet/wcet_main.c']
+
+RAM_BASE = 0x20000000
+RAM_SIZE = 256 * 1024
+STEP_LIMIT = 200000000
+
+# Thumb encodings (halfword, second halfword of 32-bit ones, branch taken) and their Cortex-M0+ cycles
+TABLE_CHECK = [
+    ('ldr r0, [r1, #4]', 0x6848, 0, False, 2),
+    ('str r0, [r1]', 0x6008, 0, False, 2),
+    ('ldrb r0, [r1, r2]', 0x5c88, 0, False, 2),
+    ('ldr r0, [sp, #8]', 0x9802, 0, False, 2),
+    ('ldr r0, [pc, #0]', 0x4800, 0, False, 2),
+    ('push {r4, r5, lr}', 0xb530, 0, False, 4),
+    ('pop {r4, r5, pc}', 0xbd30, 0, True, 5),
+    ('pop {r4}', 0xbc10, 0, False, 2),
+    ('ldm r0!, {r1, r2}', 0xc806, 0, False, 3),
+    ('stm r0!, {r1, r2, r3}', 0xc00e, 0, False, 4),
+    ('adds r0, r1, r2', 0x1888, 0, False, 1),
+    ('muls r0, r1, r0', 0x4348, 0, False, 1),
+    ('mov r8, r1', 0x4688, 0, False, 1),
+    ('bx lr', 0x4770, 0, True, 2),
+    ('blx r3', 0x4798, 0, True, 2),
+    ('mov pc, lr', 0x46f7, 0, True, 2),
+    ('add pc, r1', 0x448f, 0, True, 2),
+    ('bl', 0xf000, 0xf800, True, 3),
+    ('b', 0xe000, 0, True, 2),
+    ('beq, taken', 0xd000, 0, True, 2),
+    ('beq, not taken', 0xd000, 0, False, 1),
+    ('dmb sy', 0xf3bf, 0x8f5f, False, 3),
+    ('mrs r0, primask', 0xf3ef, 0x8010, False, 3),
+    ('msr primask, r0', 0xf380, 0x8810, False, 3),
+    ('nop', 0xbf00, 0, False, 1),
+]
+
+
+def build(cc, cflags, out):
+    elf = os.path.join(out, 'wcet.elf')
+    binary = os.path.join(out, 'wcet.bin')
+    prefix = cc[:-len('gcc')] if cc.endswith('gcc') else ''
+    cmd = [cc] + cflags.split() + [
+        '-I' + os.path.join(ROOT, 'tools/wcet'), '-I' + os.path.join(ROOT, 'src'),
+        '-ffunction-sections', '-nostartfiles', '--specs=nano.specs', '--specs=nosys.specs',
+        '-T', os.path.join(HERE, 'wcet.ld'), '-o', elf,
+    ] + [os.path.join(ROOT, s) for s in SOURCES]
+    subprocess.run(cmd, check=True)
+    subprocess.run([prefix + 'objcopy', '-O', 'binary', elf, binary], check=True)
+
+    symbols = {}
+    nm = subprocess.run([prefix + 'nm', elf], check=True, capture_output=True, text=True).stdout
+    for line in nm.splitlines():
+        parts = line.split()
+        if len(parts) == 3:
+            symbols[parts[2]] = int(parts[0], 16)
+    with open(binary, 'rb') as f:
+        return f.read(), symbols
+
+
+def cycles(hw, hw2, taken):
+    """Cortex-M0+ cycles of one Thumb instruction, hw2 is the second halfword of 32-bit ones"""
+    if (hw & 0xf800) in (0xe800, 0xf000, 0xf800):
+        return 3                                     # BL, MSR, MRS, barriers
+    if (hw & 0xf000) == 0xd000 and (hw & 0x0f00) < 0x0e00:
+        return 2 if taken else 1                     # conditional branch
+    if (hw & 0xf800) == 0xe000:
+        return 2                                     # B
+    if (hw & 0xff00) == 0x4700:
+        return 2                                     # BX, BLX
+    if (hw & 0xff00) in (0x4400, 0x4600) and (hw & 0x87) == 0x87:
+        return 2                                     # ADD/MOV to PC
+    if (hw & 0xf800) == 0x4800 or (hw & 0xf000) in (0x5000, 0x6000, 0x7000, 0x8000, 0x9000):
+        return 2                                     # loads and stores
+    if (hw & 0xf000) == 0xc000:
+        return 1 + bin(hw & 0xff).count('1')         # LDM, STM
+    if (hw & 0xfe00) == 0xb400:
+        return 1 + bin(hw & 0x1ff).count('1')        # PUSH
+    if (hw & 0xfe00) == 0xbc00:
+        n = bin(hw & 0xff).count('1')
+        return 3 + n if hw & 0x100 else 1 + n        # POP
+    return 1
+
+
+def run(image, symbols):
+    from unicorn import Uc, UC_ARCH_ARM, UC_MODE_THUMB, UC_MODE_MCLASS, UC_HOOK_CODE
+    from unicorn import arm_const
+
+    uc = Uc(UC_ARCH_ARM, UC_MODE_THUMB | UC_MODE_MCLASS)
+    model = getattr(arm_const, 'UC_CPU_ARM_CORTEX_M0', None)
+    if model is not None and hasattr(uc, 'ctl_set_cpu_model'):
+        uc.ctl_set_cpu_model(model)
+    uc.mem_map(RAM_BASE, RAM_SIZE)
+    uc.mem_write(RAM_BASE, image)
+    uc.reg_write(arm_const.UC_ARM_REG_SP, RAM_BASE + RAM_SIZE)
+
+    begin = symbols['WcetBegin'] & ~1
+    end = symbols['WcetEnd'] & ~1
+    done = symbols['WcetDone'] & ~1
+    state = {'name': None, 'insns': 0, 'cycles': 0, 'prev': None, 'steps': 0}
+    results = {}
+
+    def readName(ptr):
+        raw = uc.mem_read(ptr, 64)
+        return bytes(raw).split(b'\0')[0].decode()
+
+    def hook(uc, address, size, _):
+        prev = state['prev']
+        if prev and state['name'] is not None:
+            paddr, psize, hw, hw2 = prev
+            state['insns'] += 1
+            state['cycles'] += cycles(hw, hw2, address != paddr + psize)
+
+        if address == begin:
+            state['name'] = readName(uc.reg_read(arm_const.UC_ARM_REG_R0))
+            state['insns'] = 0
+            state['cycles'] = 0
+        elif address == end and state['name'] is not None:
+            r = results.setdefault(state['name'], [0, None, None, None, None])
+            r[0] += 1
+            r[1] = state['insns'] if r[1] is None else min(r[1], state['insns'])
+            r[2] = state['insns'] if r[2] is None else max(r[2], state['insns'])
+            r[3] = state['cycles'] if r[3] is None else min(r[3], state['cycles'])
+            r[4] = state['cycles'] if r[4] is None else max(r[4], state['cycles'])
+            state['name'] = None
+        elif address == done:
+            uc.emu_stop()
+
+        code = bytes(uc.mem_read(address, size))
+        hw = code[0] | code[1] << 8
+        hw2 = code[2] | code[3] << 8 if size == 4 else 0
+        state['prev'] = (address, size, hw, hw2)
+        state['steps'] += 1
+        if state['steps'] > STEP_LIMIT:
+            uc.emu_stop()
+
+    uc.hook_add(UC_HOOK_CODE, hook)
+    uc.emu_start(symbols['WcetMain'] | 1, done, count=STEP_LIMIT)
+    if state['steps'] > STEP_LIMIT:
+        sys.exit('wcet: harness did not finish in %d instructions' % STEP_LIMIT)
+    return results
+
+
+def selfTest():
+    failed = 0
+    for text, hw, hw2, taken, expected in TABLE_CHECK:
+        got = cycles(hw, hw2, taken)
+        if got != expected:
+            print('%-24s %d cycles, expected %d' % (text, got, expected))
+            failed += 1
+    print('cycle table: %d encodings, %d wrong' % (len(TABLE_CHECK), failed))
+    return 1 if failed else 0
+
+
+def toolchain(cc):
+    try:
+        out = subprocess.run([cc, '--version'], check=True, capture_output=True, text=True).stdout
+    except OSError as e:
+        sys.exit('wcet: %s: %s' % (cc, e.strerror))
+    return out.splitlines()[0].strip()
+
+
+def readBudgets():
+    """budgets by name and the '# key: value' lines which tell what recorded them"""
+    budgets = {}
+    recorded = {}
+    if os.path.exists(BUDGETS):
+        with open(BUDGETS) as f:
+            for line in f:
+                if line.startswith('# toolchain:') or line.startswith('# cflags:'):
+                    key, value = line[1:].split(':', 1)
+                    recorded[key.strip()] = value.strip()
+                line = line.split('#')[0].split()
+                if len(line) == 2:
+                    budgets[line[0]] = None if line[1] == '-' else int(line[1])
+    return budgets, recorded
+
+
+def writeBudgets(results, margin, compiler, cflags):
+    with open(BUDGETS, 'w') as f:
+        f.write('# max cycles per call, checked by tools/wcet/wcet.py. "-" - not recorded, fails the check\n')
+        f.write('# toolchain: %s\n' % compiler)
+        f.write('# cflags: %s\n' % cflags)
+        for name in sorted(results):
+            f.write('%-24s %d\n' % (name, -(-results[name][4] * (100 + margin) // 100)))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument('--cc', default='arm-none-eabi-gcc')
+    ap.add_argument('--cflags', default='-mcpu=cortex-m0plus -mthumb -O2 -std=gnu11')
+    ap.add_argument('--update', action='store_true', help='write measured max cycles into budgets.txt')
+    ap.add_argument('--margin', type=int, default=10, help='percents added to budgets by --update')
+    ap.add_argument('--report', action='store_true', help='only print, APIs without a budget do not fail')
+    ap.add_argument('--selftest', action='store_true', help='check the cycle table only, no toolchain needed')
+    args = ap.parse_args()
+    if args.selftest:
+        return selfTest()
+
+    compiler = toolchain(args.cc)
+    with tempfile.TemporaryDirectory() as out:
+        image, symbols = build(args.cc, args.cflags, out)
+    results = run(image, symbols)
+
+    overhead = results.pop('overhead', [0, 0, 0, 0, 0])
+    for r in results.values():
+        r[1] -= overhead[1]
+        r[2] -= overhead[1]
+        r[3] -= overhead[3]
+        r[4] -= overhead[3]
+
+    if args.update:
+        writeBudgets(results, args.margin, compiler, args.cflags)
+    budgets, recorded = readBudgets()
+
+    failed = False
+    # cycles depend on the code the compiler made, budgets of another build bound nothing
+    for key, value in (('toolchain', compiler), ('cflags', args.cflags)):
+        if recorded.get(key) != value:
+            print('budgets were recorded with %s "%s", this build is "%s"' % (key, recorded.get(key, '-'), value))
+            failed = failed or not args.report
+    print('%-24s %6s %8s %8s %8s %8s %8s' % ('api', 'calls', 'min ins', 'max ins', 'min cyc', 'max cyc', 'budget'))
+    for name in sorted(results):
+        calls, imin, imax, cmin, cmax = results[name]
+        budget = budgets.get(name)
+        status = ''
+        if budget is None:
+            status = ' NO BUDGET'
+            failed = failed or not args.report
+        elif cmax > budget:
+            status = ' OVER'
+            failed = True
+        print('%-24s %6d %8d %8d %8d %8d %8s%s' % (name, calls, imin, imax, cmin, cmax,
+                                                  '-' if budget is None else budget, status))
+    # a budget of a call which is no longer measured checks nothing
+    for name in sorted(set(budgets) - set(results)):
+        print('%-24s not measured' % name)
+        failed = failed or not args.report
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,195 @@
+/*******************************************************************************
+WCET harness for CN91C4S96 driver. Built for Cortex-M and run by wcet.py in an
+instruction-counting emulator, no hardware needed.
+
+Every measured call is put between WcetBegin(name) and WcetEnd(). The
+emulator counts instructions and cycles between the two and keeps min/max per
+name. The bus is a stub which returns at once, so numbers are CPU time of the
+driver only, bus time is estimated by cn91trace.
+
+Inputs are the edges: 0, sign changes, clamping limits, every precision and
+out-of-range dates and times.
+*******************************************************************************/
+
+#include "CN91C4S96.h"
+#include <stdint.h>
+#include <limits.h>
+
+#define COUNT(A) (sizeof(A) / sizeof((A)[0]))
+#define MEASURE(NAME, CALL) \
+    do                      \
+    {                       \
+        WcetBegin(NAME);    \
+        CALL;               \
+        WcetEnd();          \
+    } while (0)
+
+#define MAX_NUM CN91C4S96_LAYOUT_MAX_NUM
+#define DOTS CN91C4S96_LAYOUT_DOTS
+
+// emulator hooks the entries of these functions
+void __attribute__((noinline)) WcetBegin(const char *name)
+{
+    __asm volatile("" ::"r"(name) : "memory");
+}
+
+void __attribute__((noinline)) WcetEnd(void)
+{
+    __asm volatile("" ::: "memory");
+}
+
+void __attribute__((noinline)) WcetDone(void)
+{
+    for (;;)
+        __asm volatile("" ::: "memory");
+}
+
+static void busInit(void)
+{
+}
+
+static int8_t busWrite(uint8_t address, const uint8_t *data, uint16_t size)
+{
+    __asm volatile("" ::"r"(address), "r"(data), "r"(size) : "memory");
+    return 0;
+}
+
+static void busWait(void)
+{
+}
+
+static CN91C4S96_HAL_st hal = {busInit, busWrite, busWait};
+
+static const int32_t nums[] = {
+    0, 1, -1, 9, -9, 10, 99999, -99999, MAX_NUM, MAX_NUM + 1, -MAX_NUM, -MAX_NUM - 1,
+    MAX_NUM / 10, -(MAX_NUM / 10), INT32_MAX, INT32_MIN + 1, INT32_MIN,
+};
+
+#if CN91C4S96_USE_FLOAT
+static const float floats[] = {
+    0.0f, -0.0f, 1e-6f, -1e-6f, 0.5f, -0.5f, 1.0f, -1.0f, 123.456f, -123.456f,
+    (float)MAX_NUM, -(float)MAX_NUM, 1e10f, -1e10f,
+};
+#endif
+
+static const uint32_t multipliers[] = {0, 1, 10, 100, 1000, 10000, 100000, 1000000, UINT32_MAX};
+
+static const int32_t dateParts[] = {-1, 0, 1, 9, 10, 12, 31, 99, 100, 2025, INT32_MAX};
+static const uint8_t timeParts[] = {0, 9, 10, 23, 24, 59, 60, 99, 100, 255};
+static const uint8_t bcdParts[] = {0x00, 0x09, 0x10, 0x23, 0x59, 0x99, 0x0f, 0xff};
+static const uint8_t percents[] = {0, 1, 25, 26, 50, 51, 75, 76, 100, 255};
+
+#if CN91C4S96_USE_TEXT
+static const char *const strings[] = {
+    "", "0", "-", "8.8.8.8.8.8.8.8.8.", "HELLO", "abcdefghijklmnopqrstuvwxyz", "?\x7f\x80\xff",
+};
+#endif
+
+static void sweepNumbers(void)
+{
+    for (uint8_t n = 0; n < COUNT(nums); n++)
+    {
+        for (int32_t p = -1; p <= DOTS + 1; p++)
+            MEASURE("CN91C4S96printNum", CN91C4S96printNum(nums[n], p));
+        for (uint8_t m = 0; m < COUNT(multipliers); m++)
+            MEASURE("CN91C4S96printFixed", CN91C4S96printFixed(nums[n], multipliers[m]));
+    }
+#if CN91C4S96_USE_FLOAT
+    for (uint8_t n = 0; n < COUNT(floats); n++)
+    {
+        for (uint8_t p = 0; p <= DOTS + 1; p++)
+            MEASURE("CN91C4S96printFloat", CN91C4S96printFloat(floats[n], p));
+        MEASURE("CN91C4S96printFloat", CN91C4S96printFloat(floats[n], UINT8_MAX));
+    }
+#endif
+}
+
+static void sweepClock(void)
+{
+#if CN91C4S96_USE_CLOCK
+    for (uint8_t d = 0; d < COUNT(dateParts); d++)
+    {
+        for (uint8_t m = 0; m < COUNT(dateParts); m++)
+        {
+            MEASURE("CN91C4S96printDate", CN91C4S96printDate(dateParts[d], dateParts[m], dateParts[m]));
+        }
+    }
+    // the clock redraws only changed digits: measure from a full redraw and from one digit changes
+    for (uint8_t h = 0; h < COUNT(timeParts); h++)
+    {
+        for (uint8_t m = 0; m < COUNT(timeParts); m++)
+        {
+            MEASURE("CN91C4S96printTime", CN91C4S96printTime(timeParts[h], timeParts[m], timeParts[m]));
+            CN91C4S96printNum(0, 0);
+        }
+        MEASURE("CN91C4S96printTime", CN91C4S96printTime(timeParts[h], 0, 1));
+    }
+    for (uint8_t a = 0; a < COUNT(bcdParts); a++)
+    {
+        for (uint8_t b = 0; b < COUNT(bcdParts); b++)
+        {
+            MEASURE("CN91C4S96printDateBCD", CN91C4S96printDateBCD(bcdParts[a], bcdParts[b], bcdParts[b]));
+            MEASURE("CN91C4S96printTimeBCD", CN91C4S96printTimeBCD(bcdParts[a], bcdParts[b], bcdParts[b]));
+        }
+    }
+#endif
+}
+
+static void sweepText(void)
+{
+#if CN91C4S96_USE_TEXT
+    for (uint8_t s = 0; s < COUNT(strings); s++)
+        MEASURE("CN91C4S96printStr", CN91C4S96printStr(strings[s]));
+#endif
+}
+
+static void sweepIcons(void)
+{
+    for (uint8_t p = 0; p < COUNT(percents); p++)
+    {
+        MEASURE("CN91C4S96batteryLevel", CN91C4S96batteryLevel(percents[p]));
+        MEASURE("CN91C4S96SignalLevel", CN91C4S96SignalLevel(percents[p]));
+    }
+}
+
+// nothing changed, one byte, scattered bytes, whole frame
+static void writeCases(const char *name, void (*write)(void))
+{
+    extern uint8_t *Buffer;
+
+    MEASURE(name, write());
+    MEASURE(name, write());
+    Buffer[DATA_SIZE / 2] ^= 0xff;
+    MEASURE(name, write());
+    for (uint8_t i = 0; i < DATA_SIZE; i += 4)
+        Buffer[i] ^= 0xff;
+    MEASURE(name, write());
+    for (uint8_t i = 0; i < DATA_SIZE; i++)
+        Buffer[i] ^= 0xff;
+    MEASURE(name, write());
+}
+
+// wrBuffer on its own too, it is the common tail of every display update
+static void sweepWrite(void)
+{
+    extern void wrBuffer(void);
+
+    writeCases("CN91C4S96DispWrite", CN91C4S96DispWrite);
+    writeCases("wrBuffer", wrBuffer);
+    // unknown display RAM
+    MEASURE("CN91C4S96DispRefresh", CN91C4S96DispRefresh());
+}
+
+void __attribute__((section(".text.WcetMain"))) WcetMain(void)
+{
+    // calibration: cost of the marks alone, subtracted by wcet.py
+    MEASURE("overhead", (void)0);
+
+    MEASURE("CN91C4S96Init", CN91C4S96Init(&hal));
+    sweepNumbers();
+    sweepClock();
+    sweepText();
+    sweepIcons();
+    sweepWrite();
+    WcetDone();
+}